@@ -12,6 +12,7 @@ public class PanoramaCapture : ModuleRules
             "CoreUObject",
             "Engine",
             "RenderCore",
+            "Renderer",
             "RHI",
             "Projects",
             "Slate",
@@ -31,6 +32,8 @@ public class PanoramaCapture : ModuleRules
             "TimeManagement"
         });
 
+        AddEngineThirdPartyPrivateStaticDependencies(Target, "zlib");
+
         if (Target.Platform == UnrealTargetPlatform.Win64)
         {
             PrivateDependencyModuleNames.Add("D3D12RHI");
@@ -0,0 +1,104 @@
+#include "CaptureFrameFingerprint.h"
+
+#include "CaptureFrameQueue.h"
+#include "Hash/xxhash.h"
+
+namespace
+{
+    constexpr int32 SamplesPerCellAxis = 8;
+
+    float SampleLuma(const uint8* Payload, int32 PixelIndex, bool bIs16Bit)
+    {
+        if (bIs16Bit)
+        {
+            const uint16* Pixel = reinterpret_cast<const uint16*>(Payload) + PixelIndex * 4;
+            return (0.2126f * Pixel[0] + 0.7152f * Pixel[1] + 0.0722f * Pixel[2]) / 65535.f;
+        }
+
+        const uint8* Pixel = Payload + PixelIndex * 4;
+        return (0.2126f * Pixel[0] + 0.7152f * Pixel[1] + 0.0722f * Pixel[2]) / 255.f;
+    }
+}
+
+FCaptureFrameFingerprint FCaptureFrameFingerprint::Compute(const FPanoramaCaptureFrame& Frame, bool bBuildLumaGrid)
+{
+    FCaptureFrameFingerprint Result;
+    Result.Resolution = Frame.Resolution;
+    Result.bIs16Bit = Frame.bIs16Bit;
+
+    const int64 BytesPerPixel = Frame.bIs16Bit ? sizeof(uint16) * 4 : 4;
+    const int64 ExpectedBytes = static_cast<int64>(Frame.Resolution.X) * Frame.Resolution.Y * BytesPerPixel;
+    if (Frame.GetPayloadSize() == 0 || Frame.GetPayloadSize() < ExpectedBytes)
+    {
+        Result.Resolution = FIntPoint::ZeroValue;
+        return Result;
+    }
+
+    // FXxHash64 is xxHash3 with SSE2/AVX2/NEON paths; it is bound by memory bandwidth rather than compute.
+    Result.Hash = FXxHash64::HashBuffer(Frame.GetPayloadData(), Frame.GetPayloadSize()).Hash;
+
+    if (!bBuildLumaGrid)
+    {
+        return Result;
+    }
+
+    Result.LumaGrid.SetNumUninitialized(GridWidth * GridHeight);
+    const uint8* Payload = Frame.GetPayloadData();
+
+    for (int32 CellY = 0; CellY < GridHeight; ++CellY)
+    {
+        const int32 MinY = (Frame.Resolution.Y * CellY) / GridHeight;
+        const int32 MaxY = FMath::Max(MinY + 1, (Frame.Resolution.Y * (CellY + 1)) / GridHeight);
+        const int32 StepY = FMath::Max(1, (MaxY - MinY) / SamplesPerCellAxis);
+
+        for (int32 CellX = 0; CellX < GridWidth; ++CellX)
+        {
+            const int32 MinX = (Frame.Resolution.X * CellX) / GridWidth;
+            const int32 MaxX = FMath::Max(MinX + 1, (Frame.Resolution.X * (CellX + 1)) / GridWidth);
+            const int32 StepX = FMath::Max(1, (MaxX - MinX) / SamplesPerCellAxis);
+
+            float LumaSum = 0.f;
+            int32 SampleCount = 0;
+            for (int32 Y = MinY; Y < MaxY; Y += StepY)
+            {
+                for (int32 X = MinX; X < MaxX; X += StepX)
+                {
+                    LumaSum += SampleLuma(Payload, Y * Frame.Resolution.X + X, Frame.bIs16Bit);
+                    ++SampleCount;
+                }
+            }
+
+            const float AverageLuma = SampleCount > 0 ? LumaSum / SampleCount : 0.f;
+            Result.LumaGrid[CellY * GridWidth + CellX] = static_cast<uint8>(FMath::Clamp(FMath::RoundToInt(AverageLuma * 255.f), 0, 255));
+        }
+    }
+
+    return Result;
+}
+
+bool FCaptureFrameFingerprint::Matches(const FCaptureFrameFingerprint& Other, float Threshold) const
+{
+    if (!IsValid() || !Other.IsValid() || Resolution != Other.Resolution || bIs16Bit != Other.bIs16Bit)
+    {
+        return false;
+    }
+
+    if (Hash == Other.Hash)
+    {
+        return true;
+    }
+
+    if (Threshold <= 0.f || LumaGrid.Num() == 0 || LumaGrid.Num() != Other.LumaGrid.Num())
+    {
+        return false;
+    }
+
+    int32 TotalDifference = 0;
+    for (int32 Index = 0; Index < LumaGrid.Num(); ++Index)
+    {
+        TotalDifference += FMath::Abs(static_cast<int32>(LumaGrid[Index]) - static_cast<int32>(Other.LumaGrid[Index]));
+    }
+
+    const float MeanDifference = static_cast<float>(TotalDifference) / (255.f * LumaGrid.Num());
+    return MeanDifference <= Threshold;
+}
@@ -2,8 +2,88 @@
 
 #include "HAL/Event.h"
 #include "HAL/PlatformProcess.h"
+#include "Templates/UniquePtr.h"
 #include "Misc/ScopeLock.h"
 
+void FCapturePayloadPool::Initialize(int32 InCapacity, int32 InPayloadBytes)
+{
+    FScopeLock Lock(&CriticalSection);
+    MaxCapacity = FMath::Max(1, InCapacity);
+    if (BufferBytes != InPayloadBytes)
+    {
+        FreeBuffers.Reset();
+        BufferBytes = InPayloadBytes;
+    }
+
+    if (FreeBuffers.Num() > MaxCapacity)
+    {
+        FreeBuffers.SetNum(MaxCapacity);
+    }
+    while (FreeBuffers.Num() < MaxCapacity && BufferBytes > 0)
+    {
+        TUniquePtr<TArray<uint8>>& Buffer = FreeBuffers.Add_GetRef(MakeUnique<TArray<uint8>>());
+        Buffer->SetNumUninitialized(BufferBytes);
+    }
+}
+
+TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe> FCapturePayloadPool::Acquire(int32 PayloadBytes)
+{
+    TUniquePtr<TArray<uint8>> Buffer;
+    {
+        FScopeLock Lock(&CriticalSection);
+        if (FreeBuffers.Num() > 0)
+        {
+            Buffer = FreeBuffers.Pop(false);
+        }
+    }
+
+    if (!Buffer.IsValid())
+    {
+        Buffer = MakeUnique<TArray<uint8>>();
+    }
+    // A pooled buffer already has this size, so this only allocates for overflow buffers or after a resize.
+    Buffer->SetNumUninitialized(PayloadBytes, false);
+
+    TWeakPtr<FCapturePayloadPool, ESPMode::ThreadSafe> WeakPool = AsShared();
+    return TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe>(Buffer.Release(), [WeakPool](TArray<uint8>* Released)
+    {
+        if (TSharedPtr<FCapturePayloadPool, ESPMode::ThreadSafe> Pool = WeakPool.Pin())
+        {
+            Pool->Release(Released);
+        }
+        else
+        {
+            delete Released;
+        }
+    });
+}
+
+void FCapturePayloadPool::Empty()
+{
+    FScopeLock Lock(&CriticalSection);
+    FreeBuffers.Empty();
+    MaxCapacity = 0;
+    BufferBytes = 0;
+}
+
+int32 FCapturePayloadPool::GetFreeCount() const
+{
+    FScopeLock Lock(&CriticalSection);
+    return FreeBuffers.Num();
+}
+
+void FCapturePayloadPool::Release(TArray<uint8>* Buffer)
+{
+    TUniquePtr<TArray<uint8>> Owned(Buffer);
+
+    FScopeLock Lock(&CriticalSection);
+    // Overflow buffers beyond the capacity, and buffers from before a resolution change, are freed instead of kept.
+    if (Owned->Num() == BufferBytes && FreeBuffers.Num() < MaxCapacity)
+    {
+        FreeBuffers.Add(MoveTemp(Owned));
+    }
+}
+
 FCaptureFrameRingBuffer::FCaptureFrameRingBuffer()
     : Head(0)
     , Tail(0)
@@ -26,6 +106,11 @@ void FCaptureFrameRingBuffer::Initialize(int32 InCapacity, ERingBufferOverflowPo
 {
     FScopeLock Lock(&CriticalSection);
     MaxCapacity = FMath::Max(1, InCapacity);
+    // Slots are kept across sessions; only frames left from the previous one are released.
+    for (FPanoramaCaptureFrame& Frame : Frames)
+    {
+        Frame = FPanoramaCaptureFrame();
+    }
     Frames.SetNum(MaxCapacity);
     Head = 0;
     Tail = 0;
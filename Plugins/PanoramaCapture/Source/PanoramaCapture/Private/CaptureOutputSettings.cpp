@@ -9,4 +9,5 @@ UPanoramaCaptureSettings::UPanoramaCaptureSettings()
     DefaultOutputDirectory = TEXT("PanoramaCaptures");
     bDefaultAutoAssemble = true;
     FFmpegExecutable = TEXT("");
+    EditorPreviewMaxRefreshRate = 15.f;
 }
@@ -2,10 +2,18 @@
 
 #include "Camera/CameraTypes.h"
 #include "Engine/TextureRenderTarget2D.h"
+#include "PanoramaODS.h"
+#include "PanoramaOutputLayout.h"
+#include "PanoramaProjectionMath.h"
+#include "PanoramaProjectionLUT.h"
+#include "PanoramaViewFamilyCapture.h"
+#include "RHI.h"
 
 namespace
 {
     constexpr int32 FacesPerEye = 6;
+    /** Stride of one resolution level in FaceLevelRenderTargets: both eyes' faces. */
+    constexpr int32 MaxFaceCaptures = 2 * FacesPerEye;
 
     const FRotator FaceRotations[FacesPerEye] = {
         FRotator(0.f, 90.f, 0.f),   // +X
@@ -16,6 +24,12 @@ namespace
         FRotator(0.f, 180.f, 0.f)   // -Z (back)
     };
 
+    /** +Y and -Y, which the eyes may share. */
+    bool IsPolarFace(int32 FaceIndex)
+    {
+        return FaceIndex == 2 || FaceIndex == 3;
+    }
+
     const TCHAR* FaceNames[FacesPerEye] = {
         TEXT("+X"),
         TEXT("-X"),
@@ -62,50 +76,379 @@ void UCubemapCaptureRigComponent::OnUnregister()
 
 void UCubemapCaptureRigComponent::InitializeRig()
 {
+    if (IsODSActive())
+    {
+        // ODS renders slices instead of faces, so no face target is kept alive alongside the slice batch.
+        DestroyCaptures(FaceCaptures);
+        EyeRenderTargets.Empty();
+        FaceLevelRenderTargets.Empty();
+        RegionRenderTargets.Empty();
+        DestroyCaptures(FarFieldCaptures);
+        FarFieldRenderTargets.Empty();
+        ActiveFaceMask = 0;
+        EnsureODSSliceCaptures();
+        return;
+    }
+
+    DestroyCaptures(ODSSliceCaptures);
+    ODSSliceRenderTargets.Empty();
+    bCaptureTransformsDirty = true;
+
     const int32 EyeCount = bStereo ? 2 : 1;
     const int32 RequiredFaces = EyeCount * FacesPerEye;
+    // A stereo rig switched to mono drops its right eye captures instead of rendering them unused.
+    DestroyCaptures(FaceCaptures, RequiredFaces);
     FaceCaptures.Reserve(RequiredFaces);
     EyeRenderTargets.SetNum(RequiredFaces);
+    if (bRegionCapture)
+    {
+        // Regions are rendered into RegionRenderTargets, so no whole face is kept alongside them.
+        FaceLevelRenderTargets.Empty();
+        RegionRenderTargets.SetNum(RequiredFaces);
+    }
+    else
+    {
+        RegionRenderTargets.Empty();
+        FaceLevelRenderTargets.SetNum(ResolutionScaleLevels.Num() * MaxFaceCaptures);
+        for (int32 Level = 0; Level < ResolutionScaleLevels.Num(); ++Level)
+        {
+            for (int32 CaptureIndex = RequiredFaces; CaptureIndex < MaxFaceCaptures; ++CaptureIndex)
+            {
+                FaceLevelRenderTargets[Level * MaxFaceCaptures + CaptureIndex] = nullptr;
+            }
+        }
+    }
 
     for (int32 EyeIndex = 0; EyeIndex < EyeCount; ++EyeIndex)
     {
         EnsureFaceCaptures(EyeIndex);
     }
 
+    if (IsMonoFarFieldActive())
+    {
+        EnsureFarFieldCaptures();
+    }
+    else
+    {
+        DestroyCaptures(FarFieldCaptures);
+        FarFieldRenderTargets.Empty();
+    }
+
+    ActiveFaceMask = FPanoramaOutputLayout::ComputeFaceCoverageMask(FPanoramaProjectionLUTKey::FromSettings(OutputSettings));
+
+    // Every face starts unrendered, so the first time slice renders them all.
+    FaceCaptureFrames.Init(MAX_uint64, FaceCaptures.Num());
+    TimeSliceCursor = 0;
+    LastTimeSliceFrame = MAX_uint64;
+
     UpdateCaptureTransforms();
 }
 
 void UCubemapCaptureRigComponent::ReleaseRig()
 {
-    for (TObjectPtr<USceneCaptureComponent2D>& Capture : FaceCaptures)
+    DestroyCaptures(FaceCaptures);
+    EyeRenderTargets.Empty();
+    FaceLevelRenderTargets.Empty();
+    RegionRenderTargets.Empty();
+    DestroyCaptures(ODSSliceCaptures);
+    ODSSliceRenderTargets.Empty();
+    DestroyCaptures(FarFieldCaptures);
+    FarFieldRenderTargets.Empty();
+    ViewFamilyAtlases.Empty();
+    QueuedFaceViews.Empty();
+    FaceCaptureFrames.Empty();
+}
+
+void UCubemapCaptureRigComponent::TickRig(float DeltaTime)
+{
+    if (!IsRegistered())
     {
-        if (Capture)
+        return;
+    }
+
+    if (IsTimeSlicingActive())
+    {
+        if (LastTimeSliceFrame != GFrameCounter)
         {
-            Capture->DestroyComponent();
+            CaptureTimeSlicedFaces();
         }
+        return;
     }
-    FaceCaptures.Empty();
-    EyeRenderTargets.Empty();
+
+    CaptureFaces(ActiveFaceMask);
 }
 
-void UCubemapCaptureRigComponent::TickRig(float DeltaTime)
+bool UCubemapCaptureRigComponent::IsTimeSlicingActive() const
 {
-    if (!IsRegistered())
+    return OutputSettings.TimeSlicing.bEnabled && !IsODSActive() && !IsMonoFarFieldActive();
+}
+
+void UCubemapCaptureRigComponent::CaptureTimeSlicedFaces()
+{
+    if (bCaptureTransformsDirty)
+    {
+        UpdateCaptureTransforms();
+    }
+
+    const uint64 Frame = GFrameCounter;
+    LastTimeSliceFrame = Frame;
+
+    const int32 CaptureCount = FMath::Min(FaceCaptures.Num(), FaceCaptureFrames.Num());
+    const uint64 MaxStaleFrames = static_cast<uint64>(FMath::Max(0, OutputSettings.TimeSlicing.MaxStaleFrames));
+    int32 Budget = FMath::Max(1, OutputSettings.TimeSlicing.FacesPerFrame);
+
+    // The staleness bound wins over the budget: a budget too small to cycle every face within the bound costs extra renders, not older faces.
+    for (int32 CaptureIndex = 0; CaptureIndex < CaptureCount; ++CaptureIndex)
+    {
+        const uint64 LastFrame = FaceCaptureFrames[CaptureIndex];
+        if (IsFaceCaptureUsed(CaptureIndex) && (LastFrame == MAX_uint64 || Frame - LastFrame >= MaxStaleFrames))
+        {
+            RenderFaceCapture(CaptureIndex);
+            --Budget;
+        }
+    }
+
+    for (int32 Visited = 0; Visited < CaptureCount && Budget > 0; ++Visited)
+    {
+        const int32 CaptureIndex = TimeSliceCursor;
+        TimeSliceCursor = (TimeSliceCursor + 1) % CaptureCount;
+        if (IsFaceCaptureUsed(CaptureIndex) && FaceCaptureFrames[CaptureIndex] != Frame)
+        {
+            RenderFaceCapture(CaptureIndex);
+            --Budget;
+        }
+    }
+
+    RenderQueuedFaceViews();
+}
+
+int32 UCubemapCaptureRigComponent::GetOldestFaceAge() const
+{
+    int32 OldestAge = 0;
+    for (int32 CaptureIndex = 0; CaptureIndex < FaceCaptureFrames.Num(); ++CaptureIndex)
+    {
+        if (!IsFaceCaptureUsed(CaptureIndex))
+        {
+            continue;
+        }
+
+        const uint64 LastFrame = FaceCaptureFrames[CaptureIndex];
+        if (LastFrame == MAX_uint64)
+        {
+            return INDEX_NONE;
+        }
+        OldestAge = FMath::Max(OldestAge, static_cast<int32>(FMath::Min<uint64>(GFrameCounter - LastFrame, MAX_int32)));
+    }
+    return OldestAge;
+}
+
+bool UCubemapCaptureRigComponent::IsFaceCaptureUsed(int32 CaptureIndex) const
+{
+    return FaceCaptures.IsValidIndex(CaptureIndex) && FaceCaptures[CaptureIndex] && IsFaceActive(CaptureIndex % FacesPerEye);
+}
+
+bool UCubemapCaptureRigComponent::UsesViewFamilies() const
+{
+    return OutputSettings.CaptureBackend == EPanoramaCaptureBackend::MultiViewFamily && !bRegionCapture && !IsODSActive();
+}
+
+bool UCubemapCaptureRigComponent::SharesPolarFaces() const
+{
+    return bStereo && OutputSettings.bSharePolarFaces && !IsODSActive();
+}
+
+void UCubemapCaptureRigComponent::RenderFaceCapture(int32 CaptureIndex)
+{
+    if (USceneCaptureComponent2D* Capture = FaceCaptures[CaptureIndex])
     {
+        // A face moves to the current resolution level only when it renders, so its last image stays bound until then.
+        const int32 LevelIndex = ResolutionLevel * MaxFaceCaptures + CaptureIndex;
+        UTextureRenderTarget2D* RenderTarget = FaceLevelRenderTargets.IsValidIndex(LevelIndex) ? FaceLevelRenderTargets[LevelIndex].Get() : nullptr;
+        if (RenderTarget && Capture->TextureTarget != RenderTarget)
+        {
+            BindCaptureTarget(Capture, RenderTarget);
+            EyeRenderTargets[CaptureIndex] = RenderTarget;
+        }
+
+        if (UsesViewFamilies())
+        {
+            QueuedFaceViews.Add(CaptureIndex);
+        }
+        else
+        {
+            Capture->CaptureScene();
+        }
+        if (FaceCaptureFrames.IsValidIndex(CaptureIndex))
+        {
+            FaceCaptureFrames[CaptureIndex] = GFrameCounter;
+        }
+    }
+}
+
+void UCubemapCaptureRigComponent::RenderQueuedFaceViews()
+{
+    UWorld* World = GetWorld();
+    if (QueuedFaceViews.IsEmpty() || !World)
+    {
+        QueuedFaceViews.Reset();
         return;
     }
 
-    UpdateCaptureTransforms();
+    TArray<FPanoramaViewFamilyCapture::FFaceView> PendingViews;
+    for (const int32 CaptureIndex : QueuedFaceViews)
+    {
+        USceneCaptureComponent2D* Capture = FaceCaptures.IsValidIndex(CaptureIndex) ? FaceCaptures[CaptureIndex].Get() : nullptr;
+        if (Capture && Capture->TextureTarget)
+        {
+            PendingViews.AddDefaulted_GetRef().Capture = Capture;
+        }
+    }
+    QueuedFaceViews.Reset();
 
-    for (TObjectPtr<USceneCaptureComponent2D>& Capture : FaceCaptures)
+    // Quality profiles that change show flags split the faces into one family per distinct set; the rest share one.
+    int32 FamilyIndex = 0;
+    TArray<FPanoramaViewFamilyCapture::FFaceView> FamilyViews;
+    while (PendingViews.Num() > 0)
     {
-        if (Capture)
+        const USceneCaptureComponent2D& FirstCapture = *PendingViews[0].Capture;
+        FamilyViews.Reset();
+        for (int32 Index = 0; Index < PendingViews.Num();)
+        {
+            if (FPanoramaViewFamilyCapture::CanShareFamily(FirstCapture, *PendingViews[Index].Capture))
+            {
+                FamilyViews.Add(PendingViews[Index]);
+                PendingViews.RemoveAt(Index);
+            }
+            else
+            {
+                ++Index;
+            }
+        }
+
+        // A family too large for one atlas continues in the next.
+        for (int32 FirstView = 0; FirstView < FamilyViews.Num();)
+        {
+            const TArrayView<FPanoramaViewFamilyCapture::FFaceView> RemainingViews = MakeArrayView(FamilyViews).Slice(FirstView, FamilyViews.Num() - FirstView);
+            FIntPoint AtlasSize;
+            const int32 ViewCount = FPanoramaViewFamilyCapture::LayoutViews(RemainingViews, AtlasSize);
+
+            // Growing only, so alternating families of different sizes never reallocate every tick.
+            if (ViewFamilyAtlases.Num() <= FamilyIndex)
+            {
+                ViewFamilyAtlases.SetNum(FamilyIndex + 1);
+            }
+            TObjectPtr<UTextureRenderTarget2D>& Atlas = ViewFamilyAtlases[FamilyIndex];
+            const UTextureRenderTarget2D* FaceTarget = FirstCapture.TextureTarget;
+            if (Atlas && Atlas->OverrideFormat == FaceTarget->OverrideFormat)
+            {
+                AtlasSize = AtlasSize.ComponentMax(FIntPoint(Atlas->SizeX, Atlas->SizeY));
+            }
+            EnsureFaceTarget(Atlas, AtlasSize, FaceTarget->OverrideFormat, FaceTarget->TargetGamma);
+
+            FPanoramaViewFamilyCapture::Render(*World, *Atlas, RemainingViews.Slice(0, ViewCount));
+            FirstView += ViewCount;
+            ++FamilyIndex;
+        }
+    }
+}
+
+void UCubemapCaptureRigComponent::CaptureFaces(uint8 FaceMask)
+{
+    if (bCaptureTransformsDirty)
+    {
+        UpdateCaptureTransforms();
+    }
+
+    const uint8 CapturedMask = FaceMask & ActiveFaceMask;
+    for (int32 CaptureIndex = 0; CaptureIndex < FaceCaptures.Num(); ++CaptureIndex)
+    {
+        if ((CapturedMask & (1u << (CaptureIndex % FacesPerEye))) != 0)
+        {
+            RenderFaceCapture(CaptureIndex);
+        }
+    }
+    RenderQueuedFaceViews();
+
+    for (int32 FaceIndex = 0; FaceIndex < FarFieldCaptures.Num(); ++FaceIndex)
+    {
+        USceneCaptureComponent2D* Capture = FarFieldCaptures[FaceIndex];
+        if (Capture && (CapturedMask & (1u << FaceIndex)) != 0)
         {
+            const int32 LevelIndex = ResolutionLevel * FacesPerEye + FaceIndex;
+            if (FarFieldRenderTargets.IsValidIndex(LevelIndex))
+            {
+                BindCaptureTarget(Capture, FarFieldRenderTargets[LevelIndex]);
+            }
             Capture->CaptureScene();
         }
     }
 }
 
+void UCubemapCaptureRigComponent::SetProjectionJitter(const FVector2f& JitterTexels)
+{
+    const bool bJitter = !JitterTexels.IsNearlyZero();
+
+    for (int32 CaptureIndex = 0; CaptureIndex < FaceCaptures.Num(); ++CaptureIndex)
+    {
+        if (USceneCaptureComponent2D* Capture = FaceCaptures[CaptureIndex])
+        {
+            // Same construction as the capture's own bordered projection, shifted the way the renderer applies TAA jitter.
+            const int32 FaceIndex = CaptureIndex % FacesPerEye;
+            const float HalfFov = PanoramaProjection::GetBorderedFaceHalfFov(GetFaceTargetSize(FaceIndex));
+            const float Extent = static_cast<float>(GetFaceTargetExtent(FaceIndex));
+            FMatrix Projection = FReversedZPerspectiveMatrix(HalfFov, HalfFov, 1.f, 1.f, NearClipPlane, NearClipPlane);
+            Projection.M[2][0] += JitterTexels.X * 2.f / Extent;
+            Projection.M[2][1] += JitterTexels.Y * -2.f / Extent;
+
+            Capture->bUseCustomProjectionMatrix = bJitter;
+            Capture->CustomProjectionMatrix = Projection;
+        }
+    }
+}
+
+UTextureRenderTarget2D* UCubemapCaptureRigComponent::CaptureFaceRegion(int32 CaptureIndex, const FIntRect& TexelRect, const FVector2f& JitterTexels)
+{
+    if (!bRegionCapture || !IsFaceCaptureUsed(CaptureIndex) || !RegionRenderTargets.IsValidIndex(CaptureIndex) || TexelRect.Area() <= 0)
+    {
+        return nullptr;
+    }
+
+    if (bCaptureTransformsDirty)
+    {
+        UpdateCaptureTransforms();
+    }
+
+    const float TargetGamma = (OutputSettings.GammaSpace == EPanoramaGammaSpace::Linear) ? 1.0f : 2.2f;
+    UTextureRenderTarget2D* RenderTarget = EnsureFaceTarget(RegionRenderTargets[CaptureIndex], TexelRect.Size(), GetCapturePixelFormat(), TargetGamma);
+
+    // The face projection maps face UV 0-1 to NDC -1 to 1 on each axis (V down, NDC up); this maps the rectangle there
+    // instead, so the frustum only encloses the region.
+    const float FaceSize = static_cast<float>(GetFaceTargetSize(CaptureIndex % FacesPerEye));
+    const FVector2f UVMin = FVector2f(TexelRect.Min) / FaceSize;
+    const FVector2f UVSize = FVector2f(TexelRect.Size()) / FaceSize;
+    const float CentreX = 2.f * UVMin.X + UVSize.X - 1.f;
+    const float CentreY = 1.f - (2.f * UVMin.Y + UVSize.Y);
+
+    FMatrix Projection = FReversedZPerspectiveMatrix(UE_PI / 4.f, UE_PI / 4.f, 1.f, 1.f, NearClipPlane, NearClipPlane);
+    Projection.M[0][0] = 1.f / UVSize.X;
+    Projection.M[1][1] = 1.f / UVSize.Y;
+    Projection.M[2][0] = -CentreX / UVSize.X + JitterTexels.X * 2.f / TexelRect.Width();
+    Projection.M[2][1] = -CentreY / UVSize.Y - JitterTexels.Y * 2.f / TexelRect.Height();
+
+    USceneCaptureComponent2D* Capture = FaceCaptures[CaptureIndex];
+    Capture->bUseCustomProjectionMatrix = true;
+    Capture->CustomProjectionMatrix = Projection;
+    Capture->TextureTarget = RenderTarget;
+    Capture->CaptureScene();
+
+    EyeRenderTargets[CaptureIndex] = RenderTarget;
+    if (FaceCaptureFrames.IsValidIndex(CaptureIndex))
+    {
+        FaceCaptureFrames[CaptureIndex] = GFrameCounter;
+    }
+    return RenderTarget;
+}
+
 UTextureRenderTarget2D* UCubemapCaptureRigComponent::GetFaceRenderTarget(int32 FaceIndex, bool bLeftEye) const
 {
     const int32 EyeIndex = bLeftEye ? 0 : (bStereo ? 1 : 0);
@@ -117,19 +460,289 @@ UTextureRenderTarget2D* UCubemapCaptureRigComponent::GetFaceRenderTarget(int32 F
     return nullptr;
 }
 
+bool UCubemapCaptureRigComponent::UsesMonoFarField(const FCaptureOutputSettings& Settings)
+{
+    return Settings.StereoCapture == EPanoramaStereoCapture::MonoFarField
+        && Settings.StereoMode != EPanoramaStereoMode::Mono;
+}
+
+bool UCubemapCaptureRigComponent::CapturesSceneLinear(const FCaptureOutputSettings& Settings)
+{
+    return Settings.ColorGrading.bGradeAfterStitch || UsesMonoFarField(Settings);
+}
+
+UTextureRenderTarget2D* UCubemapCaptureRigComponent::GetFarFieldRenderTarget(int32 FaceIndex) const
+{
+    // The capture's own target is the level it last rendered at, matching the eye face it is composited into.
+    return IsMonoFarFieldActive() && FarFieldCaptures.IsValidIndex(FaceIndex) && FarFieldCaptures[FaceIndex] ? FarFieldCaptures[FaceIndex]->TextureTarget.Get() : nullptr;
+}
+
+int32 UCubemapCaptureRigComponent::ComputeCubeFaceSize(const FCaptureOutputSettings& Settings, bool bFitTexture)
+{
+    FIntPoint EyeResolution(FMath::Max(1, Settings.Resolution.Width), FMath::Max(1, Settings.Resolution.Height));
+    if (Settings.StereoMode == EPanoramaStereoMode::StereoOverUnder)
+    {
+        EyeResolution.Y = FMath::Max(1, EyeResolution.Y / 2);
+    }
+    else if (Settings.StereoMode == EPanoramaStereoMode::StereoSideBySide)
+    {
+        EyeResolution.X = FMath::Max(1, EyeResolution.X / 2);
+    }
+
+    int32 DensityMatchedSize;
+    if (Settings.Projection == EPanoramaProjection::EquiAngularCubemap)
+    {
+        // Each EAC tile spreads 90 degrees evenly; a rectilinear face is least dense at its centre, where it needs 4/pi times the tile's texels.
+        const int32 TileSize = FMath::Max(FMath::DivideAndRoundUp(EyeResolution.X, 3), FMath::DivideAndRoundUp(EyeResolution.Y, 2));
+        DensityMatchedSize = FMath::CeilToInt(TileSize * 4.f / UE_PI);
+    }
+    else if (Settings.Projection == EPanoramaProjection::Domemaster)
+    {
+        // The fisheye radius is linear in angle, so match the face centre (half an edge per radian) to the image's pixels per radian.
+        const float EyeEdge = static_cast<float>(FPanoramaOutputLayout::GetEyeResolution(Settings).X);
+        DensityMatchedSize = FMath::CeilToInt(2.f * EyeEdge / FMath::DegreesToRadians(FPanoramaOutputLayout::GetFisheyeFieldOfView(Settings)));
+    }
+    else
+    {
+        // A 90 degree face spans a quarter of the equirect's 360 degree width and half of its 180 degree height.
+        DensityMatchedSize = FMath::Max(FMath::DivideAndRoundUp(EyeResolution.X, 4), FMath::DivideAndRoundUp(EyeResolution.Y, 2));
+    }
+
+    const float Supersampling = FMath::Clamp(Settings.FaceSupersampling, 0.5f, 4.f);
+    const int32 FaceSize = FMath::Max(Align(FMath::CeilToInt(DensityMatchedSize * Supersampling), 8), 8);
+    if (!bFitTexture)
+    {
+        return FaceSize;
+    }
+
+    // Leaves room for the face border inside the largest texture the RHI allows.
+    const int32 MaxFaceSize = AlignDown(static_cast<int32>(GetMax2DTextureDimension()) - 2 * PanoramaProjection::FaceBorderTexels, 8);
+    return FMath::Min(FaceSize, MaxFaceSize);
+}
+
+int64 UCubemapCaptureRigComponent::GetFaceMemoryBytes() const
+{
+    const int64 BytesPerPixel = GetCapturePixelFormat() == PF_FloatRGBA ? 8 : 4;
+    if (IsODSActive())
+    {
+        const FIntPoint SliceSize = ComputeODSSliceSize(OutputSettings);
+        return static_cast<int64>(SliceSize.X) * SliceSize.Y * GetODSBatchSize() * 2 * PanoramaODS::PitchRows * BytesPerPixel;
+    }
+
+    if (bRegionCapture)
+    {
+        int64 RegionPixels = 0;
+        for (const UTextureRenderTarget2D* RenderTarget : RegionRenderTargets)
+        {
+            RegionPixels += RenderTarget ? static_cast<int64>(RenderTarget->SizeX) * RenderTarget->SizeY : 0;
+        }
+        return RegionPixels * BytesPerPixel;
+    }
+
+    int64 Pixels = 0;
+    for (const float Scale : ResolutionScaleLevels)
+    {
+        Pixels += GetRenderedPixelsAtScale(Scale);
+    }
+    if (UsesViewFamilies())
+    {
+        for (const UTextureRenderTarget2D* Atlas : ViewFamilyAtlases)
+        {
+            Pixels += Atlas ? static_cast<int64>(Atlas->SizeX) * Atlas->SizeY : 0;
+        }
+    }
+    return Pixels * BytesPerPixel;
+}
+
+int64 UCubemapCaptureRigComponent::GetRenderedPixelsPerFrame() const
+{
+    if (IsODSActive())
+    {
+        const FIntPoint SliceSize = ComputeODSSliceSize(OutputSettings);
+        return static_cast<int64>(SliceSize.X) * SliceSize.Y * GetODSSliceCount() * 2 * PanoramaODS::PitchRows;
+    }
+    return GetRenderedPixelsAtScale(GetResolutionScale());
+}
+
+int64 UCubemapCaptureRigComponent::GetRenderedPixelsAtScale(float Scale) const
+{
+    const int32 EyeCount = bStereo ? 2 : 1;
+    int64 Pixels = 0;
+    for (int32 FaceIndex = 0; FaceIndex < FacesPerEye; ++FaceIndex)
+    {
+        if (IsFaceActive(FaceIndex))
+        {
+            const int64 FaceSize = GetFaceTargetSizeAtScale(FaceIndex, Scale) + 2 * PanoramaProjection::FaceBorderTexels;
+            const int32 FaceEyeCount = (SharesPolarFaces() && IsPolarFace(FaceIndex)) ? 1 : EyeCount;
+            // The mono far field adds one more render of every face.
+            Pixels += FaceSize * FaceSize * (FaceEyeCount + (IsMonoFarFieldActive() ? 1 : 0));
+        }
+    }
+    return Pixels;
+}
+
+int32 UCubemapCaptureRigComponent::GetFaceSize() const
+{
+    return GetFaceSizeAtScale(GetResolutionScale());
+}
+
+int32 UCubemapCaptureRigComponent::GetFaceSizeAtScale(float Scale) const
+{
+    const int32 FaceSize = ComputeCubeFaceSize(OutputSettings, !bRegionCapture);
+    if (Scale >= 1.f)
+    {
+        return FaceSize;
+    }
+    return FMath::Clamp(Align(FMath::CeilToInt(FaceSize * Scale), 8), 8, FaceSize);
+}
+
+void UCubemapCaptureRigComponent::SetResolutionScaleLevels(TConstArrayView<float> InLevels)
+{
+    ResolutionScaleLevels.Reset(InLevels.Num());
+    for (const float Scale : InLevels)
+    {
+        ResolutionScaleLevels.Add(FMath::Clamp(Scale, 0.25f, 1.f));
+    }
+    if (ResolutionScaleLevels.IsEmpty())
+    {
+        ResolutionScaleLevels.Add(1.f);
+    }
+    ResolutionLevel = 0;
+}
+
+bool UCubemapCaptureRigComponent::SetResolutionScale(float InScale)
+{
+    const int32 PreviousFaceSize = GetFaceSize();
+    ResolutionLevel = 0;
+    for (int32 Level = 1; Level < ResolutionScaleLevels.Num(); ++Level)
+    {
+        if (FMath::Abs(ResolutionScaleLevels[Level] - InScale) < FMath::Abs(ResolutionScaleLevels[ResolutionLevel] - InScale))
+        {
+            ResolutionLevel = Level;
+        }
+    }
+    return !IsODSActive() && GetFaceSize() != PreviousFaceSize;
+}
+
+int32 UCubemapCaptureRigComponent::GetFaceTargetSize(int32 FaceIndex) const
+{
+    return GetFaceTargetSizeAtScale(FaceIndex, GetResolutionScale());
+}
+
+int32 UCubemapCaptureRigComponent::GetFaceTargetSizeAtScale(int32 FaceIndex, float Scale) const
+{
+    const int32 FaceSize = GetFaceSizeAtScale(Scale);
+    if (!Faces.IsValidIndex(FaceIndex))
+    {
+        return FaceSize;
+    }
+
+    const float QualityScale = FMath::Clamp(Faces[FaceIndex].Quality.ResolutionScale, 0.25f, 1.f);
+    return FMath::Clamp(Align(FMath::CeilToInt(FaceSize * QualityScale), 8), 8, FaceSize);
+}
+
+int32 UCubemapCaptureRigComponent::GetFaceTargetExtent(int32 FaceIndex) const
+{
+    return GetFaceTargetSize(FaceIndex) + 2 * PanoramaProjection::FaceBorderTexels;
+}
+
 void UCubemapCaptureRigComponent::SetCaptureMaterial(UMaterialInterface* OverrideMaterial)
 {
     CaptureMaterial = OverrideMaterial;
-    for (TObjectPtr<USceneCaptureComponent2D>& Capture : FaceCaptures)
+    for (TArray<TObjectPtr<USceneCaptureComponent2D>>* Captures : { &FaceCaptures, &ODSSliceCaptures })
     {
-        if (Capture)
+        for (TObjectPtr<USceneCaptureComponent2D>& Capture : *Captures)
+        {
+            if (Capture)
+            {
+                Capture->PostProcessSettings.bOverride_AutoExposureMethod = true;
+                Capture->PostProcessSettings.AutoExposureMethod = EAutoExposureMethod::AEM_Manual;
+                Capture->PostProcessSettings.bOverride_ColorGradingLUT = (CaptureMaterial != nullptr);
+                Capture->PostProcessSettings.AddBlendable(CaptureMaterial, 1.0f);
+            }
+        }
+    }
+}
+
+bool UCubemapCaptureRigComponent::UsesODSSlices(const FCaptureOutputSettings& Settings)
+{
+    return Settings.StereoCapture == EPanoramaStereoCapture::ODSSlices
+        && Settings.StereoMode != EPanoramaStereoMode::Mono
+        && Settings.Projection == EPanoramaProjection::Equirectangular;
+}
+
+int32 UCubemapCaptureRigComponent::GetODSSliceCount() const
+{
+    return FMath::Clamp(OutputSettings.ODSSliceCount, 8, 360);
+}
+
+int32 UCubemapCaptureRigComponent::GetODSBatchSize() const
+{
+    return FMath::Min(FMath::Clamp(OutputSettings.ODSSliceBatchSize, 1, 64), GetODSSliceCount());
+}
+
+int32 UCubemapCaptureRigComponent::CaptureODSBatch(int32 BatchIndex)
+{
+    const int32 SliceCount = GetODSSliceCount();
+    const int32 BatchSize = GetODSBatchSize();
+    const int32 FirstSlice = BatchIndex * BatchSize;
+    const int32 BatchSlices = FMath::Min(BatchSize, SliceCount - FirstSlice);
+    if (!IsRegistered() || BatchSlices <= 0 || ODSSliceCaptures.Num() < BatchSize * 2 * PanoramaODS::PitchRows)
+    {
+        return 0;
+    }
+
+    const FVector RigLocation = GetComponentLocation();
+    const FQuat RigRotation = GetComponentQuat();
+
+    for (int32 BatchSlot = 0; BatchSlot < BatchSlices; ++BatchSlot)
+    {
+        const float SliceYaw = PanoramaODS::GetSliceYaw(FirstSlice + BatchSlot, SliceCount);
+        for (int32 EyeIndex = 0; EyeIndex < 2; ++EyeIndex)
         {
-            Capture->PostProcessSettings.bOverride_AutoExposureMethod = true;
-            Capture->PostProcessSettings.AutoExposureMethod = EAutoExposureMethod::AEM_Manual;
-            Capture->PostProcessSettings.bOverride_ColorGradingLUT = (CaptureMaterial != nullptr);
-            Capture->PostProcessSettings.AddBlendable(CaptureMaterial, 1.0f);
+            const FVector EyeLocation = RigLocation + RigRotation.RotateVector(FVector(PanoramaODS::GetEyeOffset(SliceYaw, EyeIndex, OutputSettings.InterpupillaryDistance)));
+            for (int32 Row = 0; Row < PanoramaODS::PitchRows; ++Row)
+            {
+                if (USceneCaptureComponent2D* Capture = ODSSliceCaptures[(BatchSlot * 2 + EyeIndex) * PanoramaODS::PitchRows + Row])
+                {
+                    const FRotator SliceRotation(FMath::RadiansToDegrees(PanoramaODS::GetRowPitch(Row)), FMath::RadiansToDegrees(SliceYaw), 0.f);
+                    Capture->SetWorldLocationAndRotation(EyeLocation, RigRotation * SliceRotation.Quaternion());
+                    Capture->CaptureScene();
+                }
+            }
         }
     }
+
+    return BatchSlices;
+}
+
+UTextureRenderTarget2D* UCubemapCaptureRigComponent::GetODSSliceRenderTarget(int32 BatchSlot, int32 EyeIndex, int32 Row) const
+{
+    const int32 Index = (BatchSlot * 2 + EyeIndex) * PanoramaODS::PitchRows + Row;
+    return ODSSliceRenderTargets.IsValidIndex(Index) ? ODSSliceRenderTargets[Index].Get() : nullptr;
+}
+
+FIntPoint UCubemapCaptureRigComponent::ComputeODSSliceSize(const FCaptureOutputSettings& Settings)
+{
+    const int32 SliceCount = FMath::Clamp(Settings.ODSSliceCount, 8, 360);
+    const int32 EyeWidth = FMath::Max(1, Settings.StereoMode == EPanoramaStereoMode::StereoSideBySide ? Settings.Resolution.Width / 2 : Settings.Resolution.Width);
+    const float TanHalfFov = FMath::Tan(PanoramaODS::GetSliceHalfFov(SliceCount));
+
+    // Square pixels at the equirect's horizontal density; the height then follows from the vertical angle each row covers.
+    const float Supersampling = FMath::Clamp(Settings.FaceSupersampling, 0.5f, 4.f);
+    const float PixelsPerRadian = EyeWidth / (2.f * UE_PI) * Supersampling;
+    const int32 MaxTextureSize = static_cast<int32>(GetMax2DTextureDimension());
+    const int32 Width = FMath::Clamp(Align(FMath::CeilToInt(2.f * TanHalfFov * PixelsPerRadian), 8), 8, MaxTextureSize);
+    const int32 Height = FMath::Clamp(Align(FMath::CeilToInt(Width * FMath::Tan(PanoramaODS::RowHalfFovRadians) / TanHalfFov), 8), 8, MaxTextureSize);
+    return FIntPoint(Width, Height);
+}
+
+FVector2f UCubemapCaptureRigComponent::ComputeODSSliceTanHalfFov(const FCaptureOutputSettings& Settings)
+{
+    // Scene captures hold the horizontal angle and derive the vertical one from the target's aspect ratio.
+    const FIntPoint SliceSize = ComputeODSSliceSize(Settings);
+    const float TanHalfFov = FMath::Tan(PanoramaODS::GetSliceHalfFov(FMath::Clamp(Settings.ODSSliceCount, 8, 360)));
+    return FVector2f(TanHalfFov, TanHalfFov * SliceSize.Y / SliceSize.X);
 }
 
 void UCubemapCaptureRigComponent::EnsureFaceCaptures(int32 EyeIndex)
@@ -152,49 +765,211 @@ void UCubemapCaptureRigComponent::EnsureFaceCaptures(int32 EyeIndex)
         const int32 CaptureIndex = StartIndex + FaceIndex;
         TObjectPtr<USceneCaptureComponent2D>& Capture = FaceCaptures[CaptureIndex];
 
+        if (EyeIndex > 0 && SharesPolarFaces() && IsPolarFace(FaceIndex))
+        {
+            // The left eye's centred polar face stands in for this one.
+            if (Capture)
+            {
+                Capture->DestroyComponent();
+                Capture = nullptr;
+            }
+            EyeRenderTargets[CaptureIndex] = nullptr;
+            for (int32 Level = 0; Level < ResolutionScaleLevels.Num() && !bRegionCapture; ++Level)
+            {
+                FaceLevelRenderTargets[Level * MaxFaceCaptures + CaptureIndex] = nullptr;
+            }
+            if (RegionRenderTargets.IsValidIndex(CaptureIndex))
+            {
+                RegionRenderTargets[CaptureIndex] = nullptr;
+            }
+            continue;
+        }
+
         if (!Capture)
         {
-            Capture = NewObject<USceneCaptureComponent2D>(GetOwner());
-            Capture->AttachToComponent(this, FAttachmentTransformRules::SnapToTargetIncludingScale);
-            Capture->SetRelativeLocation(FVector::ZeroVector);
-            Capture->SetRelativeRotation(FRotator::ZeroRotator);
-            Capture->RegisterComponent();
+            Capture = CreateCaptureComponent();
+        }
+        else
+        {
+            // Settings may have changed the capture source since the component was created.
             ConfigureCaptureComponent(Capture);
         }
+        ApplyFaceQuality(Capture, FaceIndex);
+
+        if (Capture && IsMonoFarFieldActive())
+        {
+            // Depth in alpha drives the composite. Primitives are culled by bounds distance, so the limit covers the depth
+            // plane out to the face corners, sqrt(3) times further away than at the face centre.
+            Capture->CaptureSource = ESceneCaptureSource::SCS_SceneColorSceneDepth;
+            Capture->MaxViewDistanceOverride = FMath::Min(GetFarFieldDistance() * UE_SQRT_3, FarClipPlane);
+        }
 
-        const EPixelFormat PixelFormat = OutputSettings.bUse16BitPNG ? PF_FloatRGBA : PF_B8G8R8A8;
-        const int32 Width = OutputSettings.Resolution.Width;
-        const int32 Height = OutputSettings.Resolution.Height;
-        UTextureRenderTarget2D* RenderTarget = EyeRenderTargets[CaptureIndex].Get();
+        if (bRegionCapture)
+        {
+            // CaptureFaceRegion picks the target and projection per region.
+            EyeRenderTargets[CaptureIndex] = nullptr;
+            if (Capture)
+            {
+                Capture->TextureTarget = nullptr;
+            }
+            continue;
+        }
+
+        // Every level is allocated now so that the resolution governor never resizes a target mid-take.
+        const EPixelFormat PixelFormat = GetCapturePixelFormat();
+        const float TargetGamma = (OutputSettings.GammaSpace == EPanoramaGammaSpace::Linear) ? 1.0f : 2.2f;
+        for (int32 Level = 0; Level < ResolutionScaleLevels.Num(); ++Level)
+        {
+            const int32 FaceExtent = GetFaceTargetSizeAtScale(FaceIndex, ResolutionScaleLevels[Level]) + 2 * PanoramaProjection::FaceBorderTexels;
+            EnsureFaceTarget(FaceLevelRenderTargets[Level * MaxFaceCaptures + CaptureIndex], FIntPoint(FaceExtent), PixelFormat, TargetGamma);
+        }
+
+        UTextureRenderTarget2D* RenderTarget = FaceLevelRenderTargets[ResolutionLevel * MaxFaceCaptures + CaptureIndex];
+        EyeRenderTargets[CaptureIndex] = RenderTarget;
+        BindCaptureTarget(Capture, RenderTarget);
+    }
+}
+
+void UCubemapCaptureRigComponent::EnsureFarFieldCaptures()
+{
+    FarFieldCaptures.SetNum(FacesPerEye);
+    FarFieldRenderTargets.SetNum(ResolutionScaleLevels.Num() * FacesPerEye);
+
+    const EPixelFormat PixelFormat = GetCapturePixelFormat();
+    for (int32 FaceIndex = 0; FaceIndex < FacesPerEye; ++FaceIndex)
+    {
+        TObjectPtr<USceneCaptureComponent2D>& Capture = FarFieldCaptures[FaceIndex];
+        if (!Capture)
+        {
+            Capture = CreateCaptureComponent();
+        }
+        else
+        {
+            ConfigureCaptureComponent(Capture);
+        }
+        ApplyFaceQuality(Capture, FaceIndex);
+
+        // Each level matches the eye face it is composited into, border included, so the composite reads both at the same
+        // texel; the two always switch levels in the same CaptureFaces call.
+        for (int32 Level = 0; Level < ResolutionScaleLevels.Num(); ++Level)
+        {
+            const int32 FaceExtent = GetFaceTargetSizeAtScale(FaceIndex, ResolutionScaleLevels[Level]) + 2 * PanoramaProjection::FaceBorderTexels;
+            EnsureFaceTarget(FarFieldRenderTargets[Level * FacesPerEye + FaceIndex], FIntPoint(FaceExtent), PixelFormat, 1.0f);
+        }
+
+        if (Capture)
+        {
+            Capture->CustomNearClippingPlane = GetFarFieldDistance();
+            BindCaptureTarget(Capture, FarFieldRenderTargets[ResolutionLevel * FacesPerEye + FaceIndex]);
+        }
+    }
+}
+
+UTextureRenderTarget2D* UCubemapCaptureRigComponent::EnsureFaceTarget(TObjectPtr<UTextureRenderTarget2D>& RenderTarget, const FIntPoint& Size, EPixelFormat PixelFormat, float TargetGamma)
+{
+    if (!RenderTarget)
+    {
+        RenderTarget = NewObject<UTextureRenderTarget2D>(this);
+        RenderTarget->ClearColor = FLinearColor::Black;
+    }
+
+    if (RenderTarget->SizeX != Size.X || RenderTarget->SizeY != Size.Y || RenderTarget->OverrideFormat != PixelFormat || RenderTarget->TargetGamma != TargetGamma)
+    {
+        RenderTarget->InitCustomFormat(Size.X, Size.Y, PixelFormat, false);
+        RenderTarget->TargetGamma = TargetGamma;
+        RenderTarget->UpdateResourceImmediate(true);
+    }
+    return RenderTarget;
+}
+
+void UCubemapCaptureRigComponent::BindCaptureTarget(USceneCaptureComponent2D* Capture, UTextureRenderTarget2D* RenderTarget)
+{
+    if (!Capture || !RenderTarget)
+    {
+        return;
+    }
+
+    const int32 InteriorSize = RenderTarget->SizeX - 2 * PanoramaProjection::FaceBorderTexels;
+    Capture->FOVAngle = 2.f * FMath::RadiansToDegrees(PanoramaProjection::GetBorderedFaceHalfFov(InteriorSize));
+    Capture->TextureTarget = RenderTarget;
+}
+
+void UCubemapCaptureRigComponent::EnsureODSSliceCaptures()
+{
+    const int32 RequiredCaptures = GetODSBatchSize() * 2 * PanoramaODS::PitchRows;
+    DestroyCaptures(ODSSliceCaptures, RequiredCaptures);
+    ODSSliceCaptures.SetNum(RequiredCaptures);
+    ODSSliceRenderTargets.SetNum(RequiredCaptures);
+
+    const EPixelFormat PixelFormat = GetCapturePixelFormat();
+    const FIntPoint SliceSize = ComputeODSSliceSize(OutputSettings);
+    const float FOVAngle = 2.f * FMath::RadiansToDegrees(PanoramaODS::GetSliceHalfFov(GetODSSliceCount()));
+
+    for (int32 CaptureIndex = 0; CaptureIndex < RequiredCaptures; ++CaptureIndex)
+    {
+        TObjectPtr<USceneCaptureComponent2D>& Capture = ODSSliceCaptures[CaptureIndex];
+        if (!Capture)
+        {
+            Capture = CreateCaptureComponent();
+        }
+        else
+        {
+            // Settings may have changed the capture source since the component was created.
+            ConfigureCaptureComponent(Capture);
+        }
+
+        TObjectPtr<UTextureRenderTarget2D>& RenderTarget = ODSSliceRenderTargets[CaptureIndex];
         if (!RenderTarget)
         {
             RenderTarget = NewObject<UTextureRenderTarget2D>(this);
             RenderTarget->ClearColor = FLinearColor::Black;
-            EyeRenderTargets[CaptureIndex] = RenderTarget;
         }
 
-        if (RenderTarget->SizeX != Width || RenderTarget->SizeY != Height || RenderTarget->OverrideFormat != PixelFormat)
+        if (RenderTarget->SizeX != SliceSize.X || RenderTarget->SizeY != SliceSize.Y || RenderTarget->OverrideFormat != PixelFormat)
         {
-            RenderTarget->InitCustomFormat(Width, Height, PixelFormat, false);
+            RenderTarget->InitCustomFormat(SliceSize.X, SliceSize.Y, PixelFormat, false);
             RenderTarget->TargetGamma = (OutputSettings.GammaSpace == EPanoramaGammaSpace::Linear) ? 1.0f : 2.2f;
             RenderTarget->UpdateResourceImmediate(true);
         }
 
         if (Capture)
         {
+            Capture->FOVAngle = FOVAngle;
             Capture->TextureTarget = RenderTarget;
         }
     }
 }
 
+void UCubemapCaptureRigComponent::OnUpdateTransform(EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+    Super::OnUpdateTransform(UpdateTransformFlags, Teleport);
+    bCaptureTransformsDirty = true;
+}
+
 void UCubemapCaptureRigComponent::UpdateCaptureTransforms()
 {
+    bCaptureTransformsDirty = false;
+
     const int32 EyeCount = bStereo ? 2 : 1;
     for (int32 EyeIndex = 0; EyeIndex < EyeCount; ++EyeIndex)
     {
-        const float EyeOffset = (EyeCount > 1) ? ((EyeIndex == 0) ? -0.032f : 0.032f) : 0.0f;
+        // Unreal units are centimetres, as is the interpupillary distance.
+        const float HalfIPD = OutputSettings.InterpupillaryDistance * 0.5f;
+        const float EyeOffset = (EyeCount > 1) ? ((EyeIndex == 0) ? -HalfIPD : HalfIPD) : 0.0f;
         const FVector EyeTranslation = GetRightVector() * EyeOffset;
 
+        if (EyeIndex == 0)
+        {
+            for (int32 FaceIndex = 0; FaceIndex < FarFieldCaptures.Num(); ++FaceIndex)
+            {
+                if (USceneCaptureComponent2D* Capture = FarFieldCaptures[FaceIndex])
+                {
+                    const FRotator DesiredRotation = Faces.IsValidIndex(FaceIndex) ? Faces[FaceIndex].Rotation : FaceRotations[FaceIndex];
+                    Capture->SetWorldLocationAndRotation(GetComponentLocation(), DesiredRotation + GetComponentRotation());
+                }
+            }
+        }
+
         for (int32 FaceIndex = 0; FaceIndex < FacesPerEye; ++FaceIndex)
         {
             const int32 CaptureIndex = EyeIndex * FacesPerEye + FaceIndex;
@@ -203,7 +978,8 @@ void UCubemapCaptureRigComponent::UpdateCaptureTransforms()
                 if (USceneCaptureComponent2D* Capture = FaceCaptures[CaptureIndex])
                 {
                     const FRotator DesiredRotation = Faces.IsValidIndex(FaceIndex) ? Faces[FaceIndex].Rotation : FaceRotations[FaceIndex];
-                    Capture->SetWorldLocation(GetComponentLocation() + EyeTranslation);
+                    const bool bCentred = SharesPolarFaces() && IsPolarFace(FaceIndex);
+                    Capture->SetWorldLocation(GetComponentLocation() + (bCentred ? FVector::ZeroVector : EyeTranslation));
                     Capture->SetWorldRotation(DesiredRotation + GetComponentRotation());
                 }
             }
@@ -211,6 +987,35 @@ void UCubemapCaptureRigComponent::UpdateCaptureTransforms()
     }
 }
 
+EPixelFormat UCubemapCaptureRigComponent::GetCapturePixelFormat() const
+{
+    // Scene-linear colour exceeds one, so ungraded faces are always kept in half float.
+    return (OutputSettings.bUse16BitPNG || CapturesSceneLinear(OutputSettings)) ? PF_FloatRGBA : PF_B8G8R8A8;
+}
+
+USceneCaptureComponent2D* UCubemapCaptureRigComponent::CreateCaptureComponent()
+{
+    USceneCaptureComponent2D* Capture = NewObject<USceneCaptureComponent2D>(GetOwner());
+    Capture->AttachToComponent(this, FAttachmentTransformRules::SnapToTargetIncludingScale);
+    Capture->SetRelativeLocation(FVector::ZeroVector);
+    Capture->SetRelativeRotation(FRotator::ZeroRotator);
+    Capture->RegisterComponent();
+    ConfigureCaptureComponent(Capture);
+    return Capture;
+}
+
+void UCubemapCaptureRigComponent::DestroyCaptures(TArray<TObjectPtr<USceneCaptureComponent2D>>& Captures, int32 FirstIndex)
+{
+    for (int32 Index = FirstIndex; Index < Captures.Num(); ++Index)
+    {
+        if (Captures[Index])
+        {
+            Captures[Index]->DestroyComponent();
+        }
+    }
+    Captures.SetNum(FMath::Min(FirstIndex, Captures.Num()));
+}
+
 void UCubemapCaptureRigComponent::ConfigureCaptureComponent(USceneCaptureComponent2D* Capture) const
 {
     if (!Capture)
@@ -219,13 +1024,53 @@ void UCubemapCaptureRigComponent::ConfigureCaptureComponent(USceneCaptureCompone
     }
 
     Capture->bCaptureEveryFrame = false;
-    Capture->CaptureSource = ESceneCaptureSource::SCS_FinalColorHDR;
+    // Grading after the stitch needs scene-linear faces; the post-process chain then runs once instead of per face.
+    Capture->CaptureSource = CapturesSceneLinear(OutputSettings) ? ESceneCaptureSource::SCS_SceneColorHDRNoAlpha : ESceneCaptureSource::SCS_FinalColorHDR;
     Capture->FOVAngle = 90.f;
-    Capture->ClipPlaneNear = NearClipPlane;
-    Capture->ClipPlaneFar = FarClipPlane;
+    // Cleared until SetProjectionJitter or CaptureFaceRegion installs one again.
+    Capture->bUseCustomProjectionMatrix = false;
+    Capture->bOverride_CustomNearClippingPlane = true;
+    Capture->CustomNearClippingPlane = NearClipPlane;
+    Capture->MaxViewDistanceOverride = FarClipPlane;
     Capture->bEnableClipPlane = false;
     Capture->PrimitiveRenderMode = ESceneCapturePrimitiveRenderMode::PRM_RenderScenePrimitives;
     Capture->CompositeMode = ESceneCaptureCompositeMode::SCCM_Overwrite;
     Capture->PostProcessSettings.bOverride_AutoExposureMethod = true;
     Capture->PostProcessSettings.AutoExposureMethod = EAutoExposureMethod::AEM_Manual;
 }
+
+void UCubemapCaptureRigComponent::ApplyFaceQuality(USceneCaptureComponent2D* Capture, int32 FaceIndex) const
+{
+    if (!Capture)
+    {
+        return;
+    }
+
+    static const FPanoramaFaceQualityProfile DefaultProfile;
+    const FPanoramaFaceQualityProfile& Profile = Faces.IsValidIndex(FaceIndex) ? Faces[FaceIndex].Quality : DefaultProfile;
+    Capture->LODDistanceFactor = FMath::Clamp(Profile.LODDistanceFactor, 0.1f, 10.f);
+
+    // The skipped features are always written, so clearing a skip on a reused capture turns the feature back on.
+    TArray<FEngineShowFlagsSetting> ShowFlagSettings;
+    auto AddShowFlag = [&ShowFlagSettings](const TCHAR* Name, bool bEnabled)
+    {
+        FEngineShowFlagsSetting& Setting = ShowFlagSettings.AddDefaulted_GetRef();
+        Setting.ShowFlagName = Name;
+        Setting.Enabled = bEnabled;
+    };
+    AddShowFlag(TEXT("Bloom"), !Profile.bSkipBloom);
+    AddShowFlag(TEXT("AmbientOcclusion"), !Profile.bSkipAmbientOcclusion);
+    AddShowFlag(TEXT("ScreenSpaceReflections"), !Profile.bSkipScreenSpaceReflections);
+    AddShowFlag(TEXT("LensFlares"), !Profile.bSkipLensFlares);
+    ShowFlagSettings.Append(Profile.ShowFlagSettings);
+
+    for (const FEngineShowFlagsSetting& Setting : ShowFlagSettings)
+    {
+        const int32 FlagIndex = FEngineShowFlags::FindIndexByName(*Setting.ShowFlagName);
+        if (FlagIndex != INDEX_NONE)
+        {
+            Capture->ShowFlags.SetSingleFlag(FlagIndex, Setting.Enabled);
+        }
+    }
+    Capture->ShowFlagSettings = MoveTemp(ShowFlagSettings);
+}
@@ -0,0 +1,71 @@
+#include "CubemapEACPass.h"
+
+#include "GlobalShader.h"
+#include "PanoramaCaptureModule.h"
+#include "PanoramaCubeFaces.h"
+#include "RenderGraphBuilder.h"
+#include "RenderGraphUtils.h"
+#include "RenderGraphResources.h"
+#include "ShaderParameterStruct.h"
+#include "ShaderParameterUtils.h"
+#include "ShaderCompilerCore.h"
+#include "ComputeShaderUtils.h"
+
+class FCubemapToEACCS : public FGlobalShader
+{
+public:
+    DECLARE_GLOBAL_SHADER(FCubemapToEACCS);
+    SHADER_USE_PARAMETER_STRUCT(FCubemapToEACCS, FGlobalShader);
+
+    static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+    {
+        return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+    }
+
+    BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+        SHADER_PARAMETER(FVector2f, OutputResolution)
+        SHADER_PARAMETER(uint32, bStereo)
+        SHADER_PARAMETER(uint32, bLinear)
+        SHADER_PARAMETER(uint32, bStereoOverUnder)
+        SHADER_PARAMETER(uint32, bUseProjectionLUT)
+        SHADER_PARAMETER_STRUCT_INCLUDE(FPanoramaCubeFaceParameters, CubeFaces)
+        SHADER_PARAMETER_RDG_TEXTURE(Texture2D<uint>, ProjectionLUT)
+        SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float4>, OutputTexture)
+    END_SHADER_PARAMETER_STRUCT()
+};
+
+IMPLEMENT_GLOBAL_SHADER(FCubemapToEACCS, "/PanoramaCapture/Private/CubemapToEAC.usf", "MainCS", SF_Compute);
+
+void FCubemapEACPass::AddComputePass(FRDGBuilder& GraphBuilder, const FCubemapEquirectDispatchParams& Params)
+{
+    if (!Params.Faces.IsValid() || !Params.DestinationEquirect)
+    {
+        return;
+    }
+
+    FCubemapToEACCS::FParameters* PassParameters = GraphBuilder.AllocParameters<FCubemapToEACCS::FParameters>();
+    PanoramaCubeFaces::SetupParameters(GraphBuilder, Params.Faces, PassParameters->CubeFaces);
+    PassParameters->OutputTexture = GraphBuilder.CreateUAV(Params.DestinationEquirect);
+    PassParameters->OutputResolution = FVector2f(Params.OutputResolution);
+    PassParameters->bStereo = Params.bStereo ? 1u : 0u;
+    PassParameters->bLinear = Params.bLinearGamma ? 1u : 0u;
+    PassParameters->bStereoOverUnder = Params.bStereoOverUnder ? 1u : 0u;
+    PassParameters->bUseProjectionLUT = Params.ProjectionLUT ? 1u : 0u;
+
+    FRDGTextureRef ProjectionLUT = Params.ProjectionLUT;
+    if (!ProjectionLUT)
+    {
+        ProjectionLUT = GraphBuilder.CreateTexture(FRDGTextureDesc::Create2D(FIntPoint(1, 1), PF_R32_UINT, FClearValueBinding::Black, TexCreate_ShaderResource | TexCreate_UAV), TEXT("PanoramaProjectionLUTDummy"));
+        AddClearUAVPass(GraphBuilder, GraphBuilder.CreateUAV(ProjectionLUT), 0u);
+    }
+    PassParameters->ProjectionLUT = ProjectionLUT;
+
+    TShaderMapRef<FCubemapToEACCS> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+
+    const FIntVector GroupCount(
+        FMath::DivideAndRoundUp(Params.OutputResolution.X, 8),
+        FMath::DivideAndRoundUp(Params.OutputResolution.Y, 8),
+        1);
+
+    FComputeShaderUtils::AddPass(GraphBuilder, RDG_EVENT_NAME("Panorama::CubemapToEAC"), ComputeShader, PassParameters, GroupCount);
+}
@@ -0,0 +1,427 @@
+#include "CubemapEquirectCPU.h"
+
+#include "Async/ParallelFor.h"
+#include "Math/VectorRegister.h"
+#include "PanoramaOutputLayout.h"
+#include "PanoramaProjectionLUT.h"
+
+namespace
+{
+    constexpr float EncodeGamma = 1.f / 2.2f;
+
+    /**
+     * The projection table key Params describe. Equirect latitude and longitude ranges only have a key when they match one
+     * of the output layouts; other ranges return false and are projected analytically.
+     */
+    bool MakeProjectionLUTKey(const FCubemapEquirectCPUParams& Params, FPanoramaProjectionLUTKey& OutKey)
+    {
+        OutKey.Resolution = Params.OutputResolution;
+        OutKey.Projection = Params.Projection;
+        OutKey.StereoMode = !Params.bStereo ? EPanoramaStereoMode::Mono : (Params.bStereoOverUnder ? EPanoramaStereoMode::StereoOverUnder : EPanoramaStereoMode::StereoSideBySide);
+        OutKey.FieldOfView = Params.Projection == EPanoramaProjection::Domemaster ? Params.FieldOfView : 0.f;
+        OutKey.Layout = Params.Projection == EPanoramaProjection::Domemaster && Params.bFisheyeForward ? EEquiLayout::VR180 : EEquiLayout::Full360;
+        if (Params.Projection != EPanoramaProjection::Equirectangular)
+        {
+            return true;
+        }
+
+        for (const EEquiLayout Layout : { EEquiLayout::Full360, EEquiLayout::UpperHemisphere, EEquiLayout::LowerHemisphere, EEquiLayout::VR180 })
+        {
+            if (FPanoramaOutputLayout::GetLatitudeRange(Layout).Equals(Params.LatitudeRange) && FPanoramaOutputLayout::GetLongitudeRange(Layout).Equals(Params.LongitudeRange))
+            {
+                OutKey.Layout = Layout;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool AreFacesValid(const FCubemapFaceImage (&Faces)[PanoramaProjection::FacesPerEye])
+    {
+        for (const FCubemapFaceImage& Face : Faces)
+        {
+            if (!Face.IsValid())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const FCubemapFaceImage* SelectEyeFaces(const FCubemapEquirectCPUParams& Params, int32 EyeIndex)
+    {
+        // Mirrors the GPU pass, which binds the left cube to both eyes when no right cube is supplied.
+        if (EyeIndex == 1 && AreFacesValid(Params.FacesRight))
+        {
+            return Params.FacesRight;
+        }
+        return Params.FacesLeft;
+    }
+
+    bool ValidateParams(const FCubemapEquirectCPUParams& Params)
+    {
+        return Params.OutputResolution.X > 0 && Params.OutputResolution.Y > 0 && AreFacesValid(Params.FacesLeft);
+    }
+
+    struct FBilinearTaps
+    {
+        int32 Offsets[4];
+        float FracX;
+        float FracY;
+    };
+
+    FORCEINLINE FBilinearTaps ComputeBilinearTaps(const FCubemapFaceImage& Face, const FVector2f& FaceUV)
+    {
+        // Same inset as SampleCubeFace: FaceUV spans the interior, and the border supplies the taps across the edge.
+        const float TexelX = FaceUV.X * (Face.Size.X - 2 * Face.BorderTexels) + Face.BorderTexels - 0.5f;
+        const float TexelY = FaceUV.Y * (Face.Size.Y - 2 * Face.BorderTexels) + Face.BorderTexels - 0.5f;
+        const int32 BaseX = FMath::FloorToInt(TexelX);
+        const int32 BaseY = FMath::FloorToInt(TexelY);
+
+        const int32 X0 = FMath::Clamp(BaseX, 0, Face.Size.X - 1);
+        const int32 X1 = FMath::Clamp(BaseX + 1, 0, Face.Size.X - 1);
+        const int32 Row0 = FMath::Clamp(BaseY, 0, Face.Size.Y - 1) * Face.Size.X;
+        const int32 Row1 = FMath::Clamp(BaseY + 1, 0, Face.Size.Y - 1) * Face.Size.X;
+
+        FBilinearTaps Taps;
+        Taps.Offsets[0] = Row0 + X0;
+        Taps.Offsets[1] = Row0 + X1;
+        Taps.Offsets[2] = Row1 + X0;
+        Taps.Offsets[3] = Row1 + X1;
+        Taps.FracX = TexelX - BaseX;
+        Taps.FracY = TexelY - BaseY;
+        return Taps;
+    }
+
+    FLinearColor SampleBilinearScalar(const FCubemapFaceImage& Face, const FVector2f& FaceUV)
+    {
+        const FBilinearTaps Taps = ComputeBilinearTaps(Face, FaceUV);
+        const FLinearColor Top = FMath::Lerp(Face.Pixels[Taps.Offsets[0]], Face.Pixels[Taps.Offsets[1]], Taps.FracX);
+        const FLinearColor Bottom = FMath::Lerp(Face.Pixels[Taps.Offsets[2]], Face.Pixels[Taps.Offsets[3]], Taps.FracX);
+        return FMath::Lerp(Top, Bottom, Taps.FracY);
+    }
+
+    FORCEINLINE VectorRegister4Float SampleBilinearVector(const FCubemapFaceImage& Face, const FVector2f& FaceUV)
+    {
+        const FBilinearTaps Taps = ComputeBilinearTaps(Face, FaceUV);
+        const float* Texels = &Face.Pixels.GetData()->R;
+
+        const VectorRegister4Float P00 = VectorLoad(Texels + Taps.Offsets[0] * 4);
+        const VectorRegister4Float P10 = VectorLoad(Texels + Taps.Offsets[1] * 4);
+        const VectorRegister4Float P01 = VectorLoad(Texels + Taps.Offsets[2] * 4);
+        const VectorRegister4Float P11 = VectorLoad(Texels + Taps.Offsets[3] * 4);
+
+        const VectorRegister4Float FracX = VectorSetFloat1(Taps.FracX);
+        const VectorRegister4Float Top = VectorMultiplyAdd(VectorSubtract(P10, P00), FracX, P00);
+        const VectorRegister4Float Bottom = VectorMultiplyAdd(VectorSubtract(P11, P01), FracX, P01);
+        return VectorMultiplyAdd(VectorSubtract(Bottom, Top), VectorSetFloat1(Taps.FracY), Top);
+    }
+
+    /** Per-column and per-row terms of the equirect direction; the trigonometry is separable, so no pixel evaluates sin/cos. */
+    struct FEquirectAngleTables
+    {
+        TArray<float> CosPhi;
+        TArray<float> SinPhi;
+        TArray<uint8> ColumnEye;
+        TArray<float> CosTheta;
+        TArray<float> SinTheta;
+        TArray<uint8> RowEye;
+
+        void Build(const FCubemapEquirectCPUParams& Params)
+        {
+            const FIntPoint Resolution = Params.OutputResolution;
+            // Padded to the vector width so the last group of a row can be loaded without a tail case.
+            const int32 PaddedWidth = Align(Resolution.X, 4);
+
+            TArray<float> PhiAngles;
+            PhiAngles.SetNumZeroed(PaddedWidth);
+            CosPhi.SetNumZeroed(PaddedWidth);
+            SinPhi.SetNumZeroed(PaddedWidth);
+            ColumnEye.SetNumZeroed(PaddedWidth);
+
+            for (int32 X = 0; X < Resolution.X; ++X)
+            {
+                FVector2f SampleUV;
+                const FVector2f OutputUV((X + 0.5f) / Resolution.X, 0.5f);
+                ColumnEye[X] = static_cast<uint8>(PanoramaProjection::ResolveStereoUV(OutputUV, Params.bStereo && !Params.bStereoOverUnder, false, SampleUV));
+                PhiAngles[X] = (Params.LongitudeRange.X + SampleUV.X * Params.LongitudeRange.Y) * (2.f * UE_PI) - UE_PI;
+            }
+
+            for (int32 X = 0; X < PaddedWidth; X += 4)
+            {
+                VectorRegister4Float SinValues;
+                VectorRegister4Float CosValues;
+                const VectorRegister4Float Angles = VectorLoad(PhiAngles.GetData() + X);
+                VectorSinCos(&SinValues, &CosValues, &Angles);
+                VectorStore(SinValues, SinPhi.GetData() + X);
+                VectorStore(CosValues, CosPhi.GetData() + X);
+            }
+
+            CosTheta.SetNumUninitialized(Resolution.Y);
+            SinTheta.SetNumUninitialized(Resolution.Y);
+            RowEye.SetNumUninitialized(Resolution.Y);
+
+            for (int32 Y = 0; Y < Resolution.Y; ++Y)
+            {
+                FVector2f SampleUV;
+                const FVector2f OutputUV(0.5f, (Y + 0.5f) / Resolution.Y);
+                RowEye[Y] = static_cast<uint8>(PanoramaProjection::ResolveStereoUV(OutputUV, Params.bStereo && Params.bStereoOverUnder, true, SampleUV));
+                const float SphereV = Params.LatitudeRange.X + SampleUV.Y * Params.LatitudeRange.Y;
+                FMath::SinCos(&SinTheta[Y], &CosTheta[Y], SphereV * UE_PI - UE_HALF_PI);
+            }
+        }
+    };
+
+    /** Output tiles ordered along a Z-order curve so neighbouring work items touch neighbouring face texels. */
+    void BuildTileOrder(const FIntPoint& Resolution, TArray<FIntRect>& OutTiles)
+    {
+        const int32 TileSize = FCubemapEquirectCPU::TileSize;
+        const int32 TilesX = FMath::DivideAndRoundUp(Resolution.X, TileSize);
+        const int32 TilesY = FMath::DivideAndRoundUp(Resolution.Y, TileSize);
+
+        TArray<TPair<uint32, FIntRect>> Keyed;
+        Keyed.Reserve(TilesX * TilesY);
+        for (int32 TileY = 0; TileY < TilesY; ++TileY)
+        {
+            for (int32 TileX = 0; TileX < TilesX; ++TileX)
+            {
+                const uint32 MortonKey = FMath::MortonCode2(static_cast<uint32>(TileX)) | (FMath::MortonCode2(static_cast<uint32>(TileY)) << 1);
+                const FIntPoint Min(TileX * TileSize, TileY * TileSize);
+                const FIntPoint Max(FMath::Min(Min.X + TileSize, Resolution.X), FMath::Min(Min.Y + TileSize, Resolution.Y));
+                Keyed.Emplace(MortonKey, FIntRect(Min, Max));
+            }
+        }
+
+        Keyed.Sort([](const TPair<uint32, FIntRect>& A, const TPair<uint32, FIntRect>& B) { return A.Key < B.Key; });
+
+        OutTiles.Reset(Keyed.Num());
+        for (const TPair<uint32, FIntRect>& Entry : Keyed)
+        {
+            OutTiles.Add(Entry.Value);
+        }
+    }
+
+    FORCEINLINE VectorRegister4Float EncodeOutput(const FCubemapEquirectCPUParams& Params, const VectorRegister4Float& Sample)
+    {
+        if (Params.bLinearGamma)
+        {
+            return Sample;
+        }
+
+        const VectorRegister4Float Encoded = VectorPow(VectorMin(VectorMax(Sample, VectorZeroFloat()), VectorOneFloat()), VectorSetFloat1(EncodeGamma));
+        return VectorSelect(MakeVectorRegisterFloatMask(0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0), Encoded, Sample);
+    }
+
+    void ConvertTileFromLUT(const FCubemapEquirectCPUParams& Params, const FIntRect& Tile, FLinearColor* OutPixels)
+    {
+        const uint32* Entries = Params.ProjectionLUT->GetEntries().GetData();
+
+        for (int32 Y = Tile.Min.Y; Y < Tile.Max.Y; ++Y)
+        {
+            const int64 RowOffset = static_cast<int64>(Y) * Params.OutputResolution.X;
+            for (int32 X = Tile.Min.X; X < Tile.Max.X; ++X)
+            {
+                FVector2f FaceUV;
+                int32 EyeIndex = 0;
+                const int32 Face = FPanoramaProjectionLUT::UnpackEntry(Entries[RowOffset + X], FaceUV, EyeIndex);
+                if (Face == FPanoramaProjectionLUT::UncoveredFace)
+                {
+                    OutPixels[RowOffset + X] = FLinearColor::Transparent;
+                    continue;
+                }
+
+                const VectorRegister4Float Sample = SampleBilinearVector(SelectEyeFaces(Params, EyeIndex)[Face], FaceUV);
+                VectorStore(EncodeOutput(Params, Sample), &OutPixels[RowOffset + X].R);
+            }
+        }
+    }
+
+    void ConvertTile(const FCubemapEquirectCPUParams& Params, const FEquirectAngleTables& Tables, const FIntRect& Tile, FLinearColor* OutPixels)
+    {
+        const VectorRegister4Float Half = VectorSetFloat1(0.5f);
+        const VectorRegister4Float MinMajorAxis = VectorSetFloat1(UE_SMALL_NUMBER);
+
+        alignas(16) float DirectionX[4];
+        alignas(16) float DirectionY[4];
+        alignas(16) float DirectionZ[4];
+        alignas(16) float FaceScale[4];
+
+        for (int32 Y = Tile.Min.Y; Y < Tile.Max.Y; ++Y)
+        {
+            const VectorRegister4Float CosTheta = VectorSetFloat1(Tables.CosTheta[Y]);
+            const VectorRegister4Float SinTheta = VectorSetFloat1(Tables.SinTheta[Y]);
+            FLinearColor* OutRow = OutPixels + static_cast<int64>(Y) * Params.OutputResolution.X;
+
+            for (int32 X = Tile.Min.X; X < Tile.Max.X; X += 4)
+            {
+                const VectorRegister4Float DirX = VectorMultiply(VectorLoad(Tables.CosPhi.GetData() + X), CosTheta);
+                const VectorRegister4Float DirZ = VectorMultiply(VectorLoad(Tables.SinPhi.GetData() + X), CosTheta);
+                const VectorRegister4Float MajorAxis = VectorMax(VectorMax(VectorAbs(DirX), VectorAbs(SinTheta)), VectorAbs(DirZ));
+                const VectorRegister4Float Scale = VectorDivide(Half, VectorMax(MajorAxis, MinMajorAxis));
+
+                VectorStoreAligned(DirX, DirectionX);
+                VectorStoreAligned(SinTheta, DirectionY);
+                VectorStoreAligned(DirZ, DirectionZ);
+                VectorStoreAligned(Scale, FaceScale);
+
+                const int32 LaneCount = FMath::Min(4, Tile.Max.X - X);
+                for (int32 Lane = 0; Lane < LaneCount; ++Lane)
+                {
+                    const int32 EyeIndex = FMath::Max<int32>(Tables.ColumnEye[X + Lane], Tables.RowEye[Y]);
+                    const FCubemapFaceImage* EyeFaces = SelectEyeFaces(Params, EyeIndex);
+
+                    FVector2f FaceUV;
+                    const FVector3f Direction(DirectionX[Lane], DirectionY[Lane], DirectionZ[Lane]);
+                    const int32 Face = PanoramaProjection::CubeFaceFromDirection(Direction, FaceScale[Lane], FaceUV);
+
+                    const VectorRegister4Float Sample = SampleBilinearVector(EyeFaces[Face], FaceUV);
+                    VectorStore(EncodeOutput(Params, Sample), &OutRow[X + Lane].R);
+                }
+            }
+        }
+    }
+}
+
+bool FCubemapEquirectCPU::Convert(const FCubemapEquirectCPUParams& Params, TArray<FLinearColor>& OutPixels)
+{
+    if (!ValidateParams(Params))
+    {
+        return false;
+    }
+
+    TArray<FIntRect> Tiles;
+    BuildTileOrder(Params.OutputResolution, Tiles);
+
+    OutPixels.SetNumUninitialized(Params.OutputResolution.X * Params.OutputResolution.Y);
+    FLinearColor* DestData = OutPixels.GetData();
+
+    // A table built for another stereo mode, layout or field of view carries the wrong eye bits and bands, so the whole key
+    // must match before a supplied table is trusted.
+    FPanoramaProjectionLUTKey ExpectedKey;
+    const bool bHasKey = MakeProjectionLUTKey(Params, ExpectedKey);
+    const bool bHasMatchingLUT = bHasKey && Params.ProjectionLUT && Params.ProjectionLUT->GetKey() == ExpectedKey;
+    if (bHasMatchingLUT || Params.Projection != EPanoramaProjection::Equirectangular)
+    {
+        FCubemapEquirectCPUParams LUTParams = Params;
+        TSharedPtr<FPanoramaProjectionLUT, ESPMode::ThreadSafe> TransientLUT;
+        if (!bHasMatchingLUT)
+        {
+            TransientLUT = FPanoramaProjectionLUT::Build(ExpectedKey);
+            LUTParams.ProjectionLUT = TransientLUT.Get();
+        }
+
+        ParallelFor(Tiles.Num(), [&LUTParams, &Tiles, DestData](int32 TileIndex)
+        {
+            ConvertTileFromLUT(LUTParams, Tiles[TileIndex], DestData);
+        });
+        return true;
+    }
+
+    FEquirectAngleTables Tables;
+    Tables.Build(Params);
+
+    ParallelFor(Tiles.Num(), [&Params, &Tables, &Tiles, DestData](int32 TileIndex)
+    {
+        ConvertTile(Params, Tables, Tiles[TileIndex], DestData);
+    });
+
+    return true;
+}
+
+bool FCubemapEquirectCPU::ConvertReference(const FCubemapEquirectCPUParams& Params, TArray<FLinearColor>& OutPixels)
+{
+    if (!ValidateParams(Params))
+    {
+        return false;
+    }
+
+    const FIntPoint Resolution = Params.OutputResolution;
+    OutPixels.SetNumUninitialized(Resolution.X * Resolution.Y);
+
+    for (int32 Y = 0; Y < Resolution.Y; ++Y)
+    {
+        for (int32 X = 0; X < Resolution.X; ++X)
+        {
+            const FVector2f OutputUV((X + 0.5f) / Resolution.X, (Y + 0.5f) / Resolution.Y);
+
+            FVector2f SampleUV;
+            const int32 EyeIndex = PanoramaProjection::ResolveStereoUV(OutputUV, Params.bStereo, Params.bStereoOverUnder, SampleUV);
+
+            FVector3f Direction;
+            if (Params.Projection == EPanoramaProjection::EquiAngularCubemap)
+            {
+                Direction = PanoramaProjection::DirectionFromEAC(SampleUV);
+            }
+            else if (Params.Projection == EPanoramaProjection::Domemaster)
+            {
+                if (!PanoramaProjection::DirectionFromFisheye(SampleUV, FMath::DegreesToRadians(Params.FieldOfView), Params.bFisheyeForward, Direction))
+                {
+                    OutPixels[Y * Resolution.X + X] = FLinearColor::Transparent;
+                    continue;
+                }
+            }
+            else
+            {
+                Direction = PanoramaProjection::DirectionFromEquirect(Params.LongitudeRange.X + SampleUV.X * Params.LongitudeRange.Y, Params.LatitudeRange.X + SampleUV.Y * Params.LatitudeRange.Y);
+            }
+
+            FVector2f FaceUV;
+            const int32 Face = PanoramaProjection::CubeFaceFromDirection(Direction, FaceUV);
+
+            FLinearColor Sample = SampleBilinearScalar(SelectEyeFaces(Params, EyeIndex)[Face], FaceUV);
+            if (!Params.bLinearGamma)
+            {
+                Sample.R = FMath::Pow(FMath::Clamp(Sample.R, 0.f, 1.f), EncodeGamma);
+                Sample.G = FMath::Pow(FMath::Clamp(Sample.G, 0.f, 1.f), EncodeGamma);
+                Sample.B = FMath::Pow(FMath::Clamp(Sample.B, 0.f, 1.f), EncodeGamma);
+            }
+
+            OutPixels[Y * Resolution.X + X] = Sample;
+        }
+    }
+
+    return true;
+}
+
+float FCubemapEquirectCPU::ComputeMaxError(TArrayView<const FLinearColor> A, TArrayView<const FLinearColor> B)
+{
+    if (A.Num() != B.Num())
+    {
+        return -1.f;
+    }
+
+    float MaxError = 0.f;
+    for (int32 Index = 0; Index < A.Num(); ++Index)
+    {
+        MaxError = FMath::Max(MaxError, FMath::Abs(A[Index].R - B[Index].R));
+        MaxError = FMath::Max(MaxError, FMath::Abs(A[Index].G - B[Index].G));
+        MaxError = FMath::Max(MaxError, FMath::Abs(A[Index].B - B[Index].B));
+        MaxError = FMath::Max(MaxError, FMath::Abs(A[Index].A - B[Index].A));
+    }
+    return MaxError;
+}
+
+void FCubemapEquirectCPU::QuantizeToPayload(TArrayView<const FLinearColor> Pixels, bool bIs16Bit, TArray<uint8>& OutPayload)
+{
+    const int32 ChannelCount = Pixels.Num() * 4;
+    const float* Source = Pixels.Num() > 0 ? &Pixels.GetData()->R : nullptr;
+
+    if (bIs16Bit)
+    {
+        OutPayload.SetNumUninitialized(ChannelCount * sizeof(uint16));
+        uint16* Dest = reinterpret_cast<uint16*>(OutPayload.GetData());
+        for (int32 Index = 0; Index < ChannelCount; ++Index)
+        {
+            Dest[Index] = static_cast<uint16>(FMath::Clamp<int32>(FMath::RoundToInt(Source[Index] * 65535.f), 0, 65535));
+        }
+    }
+    else
+    {
+        OutPayload.SetNumUninitialized(ChannelCount);
+        uint8* Dest = OutPayload.GetData();
+        for (int32 Index = 0; Index < ChannelCount; ++Index)
+        {
+            Dest[Index] = static_cast<uint8>(FMath::Clamp<int32>(FMath::RoundToInt(Source[Index] * 255.f), 0, 255));
+        }
+    }
+}
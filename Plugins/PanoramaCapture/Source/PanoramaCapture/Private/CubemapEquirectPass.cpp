@@ -2,6 +2,7 @@
 
 #include "GlobalShader.h"
 #include "PanoramaCaptureModule.h"
+#include "PanoramaCubeFaces.h"
 #include "RenderGraphBuilder.h"
 #include "RenderGraphUtils.h"
 #include "RenderGraphResources.h"
@@ -9,6 +10,10 @@
 #include "ShaderParameterUtils.h"
 #include "ShaderCompilerCore.h"
 #include "ComputeShaderUtils.h"
+#include "DataDrivenShaderPlatformInfo.h"
+#include "RenderGraphEvent.h"
+
+DECLARE_GPU_STAT_NAMED(PanoramaCubemapToEquirect, TEXT("Panorama Cubemap To Equirect"));
 
 class FCubemapToEquirectCS : public FGlobalShader
 {
@@ -16,54 +21,138 @@ public:
     DECLARE_GLOBAL_SHADER(FCubemapToEquirectCS);
     SHADER_USE_PARAMETER_STRUCT(FCubemapToEquirectCS, FGlobalShader);
 
+    /** 64 threads fill one wave64 or two wave32 waves exactly, on SM5 and SM6 hardware alike. */
+    static constexpr int32 ThreadGroupSize = 8;
+
+    /** EPanoramaResampleFilter. */
+    class FResampleFilterDim : SHADER_PERMUTATION_INT("PANORAMA_RESAMPLE_FILTER", 4);
+    /** Mono, over-under or side-by-side packing. */
+    class FStereoLayoutDim : SHADER_PERMUTATION_INT("PANORAMA_STEREO_LAYOUT", 3);
+    class FLinearOutputDim : SHADER_PERMUTATION_BOOL("PANORAMA_LINEAR_OUTPUT");
+    /** Per-pixel face and UV from FPanoramaProjectionLUT instead of evaluating the projection. */
+    class FProjectionLUTDim : SHADER_PERMUTATION_BOOL("PANORAMA_USE_PROJECTION_LUT");
+    using FPermutationDomain = TShaderPermutationDomain<FResampleFilterDim, FStereoLayoutDim, FLinearOutputDim, FProjectionLUTDim>;
+
+    static FPermutationDomain RemapPermutation(FPermutationDomain PermutationVector)
+    {
+        if (!FCubemapEquirectPass::FilterUsesProjectionLUT(static_cast<EPanoramaResampleFilter>(PermutationVector.Get<FResampleFilterDim>())))
+        {
+            PermutationVector.Set<FProjectionLUTDim>(false);
+        }
+        return PermutationVector;
+    }
+
     static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
     {
-        return Parameters.Platform == SP_PCD3D_SM5 || Parameters.Platform == SP_METAL_SM5 || Parameters.Platform == SP_VULKAN_SM5;
+        const FPermutationDomain PermutationVector(Parameters.PermutationId);
+        return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5) && RemapPermutation(PermutationVector) == PermutationVector;
     }
 
     static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
     {
         FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
-        OutEnvironment.SetDefine(TEXT("PANORAMA_LINEAR_GAMMA"), 1);
+        OutEnvironment.SetDefine(TEXT("THREADGROUP_SIZE"), ThreadGroupSize);
     }
 
     BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
         SHADER_PARAMETER(FVector2f, OutputResolution)
-        SHADER_PARAMETER(uint32, bStereo)
-        SHADER_PARAMETER(uint32, bLinear)
-        SHADER_PARAMETER(uint32, bStereoOverUnder)
-        SHADER_PARAMETER_RDG_TEXTURE(TextureCube, SourceTextureLeft)
-        SHADER_PARAMETER_RDG_TEXTURE(TextureCube, SourceTextureRight)
-        SHADER_PARAMETER_SAMPLER(SamplerState, SourceSampler)
+        SHADER_PARAMETER(FVector2f, LatitudeRange)
+        SHADER_PARAMETER(FVector2f, LongitudeRange)
+        SHADER_PARAMETER(uint32, SupersampleGrid)
+        SHADER_PARAMETER(FIntPoint, TileOffset)
+        SHADER_PARAMETER(float, AccumulationWeight)
+        SHADER_PARAMETER(FVector2f, PolarStereoFade)
+        SHADER_PARAMETER_STRUCT_INCLUDE(FPanoramaCubeFaceParameters, CubeFaces)
+        SHADER_PARAMETER_RDG_TEXTURE(Texture2D<uint>, ProjectionLUT)
         SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float4>, OutputTexture)
     END_SHADER_PARAMETER_STRUCT()
 };
 
 IMPLEMENT_GLOBAL_SHADER(FCubemapToEquirectCS, "/PanoramaCapture/Private/CubemapToEquirect.usf", "MainCS", SF_Compute);
 
+bool FCubemapEquirectPass::FilterUsesProjectionLUT(EPanoramaResampleFilter Filter)
+{
+    return Filter == EPanoramaResampleFilter::Bilinear || Filter == EPanoramaResampleFilter::Bicubic;
+}
+
+int32 FCubemapEquirectPass::VerifyShaderPermutations(EShaderPlatform ShaderPlatform)
+{
+    FGlobalShaderMap* GlobalShaderMap = GetGlobalShaderMap(ShaderPlatform);
+    if (!GlobalShaderMap)
+    {
+        UE_LOG(LogPanoramaCapture, Error, TEXT("No global shader map for %s."), *FDataDrivenShaderPlatformInfo::GetName(ShaderPlatform).ToString());
+        return FCubemapToEquirectCS::FPermutationDomain::PermutationCount;
+    }
+
+    int32 MissingCount = 0;
+    for (int32 PermutationId = 0; PermutationId < FCubemapToEquirectCS::FPermutationDomain::PermutationCount; ++PermutationId)
+    {
+        const FCubemapToEquirectCS::FPermutationDomain Requested(PermutationId);
+        const int32 RemappedId = FCubemapToEquirectCS::RemapPermutation(Requested).ToDimensionValueId();
+        if (!GlobalShaderMap->HasShader(&FCubemapToEquirectCS::GetStaticType(), RemappedId))
+        {
+            UE_LOG(LogPanoramaCapture, Error, TEXT("FCubemapToEquirectCS permutation %d (filter %d, stereo layout %d, linear %d, LUT %d) remaps to %d, which is not in the %s global shader map."),
+                PermutationId,
+                Requested.Get<FCubemapToEquirectCS::FResampleFilterDim>(),
+                Requested.Get<FCubemapToEquirectCS::FStereoLayoutDim>(),
+                Requested.Get<FCubemapToEquirectCS::FLinearOutputDim>() ? 1 : 0,
+                Requested.Get<FCubemapToEquirectCS::FProjectionLUTDim>() ? 1 : 0,
+                RemappedId,
+                *FDataDrivenShaderPlatformInfo::GetName(ShaderPlatform).ToString());
+            ++MissingCount;
+        }
+    }
+    return MissingCount;
+}
+
 void FCubemapEquirectPass::AddComputePass(FRDGBuilder& GraphBuilder, const FCubemapEquirectDispatchParams& Params)
 {
-    if (!Params.SourceCubemapLeft || !Params.DestinationEquirect)
+    if (!Params.Faces.IsValid() || !Params.DestinationEquirect)
     {
         return;
     }
 
     FCubemapToEquirectCS::FParameters* PassParameters = GraphBuilder.AllocParameters<FCubemapToEquirectCS::FParameters>();
-    PassParameters->SourceTextureLeft = Params.SourceCubemapLeft;
-    PassParameters->SourceTextureRight = Params.SourceCubemapRight ? Params.SourceCubemapRight : Params.SourceCubemapLeft;
-    PassParameters->SourceSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+    PanoramaCubeFaces::SetupParameters(GraphBuilder, Params.Faces, PassParameters->CubeFaces);
     PassParameters->OutputTexture = GraphBuilder.CreateUAV(Params.DestinationEquirect);
     PassParameters->OutputResolution = FVector2f(Params.OutputResolution);
-    PassParameters->bStereo = Params.bStereo ? 1u : 0u;
-    PassParameters->bLinear = Params.bLinearGamma ? 1u : 0u;
-    PassParameters->bStereoOverUnder = Params.bStereoOverUnder ? 1u : 0u;
+    PassParameters->LatitudeRange = Params.LatitudeRange;
+    PassParameters->LongitudeRange = Params.LongitudeRange;
+    PassParameters->SupersampleGrid = static_cast<uint32>(FMath::Clamp(Params.SupersampleGrid, 2, 4));
+    PassParameters->TileOffset = Params.TileOffset;
+    PassParameters->AccumulationWeight = FMath::Clamp(Params.AccumulationWeight, 0.f, 1.f);
+
+    // Polar faces first appear at the cube corners, sin(latitude) = 1/sqrt(3), so the fade completes there. A start past
+    // one never triggers.
+    PassParameters->PolarStereoFade = FVector2f(2.f, 0.f);
+    if (Params.bStereo && Params.PolarStereoFadeRadians > 0.f)
+    {
+        const float SinFadeEnd = 1.f / FMath::Sqrt(3.f);
+        const float SinFadeStart = FMath::Sin(FMath::Max(FMath::Asin(SinFadeEnd) - Params.PolarStereoFadeRadians, 0.f));
+        PassParameters->PolarStereoFade = FVector2f(SinFadeStart, 1.f / FMath::Max(SinFadeEnd - SinFadeStart, UE_KINDA_SMALL_NUMBER));
+    }
+
+    // Without the LUT permutation the table is compiled out, so nothing has to be bound in its place.
+    const bool bUseProjectionLUT = Params.ProjectionLUT && FilterUsesProjectionLUT(Params.Filter);
+    PassParameters->ProjectionLUT = bUseProjectionLUT ? Params.ProjectionLUT : nullptr;
+
+    const int32 StereoLayout = !Params.bStereo ? 0 : (Params.bStereoOverUnder ? 1 : 2);
 
-    TShaderMapRef<FCubemapToEquirectCS> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+    FCubemapToEquirectCS::FPermutationDomain PermutationVector;
+    PermutationVector.Set<FCubemapToEquirectCS::FResampleFilterDim>(static_cast<int32>(Params.Filter));
+    PermutationVector.Set<FCubemapToEquirectCS::FStereoLayoutDim>(StereoLayout);
+    PermutationVector.Set<FCubemapToEquirectCS::FLinearOutputDim>(Params.bLinearGamma);
+    PermutationVector.Set<FCubemapToEquirectCS::FProjectionLUTDim>(bUseProjectionLUT);
+    TShaderMapRef<FCubemapToEquirectCS> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel), FCubemapToEquirectCS::RemapPermutation(PermutationVector));
 
-    const FIntVector GroupCount(
-        FMath::DivideAndRoundUp(Params.OutputResolution.X, 8),
-        FMath::DivideAndRoundUp(Params.OutputResolution.Y, 8),
-        1);
+    const FIntPoint DispatchSize = (Params.TileSize.X > 0 && Params.TileSize.Y > 0) ? Params.TileSize : Params.OutputResolution;
+    const FIntVector GroupCount = FComputeShaderUtils::GetGroupCount(DispatchSize, FCubemapToEquirectCS::ThreadGroupSize);
 
-    FComputeShaderUtils::AddPass(GraphBuilder, RDG_EVENT_NAME("Panorama::CubemapToEquirect"), ComputeShader, PassParameters, GroupCount);
+    RDG_GPU_STAT_SCOPE(GraphBuilder, PanoramaCubemapToEquirect);
+    FComputeShaderUtils::AddPass(
+        GraphBuilder,
+        RDG_EVENT_NAME("Panorama::CubemapToEquirect(%s %dx%d)", *UEnum::GetValueAsString(Params.Filter), DispatchSize.X, DispatchSize.Y),
+        ComputeShader,
+        PassParameters,
+        GroupCount);
 }
@@ -0,0 +1,75 @@
+#include "CubemapFisheyePass.h"
+
+#include "GlobalShader.h"
+#include "PanoramaCaptureModule.h"
+#include "PanoramaCubeFaces.h"
+#include "RenderGraphBuilder.h"
+#include "RenderGraphUtils.h"
+#include "RenderGraphResources.h"
+#include "ShaderParameterStruct.h"
+#include "ShaderParameterUtils.h"
+#include "ShaderCompilerCore.h"
+#include "ComputeShaderUtils.h"
+
+class FCubemapToFisheyeCS : public FGlobalShader
+{
+public:
+    DECLARE_GLOBAL_SHADER(FCubemapToFisheyeCS);
+    SHADER_USE_PARAMETER_STRUCT(FCubemapToFisheyeCS, FGlobalShader);
+
+    static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+    {
+        return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+    }
+
+    BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+        SHADER_PARAMETER(FVector2f, OutputResolution)
+        SHADER_PARAMETER(float, FieldOfView)
+        SHADER_PARAMETER(uint32, bForward)
+        SHADER_PARAMETER(uint32, bStereo)
+        SHADER_PARAMETER(uint32, bLinear)
+        SHADER_PARAMETER(uint32, bStereoOverUnder)
+        SHADER_PARAMETER(uint32, bUseProjectionLUT)
+        SHADER_PARAMETER_STRUCT_INCLUDE(FPanoramaCubeFaceParameters, CubeFaces)
+        SHADER_PARAMETER_RDG_TEXTURE(Texture2D<uint>, ProjectionLUT)
+        SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float4>, OutputTexture)
+    END_SHADER_PARAMETER_STRUCT()
+};
+
+IMPLEMENT_GLOBAL_SHADER(FCubemapToFisheyeCS, "/PanoramaCapture/Private/CubemapToFisheye.usf", "MainCS", SF_Compute);
+
+void FCubemapFisheyePass::AddComputePass(FRDGBuilder& GraphBuilder, const FCubemapEquirectDispatchParams& Params)
+{
+    if (!Params.Faces.IsValid() || !Params.DestinationEquirect)
+    {
+        return;
+    }
+
+    FCubemapToFisheyeCS::FParameters* PassParameters = GraphBuilder.AllocParameters<FCubemapToFisheyeCS::FParameters>();
+    PanoramaCubeFaces::SetupParameters(GraphBuilder, Params.Faces, PassParameters->CubeFaces);
+    PassParameters->OutputTexture = GraphBuilder.CreateUAV(Params.DestinationEquirect);
+    PassParameters->OutputResolution = FVector2f(Params.OutputResolution);
+    PassParameters->FieldOfView = Params.FieldOfViewRadians;
+    PassParameters->bForward = Params.bFisheyeForward ? 1u : 0u;
+    PassParameters->bStereo = Params.bStereo ? 1u : 0u;
+    PassParameters->bLinear = Params.bLinearGamma ? 1u : 0u;
+    PassParameters->bStereoOverUnder = Params.bStereoOverUnder ? 1u : 0u;
+    PassParameters->bUseProjectionLUT = Params.ProjectionLUT ? 1u : 0u;
+
+    FRDGTextureRef ProjectionLUT = Params.ProjectionLUT;
+    if (!ProjectionLUT)
+    {
+        ProjectionLUT = GraphBuilder.CreateTexture(FRDGTextureDesc::Create2D(FIntPoint(1, 1), PF_R32_UINT, FClearValueBinding::Black, TexCreate_ShaderResource | TexCreate_UAV), TEXT("PanoramaProjectionLUTDummy"));
+        AddClearUAVPass(GraphBuilder, GraphBuilder.CreateUAV(ProjectionLUT), 0u);
+    }
+    PassParameters->ProjectionLUT = ProjectionLUT;
+
+    TShaderMapRef<FCubemapToFisheyeCS> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+
+    const FIntVector GroupCount(
+        FMath::DivideAndRoundUp(Params.OutputResolution.X, 8),
+        FMath::DivideAndRoundUp(Params.OutputResolution.Y, 8),
+        1);
+
+    FComputeShaderUtils::AddPass(GraphBuilder, RDG_EVENT_NAME("Panorama::CubemapToFisheye"), ComputeShader, PassParameters, GroupCount);
+}
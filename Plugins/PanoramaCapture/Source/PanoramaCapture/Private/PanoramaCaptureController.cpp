@@ -4,7 +4,9 @@
 #include "AudioMixerBlueprintLibrary.h"
 #include "CaptureOutputSettings.h"
 #include "CubemapCaptureRigComponent.h"
+#include "CubemapEACPass.h"
 #include "CubemapEquirectPass.h"
+#include "CubemapFisheyePass.h"
 #include "Containers/StringBuilder.h"
 #include "Engine/Texture2D.h"
 #include "Engine/TextureRenderTarget2D.h"
@@ -21,12 +23,25 @@
 #include "Misc/Paths.h"
 #include "Modules/ModuleManager.h"
 #include "PanoramaCaptureModule.h"
+#include "PanoramaColorGradePass.h"
+#include "PanoramaCubeFaces.h"
+#include "PanoramaDepthCompositePass.h"
+#include "PanoramaODSStitchPass.h"
+#include "PanoramaOutputLayout.h"
+#include "PanoramaPreviewDownscale.h"
+#include "PanoramaPreviewPass.h"
+#include "PanoramaProjectionLUT.h"
+#include "PanoramaStillWriter.h"
+#include "PanoramaTiledStill.h"
+#include "PanoramaYUVConvertPass.h"
 #include "ComputeShaderUtils.h"
 #include "GlobalShader.h"
 #include "RenderGraphBuilder.h"
 #include "RenderGraphResources.h"
 #include "RenderGraphUtils.h"
+#include "RenderCore.h"
 #include "RenderTargetPool.h"
+#include "RHI.h"
 #include "RHICommandList.h"
 #include "RHIResources.h"
 #include "RenderingThread.h"
@@ -38,10 +53,17 @@
 #include "TextureResource.h"
 #include "UObject/Package.h"
 
+#include <atomic>
+
 namespace
 {
     constexpr int32 FacesPerEye = 6;
 
+    /** Engine frames after a backend switch that BenchmarkCaptureBackends does not sample; the RHI reports GPU time late. */
+    constexpr int32 BackendBenchmarkSettleFrames = 4;
+
+    TArray<TWeakObjectPtr<UPanoramaCaptureController>> GActivePanoramaControllers;
+
     FString SanitizeFileComponent(const FString& Input)
     {
         FString Result = Input;
@@ -68,7 +90,7 @@ namespace
         static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
         {
 #if PLATFORM_WINDOWS
-            return Parameters.Platform == SP_PCD3D_SM5;
+            return Parameters.Platform == SP_PCD3D_SM5 || Parameters.Platform == SP_PCD3D_SM6;
 #else
             return false;
 #endif
@@ -85,14 +107,15 @@ namespace
 class FPendingCapturePayload : public TSharedFromThis<FPendingCapturePayload, ESPMode::ThreadSafe>
     {
     public:
-        FPendingCapturePayload(const FCaptureOutputSettings& InSettings, FIntPoint InResolution, double InTimeSeconds, int32 InFrameIndex, const FString& InOutputFile, bool bInPreviewOnly)
+        FPendingCapturePayload(const FCaptureOutputSettings& InSettings, FIntPoint InResolution, double InTimeSeconds, int32 InFrameIndex, const FString& InOutputFile, bool bInPreviewOnly, TSharedPtr<FRHIGPUTextureReadback, ESPMode::ThreadSafe> InReadback, bool bInDiscard)
             : Settings(InSettings)
             , Resolution(InResolution)
             , TimeSeconds(InTimeSeconds)
             , FrameIndex(InFrameIndex)
             , OutputFile(InOutputFile)
-            , Readback(MakeUnique<FRHIGPUTextureReadback>(TEXT("PanoramaCaptureReadback")))
+            , Readback(MoveTemp(InReadback))
             , bPreviewOnly(bInPreviewOnly)
+            , bDiscard(bInDiscard)
         {
         }
 
@@ -101,12 +124,30 @@ class FPendingCapturePayload : public TSharedFromThis<FPendingCapturePayload, ES
             return Readback.Get();
         }
 
+        /** Called on the render thread once the copy is recorded; a pooled readback still reports its previous copy as ready until then. */
+        void MarkCopySubmitted()
+        {
+            bCopySubmitted = true;
+        }
+
         bool IsReady() const
         {
-            return Readback && Readback->IsReady();
+            return bCopySubmitted && Readback && Readback->IsReady();
         }
 
-        FPanoramaCaptureFrame Resolve()
+        /** Hands the readback back for reuse once resolved or discarded. */
+        TSharedPtr<FRHIGPUTextureReadback, ESPMode::ThreadSafe> ReleaseReadback()
+        {
+            return MoveTemp(Readback);
+        }
+
+        /** Warmup frames only prime the copy and staging; their pixels are never resolved. */
+        bool IsDiscarded() const
+        {
+            return bDiscard;
+        }
+
+        FPanoramaCaptureFrame Resolve(FCapturePayloadPool& PayloadPool)
         {
             check(IsReady());
 
@@ -114,8 +155,8 @@ class FPendingCapturePayload : public TSharedFromThis<FPendingCapturePayload, ES
             const int32 Height = Resolution.Y;
             const bool bUse16BitPNG = Settings.bUse16BitPNG;
 
-            TArray<uint8> Payload;
-            Payload.SetNumUninitialized(Width * Height * (bUse16BitPNG ? sizeof(uint16) * 4 : 4));
+            TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe> PayloadBuffer = PayloadPool.Acquire(Width * Height * (bUse16BitPNG ? sizeof(uint16) * 4 : 4));
+            TArray<uint8>& Payload = *PayloadBuffer;
 
             int32 RowPitch = 0;
             const uint8* SourceData = static_cast<const uint8*>(Readback->Lock(RowPitch));
@@ -156,9 +197,10 @@ class FPendingCapturePayload : public TSharedFromThis<FPendingCapturePayload, ES
             }
 
             Readback->Unlock();
-            Readback.Reset();
 
-            return FPanoramaCaptureFrame(Resolution, TimeSeconds, FrameIndex, OutputFile, bUse16BitPNG, MoveTemp(Payload));
+            FPanoramaCaptureFrame Frame(Resolution, TimeSeconds, FrameIndex, OutputFile, bUse16BitPNG, MoveTemp(PayloadBuffer));
+            Frame.Projection = Settings.Projection;
+            return Frame;
         }
 
         bool IsPreviewOnly() const
@@ -166,14 +208,21 @@ class FPendingCapturePayload : public TSharedFromThis<FPendingCapturePayload, ES
             return bPreviewOnly;
         }
 
+        const FIntPoint& GetResolution() const
+        {
+            return Resolution;
+        }
+
     private:
         FCaptureOutputSettings Settings;
         FIntPoint Resolution;
         double TimeSeconds;
         int32 FrameIndex;
         FString OutputFile;
-        TUniquePtr<FRHIGPUTextureReadback> Readback;
+        TSharedPtr<FRHIGPUTextureReadback, ESPMode::ThreadSafe> Readback;
         bool bPreviewOnly;
+        bool bDiscard;
+        std::atomic<bool> bCopySubmitted { false };
     };
 }
 
@@ -188,11 +237,59 @@ UPanoramaCaptureController::UPanoramaCaptureController()
     , CurrentStatus(TEXT("Idle"))
     , LastStatusUpdateSeconds(0.0)
     , AudioCaptureStartSeconds(0.0)
+    , ElidedFrameCount(0)
+    , bGovernResolution(false)
+    , GovernorPeakGPUMilliseconds(0.f)
+    , GovernorLostFrames(0)
+    , bWarmingUp(false)
+    , ReadbackPoolResolution(FIntPoint::ZeroValue)
+    , LastPreviewRefreshSeconds(0.0)
+    , bPreviewTaskInFlight(false)
+    , PayloadPool(MakeShared<FCapturePayloadPool, ESPMode::ThreadSafe>())
 {
     PrimaryComponentTick.bCanEverTick = true;
     PrimaryComponentTick.TickGroup = TG_PostUpdateWork;
 }
 
+const TArray<TWeakObjectPtr<UPanoramaCaptureController>>& UPanoramaCaptureController::GetActiveControllers()
+{
+    return GActivePanoramaControllers;
+}
+
+FOnPanoramaPreviewUpdated& UPanoramaCaptureController::OnPreviewUpdated()
+{
+    static FOnPanoramaPreviewUpdated PreviewUpdatedDelegate;
+    return PreviewUpdatedDelegate;
+}
+
+FOnPanoramaControllersChanged& UPanoramaCaptureController::OnControllersChanged()
+{
+    static FOnPanoramaControllersChanged ControllersChangedDelegate;
+    return ControllersChangedDelegate;
+}
+
+void UPanoramaCaptureController::OnRegister()
+{
+    Super::OnRegister();
+
+    if (!IsTemplate() && GetWorld() && !GetWorld()->IsPreviewWorld())
+    {
+        GActivePanoramaControllers.AddUnique(this);
+        OnControllersChanged().Broadcast();
+    }
+}
+
+void UPanoramaCaptureController::OnUnregister()
+{
+    if (GActivePanoramaControllers.Remove(this) > 0)
+    {
+        GActivePanoramaControllers.RemoveAll([](const TWeakObjectPtr<UPanoramaCaptureController>& Controller) { return !Controller.IsValid(); });
+        OnControllersChanged().Broadcast();
+    }
+
+    Super::OnUnregister();
+}
+
 void UPanoramaCaptureController::BeginPlay()
 {
     Super::BeginPlay();
@@ -203,6 +300,7 @@ void UPanoramaCaptureController::BeginPlay()
 void UPanoramaCaptureController::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
     StopCapture();
+    ActiveStill.Reset();
     Super::EndPlay(EndPlayReason);
 }
 
@@ -210,10 +308,33 @@ void UPanoramaCaptureController::TickComponent(float DeltaTime, ELevelTick TickT
 {
     Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
+    if (bIsCapturing && bGovernResolution)
+    {
+        // The capture timer can fire less often than the engine ticks; the heaviest frame is the one that rendered the faces.
+        GovernorPeakGPUMilliseconds = FMath::Max(GovernorPeakGPUMilliseconds, static_cast<float>(FPlatformTime::ToMilliseconds(RHIGetGPUFrameCycles())));
+    }
+
+    if (bIsCapturing && BackendBenchmark.IsSet())
+    {
+        TickBackendBenchmark();
+    }
+
+    // Time slices run every engine frame, not only on capture ticks, so each output frame stitches the latest faces.
+    if (bIsCapturing && ManagedRig && ManagedRig->IsTimeSlicingActive())
+    {
+        ManagedRig->TickRig(DeltaTime);
+    }
+
     if (bIsCapturing || PendingReadbacks.Num() > 0)
     {
         ConsumeFrameQueue();
     }
+
+    if (ActiveStill.IsValid() && ActiveStill->Tick() != FPanoramaTiledStill::EState::Rendering)
+    {
+        ActiveStill.Reset();
+        UpdateStatus(TEXT("Idle"));
+    }
 }
 
 void UPanoramaCaptureController::StartCapture()
@@ -232,24 +353,33 @@ void UPanoramaCaptureController::StartCapture()
         return;
     }
 
-    FrameBuffer.Clear();
+    if (ActiveStill.IsValid())
+    {
+        UE_LOG(LogPanoramaCapture, Warning, TEXT("Cannot start capture while a tiled still is being written."));
+        return;
+    }
+
     PendingReadbacks.Reset();
     CapturedFrameFiles.Reset();
     CapturedFrameTimes.Reset();
+    LastWrittenFingerprint = FCaptureFrameFingerprint();
+    LastElidedFrameTime.Reset();
+    ElidedFrameCount = 0;
     FirstVideoTimestamp.Reset();
     LastVideoTimestamp.Reset();
     AudioCaptureStartSeconds = 0.0;
     RecordedAudioFile.Reset();
     PendingWriteTasks.Reset();
+    FingerprintedFrames.Reset();
     ActiveElementaryStream.Reset();
 
-    InitializeOutputDirectory();
-    InitializeRingBuffer();
-
-    CaptureFrameCounter = 0;
-    LastStatusUpdateSeconds = GetWorld() ? GetWorld()->GetTimeSeconds() : 0.0;
+    // Preparing can fail, so it runs before anything is created on disk or in the encoder.
+    if (!IsCapturePrepared() && !PrepareCapture())
+    {
+        return;
+    }
 
-    CaptureStartSeconds = GetWorld() ? GetWorld()->GetTimeSeconds() : FPlatformTime::Seconds();
+    InitializeOutputDirectory();
 
 #if WITH_PANORAMA_NVENC
     if (OutputSettings.OutputPath == ECaptureOutputPath::NVENCVideo)
@@ -262,7 +392,7 @@ void UPanoramaCaptureController::StartCapture()
         }
         else
         {
-            const FIntPoint OutputResolution(OutputSettings.Resolution.Width, OutputSettings.Resolution.Height);
+            const FIntPoint OutputResolution = FPanoramaOutputLayout::GetOutputResolution(OutputSettings);
             const FString ElementaryExtension = (OutputSettings.NVENC.Codec == ENVENCCodec::HEVC) ? TEXT("h265") : TEXT("h264");
             ActiveElementaryStream = BuildVideoFilePath(ElementaryExtension);
 
@@ -292,20 +422,213 @@ void UPanoramaCaptureController::StartCapture()
     }
 #endif
 
+    // A fallback to PNG only changes the output path: the warmup already compiled every pass and InitializeRingBuffer below
+    // sizes the payloads for the new path, so the preparation is carried over rather than rendered again.
+    if (PreparedSettings.IsSet())
+    {
+        PreparedSettings->OutputPath = OutputSettings.OutputPath;
+    }
+
+    InitializeRingBuffer();
+
+    CaptureFrameCounter = 0;
+    LastStatusUpdateSeconds = GetWorld() ? GetWorld()->GetTimeSeconds() : 0.0;
+
+    CaptureStartSeconds = GetWorld() ? GetWorld()->GetTimeSeconds() : FPlatformTime::Seconds();
+
     if (OutputSettings.bRecordAudio)
     {
         InitializeAudioCapture();
     }
 
-    ManagedRig->OutputSettings = OutputSettings;
-    ManagedRig->bStereo = (OutputSettings.StereoMode != EPanoramaStereoMode::Mono);
+    ResolutionGovernor.Reset(OutputSettings.ResolutionGovernor, OutputSettings.FrameRate);
+    bGovernResolution = OutputSettings.ResolutionGovernor.bEnabled && !ManagedRig->IsODSActive();
+    GovernorPeakGPUMilliseconds = 0.f;
+    GovernorLostFrames = 0;
+    // A governed previous take may have left the faces at a smaller level.
+    ManagedRig->SetResolutionScale(bGovernResolution ? ResolutionGovernor.GetScale() : 1.f);
+    // PreparedSettings only covers OutputSettings, while the rig's clip planes and Faces may have been edited since. Targets
+    // that still match are kept, so this reallocates nothing unless those edits resized a face.
     ManagedRig->InitializeRig();
 
+    const FIntPoint OutputResolution = FPanoramaOutputLayout::GetOutputResolution(OutputSettings);
+    if (ManagedRig->IsODSActive())
+    {
+        const FIntPoint SliceSize = UCubemapCaptureRigComponent::ComputeODSSliceSize(OutputSettings);
+        UE_LOG(LogPanoramaCapture, Log, TEXT("Capturing %dx%d ODS from %d slices of %dx%d in %d batches: %.1f MB of slice targets, %.1f MP rendered per frame."),
+            OutputResolution.X, OutputResolution.Y, ManagedRig->GetODSSliceCount(), SliceSize.X, SliceSize.Y, ManagedRig->GetODSBatchCount(),
+            ManagedRig->GetFaceMemoryBytes() / (1024.0 * 1024.0), ManagedRig->GetRenderedPixelsPerFrame() / 1000000.0);
+    }
+    else
+    {
+        UE_LOG(LogPanoramaCapture, Log, TEXT("Capturing %dx%d from %d of 6 %dx%d cube faces: %.1f MB of face targets, %.1f MP rendered per frame."),
+            OutputResolution.X, OutputResolution.Y, ManagedRig->GetActiveFaceCount(), ManagedRig->GetFaceSize(), ManagedRig->GetFaceSize(),
+            ManagedRig->GetFaceMemoryBytes() / (1024.0 * 1024.0), ManagedRig->GetRenderedPixelsPerFrame() / 1000000.0);
+        if (ManagedRig->IsTimeSlicingActive())
+        {
+            UE_LOG(LogPanoramaCapture, Log, TEXT("Time slicing face captures: %d per engine frame, none older than %d frames."),
+                FMath::Max(1, OutputSettings.TimeSlicing.FacesPerFrame), FMath::Max(0, OutputSettings.TimeSlicing.MaxStaleFrames));
+        }
+        if (bGovernResolution)
+        {
+            UE_LOG(LogPanoramaCapture, Log, TEXT("Resolution governor: %d face scale levels from %.2f to %.2f against a %.1f ms GPU budget."),
+                ResolutionGovernor.GetScaleLevels().Num(), ResolutionGovernor.GetScale(), ResolutionGovernor.GetScaleLevels().Last(), ResolutionGovernor.GetBudgetMilliseconds());
+        }
+    }
+
     const float Interval = 1.0f / FMath::Max(1, OutputSettings.FrameRate);
     bIsCapturing = true;
     UpdateStatus(TEXT("Recording"));
 
     GetWorld()->GetTimerManager().SetTimer(CaptureTimerHandle, this, &UPanoramaCaptureController::CaptureFrame, Interval, true);
+    OnControllersChanged().Broadcast();
+}
+
+bool UPanoramaCaptureController::PrepareCapture()
+{
+    if (bIsCapturing || ActiveStill.IsValid())
+    {
+        UE_LOG(LogPanoramaCapture, Warning, TEXT("Cannot prepare a capture while a sequence or still is recording."));
+        return false;
+    }
+
+    EnsureRig();
+    EnsureStatusDisplay();
+
+    if (!ManagedRig)
+    {
+        UE_LOG(LogPanoramaCapture, Warning, TEXT("Cannot prepare capture without a cubemap rig component."));
+        return false;
+    }
+
+    const double PrepareStartSeconds = FPlatformTime::Seconds();
+    PreparedSettings.Reset();
+    UpdateStatus(TEXT("Preparing"));
+
+    InitializeRingBuffer();
+
+    // Targets that already match are kept, so preparing again after a take only allocates what the settings changed.
+    ManagedRig->OutputSettings = OutputSettings;
+    ManagedRig->bStereo = (OutputSettings.StereoMode != EPanoramaStereoMode::Mono);
+    // Every scale the governor may pick gets its targets now, so recording never reallocates them.
+    ResolutionGovernor.Reset(OutputSettings.ResolutionGovernor, OutputSettings.FrameRate);
+    if (OutputSettings.ResolutionGovernor.bEnabled)
+    {
+        ManagedRig->SetResolutionScaleLevels(ResolutionGovernor.GetScaleLevels());
+    }
+    else
+    {
+        ManagedRig->SetResolutionScaleLevels({ 1.f });
+    }
+    // A tiled still may have left the rig rendering face regions instead of whole faces.
+    ManagedRig->SetRegionCapture(false);
+    ManagedRig->InitializeRig();
+
+    const FIntPoint OutputResolution = FPanoramaOutputLayout::GetOutputResolution(OutputSettings);
+    const bool bODS = ManagedRig->IsODSActive();
+    if (!bODS)
+    {
+        ODSAccumulation.Reset();
+    }
+    else if (!ODSAccumulation.IsValid())
+    {
+        ODSAccumulation = MakeShared<FPanoramaODSAccumulation, ESPMode::ThreadSafe>();
+    }
+    ActiveColorGradingLUT = UCubemapCaptureRigComponent::CapturesSceneLinear(OutputSettings) ? OutputSettings.ColorGrading.ColorGradingLUT.LoadSynchronous() : nullptr;
+
+    ActiveProjectionLUT.Reset();
+    // The multi-tap equirect filters project sub-pixel positions themselves, so a table would only cost memory. ODS never samples cube faces.
+    const bool bProjectionTakesLUT = !bODS && (OutputSettings.Projection != EPanoramaProjection::Equirectangular || FCubemapEquirectPass::FilterUsesProjectionLUT(OutputSettings.ResampleFilter));
+    if (OutputSettings.bUseProjectionLUT && bProjectionTakesLUT)
+    {
+        ActiveProjectionLUT = FPanoramaProjectionLUTCache::Get().FindOrBuild(FPanoramaProjectionLUTKey::FromSettings(OutputSettings), OutputSettings.bPersistProjectionLUT);
+    }
+
+    if (UsesGPUPreview())
+    {
+        EnsurePreviewRenderTarget(OutputResolution);
+    }
+
+    if (ReadbackPoolResolution != OutputResolution)
+    {
+        ReadbackPool.Reset();
+        ReadbackPoolResolution = OutputResolution;
+    }
+
+    // Warmup frames take every pass the recording will: shaders and PSOs compile, the RDG pool fills and each readback
+    // allocates its staging, all before the first recorded frame. Their readbacks then seed ReadbackPool.
+    const int32 WarmupFrames = FMath::Clamp(OutputSettings.WarmupFrames, 0, 30);
+    if (WarmupFrames > 0)
+    {
+        bWarmingUp = true;
+        for (int32 FrameIndex = 0; FrameIndex < WarmupFrames; ++FrameIndex)
+        {
+            CaptureFrame();
+        }
+        bWarmingUp = false;
+
+        FlushRenderingCommands();
+        const double WaitStart = FPlatformTime::Seconds();
+        while (PendingReadbacks.Num() > 0 && FPlatformTime::Seconds() - WaitStart < 5.0)
+        {
+            ProcessPendingReadbacks();
+            if (PendingReadbacks.Num() > 0)
+            {
+                FPlatformProcess::Sleep(0.001f);
+            }
+        }
+        PendingReadbacks.Reset();
+    }
+
+    PreparedSettings = OutputSettings;
+    UE_LOG(LogPanoramaCapture, Log, TEXT("Capture pipeline ready after %d warmup frames in %.1f ms; %d pooled readbacks."),
+        WarmupFrames, (FPlatformTime::Seconds() - PrepareStartSeconds) * 1000.0, ReadbackPool.Num());
+    UpdateStatus(TEXT("Ready"));
+    return true;
+}
+
+bool UPanoramaCaptureController::IsCapturePrepared() const
+{
+    return ManagedRig && PreparedSettings.IsSet()
+        && FCaptureOutputSettings::StaticStruct()->CompareScriptStruct(&PreparedSettings.GetValue(), &OutputSettings, PPF_None);
+}
+
+void UPanoramaCaptureController::ReleaseCaptureResources()
+{
+    if (bIsCapturing)
+    {
+        UE_LOG(LogPanoramaCapture, Warning, TEXT("Cannot release capture resources while a sequence is recording."));
+        return;
+    }
+
+    PreparedSettings.Reset();
+    if (ManagedRig)
+    {
+        ManagedRig->ReleaseRig();
+    }
+    FrameBuffer.Clear();
+    PayloadPool->Empty();
+    PendingReadbacks.Reset();
+    ReadbackPool.Reset();
+    ReadbackPoolResolution = FIntPoint::ZeroValue;
+    ODSAccumulation.Reset();
+    ActiveProjectionLUT.Reset();
+    ActiveColorGradingLUT = nullptr;
+}
+
+TSharedPtr<FRHIGPUTextureReadback, ESPMode::ThreadSafe> UPanoramaCaptureController::AcquireReadback(const FIntPoint& OutputResolution)
+{
+    if (ReadbackPoolResolution != OutputResolution)
+    {
+        ReadbackPool.Reset();
+        ReadbackPoolResolution = OutputResolution;
+    }
+
+    if (ReadbackPool.Num() > 0)
+    {
+        return ReadbackPool.Pop(false);
+    }
+    return MakeShared<FRHIGPUTextureReadback, ESPMode::ThreadSafe>(TEXT("PanoramaCaptureReadback"));
 }
 
 void UPanoramaCaptureController::StopCapture()
@@ -317,6 +640,10 @@ void UPanoramaCaptureController::StopCapture()
 
     bIsCapturing = false;
     GetWorld()->GetTimerManager().ClearTimer(CaptureTimerHandle);
+    if (BackendBenchmark.IsSet())
+    {
+        FinishBackendBenchmark();
+    }
 
     ShutdownAudioCapture();
 
@@ -360,6 +687,54 @@ void UPanoramaCaptureController::StopCapture()
     PendingReadbacks.Reset();
 
     UpdateStatus(TEXT("Idle"));
+    OnControllersChanged().Broadcast();
+}
+
+bool UPanoramaCaptureController::CaptureTiledStill(const FString& OutputFile)
+{
+    if (bIsCapturing || ActiveStill.IsValid())
+    {
+        UE_LOG(LogPanoramaCapture, Warning, TEXT("Cannot capture a tiled still while a sequence or another still is recording."));
+        return false;
+    }
+
+    EnsureRig();
+    if (!ManagedRig)
+    {
+        UE_LOG(LogPanoramaCapture, Warning, TEXT("Cannot capture a still without a cubemap rig component."));
+        return false;
+    }
+
+    FString StillFile = OutputFile;
+    if (StillFile.IsEmpty())
+    {
+        InitializeOutputDirectory();
+        StillFile = BuildVideoFilePath(IPanoramaStillWriter::GetFileExtension(OutputSettings.Still.Format));
+    }
+
+    // EXR keeps the scene-linear range, so its faces need float targets whatever the PNG bit depth says.
+    ManagedRig->OutputSettings = OutputSettings;
+    ManagedRig->OutputSettings.bUse16BitPNG |= (OutputSettings.Still.Format == EPanoramaStillFormat::EXR);
+    // Tiles are converted from cube face regions: ODS slices are only stitched whole and the far-field split is composited per
+    // frame.
+    ManagedRig->OutputSettings.StereoCapture = EPanoramaStereoCapture::OffsetCubemaps;
+    ManagedRig->OutputSettings.TimeSlicing.bEnabled = false;
+    // The still reconfigures the rig, so the next recording prepares it again.
+    PreparedSettings.Reset();
+    ManagedRig->bStereo = (OutputSettings.StereoMode != EPanoramaStereoMode::Mono);
+    ManagedRig->SetResolutionScaleLevels({ 1.f });
+    // Each tile renders only the face regions it samples, so no full-size face target is allocated.
+    ManagedRig->SetRegionCapture(true);
+    ManagedRig->InitializeRig();
+
+    ActiveStill = FPanoramaTiledStill::Begin(*ManagedRig, OutputSettings, StillFile);
+    if (!ActiveStill.IsValid())
+    {
+        return false;
+    }
+
+    UpdateStatus(TEXT("Still"));
+    return true;
 }
 
 void UPanoramaCaptureController::EnsureRig()
@@ -420,15 +795,34 @@ void UPanoramaCaptureController::CaptureFrame()
         return;
     }
 
-    ManagedRig->TickRig(0.0f);
+    if (bWarmingUp)
+    {
+        // Every warmup frame renders all faces; time slicing would spend the whole warmup on one engine frame's slice.
+        ManagedRig->CaptureFaces(ManagedRig->GetActiveFaceMask());
+    }
+    else
+    {
+        if (bGovernResolution)
+        {
+            UpdateResolutionGovernor();
+        }
+
+        ManagedRig->TickRig(0.0f);
+    }
 
     const double Now = GetWorld()->GetTimeSeconds() - CaptureStartSeconds;
-    const FIntPoint OutputResolution(OutputSettings.Resolution.Width, OutputSettings.Resolution.Height);
+    const FIntPoint OutputResolution = FPanoramaOutputLayout::GetOutputResolution(OutputSettings);
+    const EEquiLayout EffectiveLayout = FPanoramaOutputLayout::GetEffectiveLayout(OutputSettings);
+    const FVector2f LatitudeRange = FPanoramaOutputLayout::GetLatitudeRange(EffectiveLayout);
+    const FVector2f LongitudeRange = FPanoramaOutputLayout::GetLongitudeRange(EffectiveLayout);
     const bool bStereo = (OutputSettings.StereoMode != EPanoramaStereoMode::Mono);
     const bool bOverUnder = (OutputSettings.StereoMode == EPanoramaStereoMode::StereoOverUnder);
     const bool bLinearGamma = (OutputSettings.GammaSpace == EPanoramaGammaSpace::Linear);
 
-    const bool bNeedsReadback = (OutputSettings.OutputPath == ECaptureOutputPath::PNGSequence) || OutputSettings.bEnablePreview;
+    // Warmup frames read back whenever the recording will, but never publish a preview or advance the take.
+    const bool bPreviewDue = !bWarmingUp && IsPreviewRefreshDue();
+    const bool bPreviewReadback = (OutputSettings.OutputPath != ECaptureOutputPath::PNGSequence) && !UsesGPUPreview() && (bWarmingUp ? OutputSettings.bEnablePreview : bPreviewDue);
+    const bool bNeedsReadback = (OutputSettings.OutputPath == ECaptureOutputPath::PNGSequence) || bPreviewReadback;
     FString FrameOutputFile;
     TSharedPtr<FPendingCapturePayload, ESPMode::ThreadSafe> PendingPayload;
     if (bNeedsReadback)
@@ -438,121 +832,227 @@ void UPanoramaCaptureController::CaptureFrame()
 
         if (OutputSettings.OutputPath == ECaptureOutputPath::PNGSequence)
         {
-            FrameOutputFile = BuildFrameFilePath(CaptureFrameCounter);
+            FrameOutputFile = bWarmingUp ? FString() : BuildFrameFilePath(CaptureFrameCounter);
         }
         else
         {
             bPreviewOnly = true;
             PayloadSettings.bUse16BitPNG = false;
+            if (!bWarmingUp)
+            {
+                LastPreviewRefreshSeconds = FPlatformTime::Seconds();
+            }
         }
 
-        PendingPayload = MakeShared<FPendingCapturePayload, ESPMode::ThreadSafe>(PayloadSettings, OutputResolution, Now, CaptureFrameCounter, FrameOutputFile, bPreviewOnly);
+        PendingPayload = MakeShared<FPendingCapturePayload, ESPMode::ThreadSafe>(PayloadSettings, OutputResolution, Now, CaptureFrameCounter, FrameOutputFile, bPreviewOnly, AcquireReadback(OutputResolution), bWarmingUp);
         PendingReadbacks.Add(PendingPayload);
     }
 
-    if (!FirstVideoTimestamp.IsSet())
+    if (!bWarmingUp)
     {
-        FirstVideoTimestamp = Now;
+        if (!FirstVideoTimestamp.IsSet())
+        {
+            FirstVideoTimestamp = Now;
+        }
+        LastVideoTimestamp = Now;
+        ++CaptureFrameCounter;
     }
-    LastVideoTimestamp = Now;
-    ++CaptureFrameCounter;
 
+    // Indexed eye * FacesPerEye + slice; faces the layout culls stay null and are never registered.
     const int32 EyeCount = bStereo ? 2 : 1;
     TArray<FTextureRenderTargetResource*, TInlineAllocator<FacesPerEye * 2>> FaceResources;
-    FaceResources.Reserve(EyeCount * FacesPerEye);
+    FaceResources.Init(nullptr, EyeCount * FacesPerEye);
+    bool bHasFaceResource = false;
+
+    // ODS slices are stitched batch by batch as they are rendered; the frame below only resolves the sum.
+    const TSharedPtr<FPanoramaODSAccumulation, ESPMode::ThreadSafe> FrameODSAccumulation = ManagedRig->IsODSActive() ? ODSAccumulation : nullptr;
+    if (FrameODSAccumulation.IsValid())
+    {
+        bHasFaceResource = SubmitODSSlices(OutputResolution, LatitudeRange, LongitudeRange, bOverUnder);
+    }
+
+    // The mono far field is composited into each eye's faces before projection.
+    TArray<FTextureRenderTargetResource*, TInlineAllocator<FacesPerEye>> FarFieldResources;
+    FarFieldResources.Init(nullptr, FacesPerEye);
+    const bool bMonoFarField = ManagedRig->IsMonoFarFieldActive();
+    const float FarFieldDistance = ManagedRig->GetFarFieldDistance();
+    for (int32 FaceIndex = 0; FaceIndex < FacesPerEye && bMonoFarField; ++FaceIndex)
+    {
+        UTextureRenderTarget2D* Target = ManagedRig->IsFaceActive(FaceIndex) ? ManagedRig->GetFarFieldRenderTarget(FaceIndex) : nullptr;
+        FarFieldResources[FaceIndex] = Target ? Target->GameThread_GetRenderTargetResource() : nullptr;
+    }
 
-    for (int32 EyeIndex = 0; EyeIndex < EyeCount; ++EyeIndex)
+    for (int32 EyeIndex = 0; EyeIndex < EyeCount && !FrameODSAccumulation.IsValid(); ++EyeIndex)
     {
         const bool bLeftEye = (EyeIndex == 0);
         for (int32 FaceIndex = 0; FaceIndex < FacesPerEye; ++FaceIndex)
         {
-            if (UTextureRenderTarget2D* Target = ManagedRig->GetFaceRenderTarget(FaceIndex, bLeftEye))
+            UTextureRenderTarget2D* Target = ManagedRig->IsFaceActive(FaceIndex) ? ManagedRig->GetFaceRenderTarget(FaceIndex, bLeftEye) : nullptr;
+            if (FTextureRenderTargetResource* Resource = Target ? Target->GameThread_GetRenderTargetResource() : nullptr)
             {
-                if (FTextureRenderTargetResource* Resource = Target->GameThread_GetRenderTargetResource())
-                {
-                    FaceResources.Add(Resource);
-                }
+                FaceResources[EyeIndex * FacesPerEye + FaceIndex] = Resource;
+                bHasFaceResource = true;
             }
         }
     }
 
-    if (FaceResources.Num() == 0)
+    const int32 FaceSize = ManagedRig->GetFaceSize();
+    const float PolarStereoFadeRadians = ManagedRig->SharesPolarFaces() ? FMath::DegreesToRadians(OutputSettings.PolarStereoFadeDegrees) : 0.f;
+    const uint8 SharedFaceMask = ManagedRig->SharesPolarFaces() ? FPanoramaOutputLayout::PolarFacesMask : 0;
+    if (!bHasFaceResource)
     {
-        UE_LOG(LogPanoramaCapture, Warning, TEXT("No cubemap faces available for capture."));
+        UE_LOG(LogPanoramaCapture, Warning, TEXT("No cubemap faces or ODS slices available for capture."));
         return;
     }
 
+    FTextureRenderTargetResource* PreviewResource = nullptr;
+    FIntPoint PreviewResolution = FIntPoint::ZeroValue;
+    if (UsesGPUPreview() && bPreviewDue)
+    {
+        EnsurePreviewRenderTarget(OutputResolution);
+        if (PreviewRenderTarget)
+        {
+            PreviewResource = PreviewRenderTarget->GameThread_GetRenderTargetResource();
+            PreviewResolution = FIntPoint(PreviewRenderTarget->SizeX, PreviewRenderTarget->SizeY);
+            LastPreviewRefreshSeconds = FPlatformTime::Seconds();
+        }
+    }
+
     const FCaptureOutputSettings LocalSettings = OutputSettings;
-    TWeakPtr<IPanoramaVideoEncoder, ESPMode::ThreadSafe> EncoderWeak = ActiveEncoder;
+    // Warmup frames still run the encode surface passes but never reach the encoder.
+    TWeakPtr<IPanoramaVideoEncoder, ESPMode::ThreadSafe> EncoderWeak = bWarmingUp ? TSharedPtr<IPanoramaVideoEncoder>() : ActiveEncoder;
+    const bool bEncodePlanes = ActiveEncoder.IsValid() && ActiveEncoder->SupportsPlanarInput() && OutputSettings.NVENC.bPlanarYUVInput;
+    TSharedPtr<const FPanoramaProjectionLUT, ESPMode::ThreadSafe> ProjectionLUT = ActiveProjectionLUT;
+    FTextureResource* ColorGradingLUTResource = ActiveColorGradingLUT ? ActiveColorGradingLUT->GetResource() : nullptr;
 
     ENQUEUE_RENDER_COMMAND(PanoramaCaptureSubmit)(
-        [FaceResources, PendingPayload, OutputResolution, bStereo, bOverUnder, bLinearGamma, LocalSettings, EncoderWeak, Now](FRHICommandListImmediate& RHICmdList)
+        [FaceResources, FarFieldResources, bMonoFarField, FarFieldDistance, FaceSize, SharedFaceMask, PolarStereoFadeRadians, FrameODSAccumulation, ColorGradingLUTResource, PendingPayload, PreviewResource, PreviewResolution, OutputResolution, bStereo, bOverUnder, bLinearGamma, LatitudeRange, LongitudeRange, EffectiveLayout, LocalSettings, EncoderWeak, bEncodePlanes, ProjectionLUT, Now](FRHICommandListImmediate& RHICmdList)
         {
             FRDGBuilder GraphBuilder(RHICmdList);
 
-            TArray<FRDGTextureRef, TInlineAllocator<FacesPerEye * 2>> RegisteredFaces;
-            RegisteredFaces.Reserve(FaceResources.Num());
+            FRDGTextureDesc OutputDesc = FRDGTextureDesc::Create2D(OutputResolution.X, OutputResolution.Y, PF_FloatRGBA, FClearValueBinding::Transparent, TexCreate_ShaderResource | TexCreate_UAV);
+            FRDGTextureRef OutputTexture = GraphBuilder.CreateTexture(OutputDesc, TEXT("PanoramaEquirect"));
 
-            for (int32 Index = 0; Index < FaceResources.Num(); ++Index)
+            // Scene-linear faces are projected linear and graded once below, which then applies the output encoding.
+            const bool bGradeAfterStitch = UCubemapCaptureRigComponent::CapturesSceneLinear(LocalSettings);
+            const bool bProjectLinear = bLinearGamma || bGradeAfterStitch;
+
+            if (FrameODSAccumulation.IsValid())
             {
-                if (FTextureRenderTargetResource* Resource = FaceResources[Index])
+                if (!FrameODSAccumulation->Target.IsValid())
                 {
-                    const FTextureRHIRef TextureRHI = Resource->GetRenderTargetTexture();
+                    return;
+                }
+                FRDGTextureRef Accumulation = GraphBuilder.RegisterExternalTexture(FrameODSAccumulation->Target, TEXT("PanoramaODSAccumulation"));
+                FPanoramaODSStitchPass::AddResolvePass(GraphBuilder, Accumulation, OutputTexture, OutputResolution, bProjectLinear);
+            }
+            else
+            {
+                // The projection passes sample the face render targets where the scene captures left them; nothing is copied into a cube.
+                FPanoramaCubeFaces CubeFaces;
+                CubeFaces.FaceSize = FaceSize;
+                CubeFaces.bStereo = bStereo;
+                CubeFaces.SharedFaceMask = SharedFaceMask;
+                for (int32 Index = 0; Index < FaceResources.Num(); ++Index)
+                {
+                    FTextureRenderTargetResource* Resource = FaceResources[Index];
+                    FTextureRHIRef TextureRHI;
+                    if (Resource)
+                    {
+                        TextureRHI = Resource->GetRenderTargetTexture();
+                    }
                     if (TextureRHI.IsValid())
                     {
                         const FString DebugName = FString::Printf(TEXT("PanoramaFace_%d"), Index);
-                        FRDGTextureRef Registered = GraphBuilder.RegisterExternalTexture(CreateRenderTarget(TextureRHI, *DebugName));
-                        RegisteredFaces.Add(Registered);
+                        FRDGTextureRef& Slot = Index < FacesPerEye ? CubeFaces.Left[Index] : CubeFaces.Right[Index - FacesPerEye];
+                        Slot = GraphBuilder.RegisterExternalTexture(CreateRenderTarget(TextureRHI, *DebugName));
                     }
                 }
-            }
 
-            if (RegisteredFaces.Num() == 0)
-            {
-                return;
-            }
+                if (!CubeFaces.IsValid())
+                {
+                    return;
+                }
 
-            const FIntPoint FaceSize(FaceResources[0]->GetSizeX(), FaceResources[0]->GetSizeY());
-            const EPixelFormat FaceFormat = FaceResources[0]->GetTextureRHI()->GetFormat();
+                if (bMonoFarField)
+                {
+                    FRDGTextureRef FarFieldFaces[FacesPerEye] = {};
+                    for (int32 FaceIndex = 0; FaceIndex < FacesPerEye; ++FaceIndex)
+                    {
+                        const FTextureRHIRef FarFieldRHI = FarFieldResources[FaceIndex] ? FarFieldResources[FaceIndex]->GetRenderTargetTexture() : FTextureRHIRef();
+                        if (FarFieldRHI.IsValid())
+                        {
+                            FarFieldFaces[FaceIndex] = GraphBuilder.RegisterExternalTexture(CreateRenderTarget(FarFieldRHI, TEXT("PanoramaFarFieldFace")));
+                        }
+                    }
+                    FPanoramaDepthCompositePass::CompositeFaces(GraphBuilder, CubeFaces, FarFieldFaces, FarFieldDistance);
+                }
 
-            FRDGTextureDesc CubeDesc = FRDGTextureDesc::CreateCube(FaceSize.X, FaceFormat, FClearValueBinding::Transparent, TexCreate_ShaderResource | TexCreate_UAV);
-            FRDGTextureRef LeftCube = GraphBuilder.CreateTexture(CubeDesc, TEXT("PanoramaCubeLeft"));
-            FRDGTextureRef RightCube = bStereo ? GraphBuilder.CreateTexture(CubeDesc, TEXT("PanoramaCubeRight")) : LeftCube;
+                FCubemapEquirectDispatchParams DispatchParams;
+                DispatchParams.Faces = CubeFaces;
+                DispatchParams.DestinationEquirect = OutputTexture;
+                DispatchParams.OutputResolution = OutputResolution;
+                DispatchParams.LatitudeRange = LatitudeRange;
+                DispatchParams.LongitudeRange = LongitudeRange;
+                DispatchParams.bFisheyeForward = EffectiveLayout == EEquiLayout::VR180;
+                DispatchParams.FieldOfViewRadians = FMath::DegreesToRadians(FPanoramaOutputLayout::GetFisheyeFieldOfView(LocalSettings));
+                DispatchParams.Filter = LocalSettings.ResampleFilter;
+                DispatchParams.SupersampleGrid = LocalSettings.SupersampleGrid;
+                DispatchParams.bStereo = bStereo;
+                DispatchParams.bLinearGamma = bProjectLinear;
+                DispatchParams.bStereoOverUnder = bOverUnder;
+                DispatchParams.PolarStereoFadeRadians = PolarStereoFadeRadians;
+
+                if (ProjectionLUT.IsValid() && ProjectionLUT->GetKey().Resolution == OutputResolution)
+                {
+                    const FTextureRHIRef ProjectionLUTRHI = ProjectionLUT->GetOrCreateRHITexture(RHICmdList);
+                    if (ProjectionLUTRHI.IsValid())
+                    {
+                        DispatchParams.ProjectionLUT = GraphBuilder.RegisterExternalTexture(CreateRenderTarget(ProjectionLUTRHI, TEXT("PanoramaProjectionLUT")));
+                    }
+                }
 
-            for (int32 FaceIndex = 0; FaceIndex < FacesPerEye && FaceIndex < RegisteredFaces.Num(); ++FaceIndex)
-            {
-                FRHICopyTextureInfo CopyInfo;
-                CopyInfo.DestSliceIndex = FaceIndex;
-                AddCopyTexturePass(GraphBuilder, RegisteredFaces[FaceIndex], LeftCube, CopyInfo);
+                if (LocalSettings.Projection == EPanoramaProjection::EquiAngularCubemap)
+                {
+                    FCubemapEACPass::AddComputePass(GraphBuilder, DispatchParams);
+                }
+                else if (LocalSettings.Projection == EPanoramaProjection::Domemaster)
+                {
+                    FCubemapFisheyePass::AddComputePass(GraphBuilder, DispatchParams);
+                }
+                else
+                {
+                    FCubemapEquirectPass::AddComputePass(GraphBuilder, DispatchParams);
+                }
             }
 
-            if (bStereo)
+            if (bGradeAfterStitch)
             {
-                for (int32 FaceIndex = 0; FaceIndex < FacesPerEye; ++FaceIndex)
+                FPanoramaColorGradeParams GradeParams = FPanoramaColorGradeParams::FromSettings(LocalSettings.ColorGrading, OutputTexture, OutputResolution, bLinearGamma);
+                if (ColorGradingLUTResource && ColorGradingLUTResource->TextureRHI.IsValid())
                 {
-                    const int32 SourceIndex = FaceIndex + FacesPerEye;
-                    if (RegisteredFaces.IsValidIndex(SourceIndex))
-                    {
-                        FRHICopyTextureInfo CopyInfo;
-                        CopyInfo.DestSliceIndex = FaceIndex;
-                        AddCopyTexturePass(GraphBuilder, RegisteredFaces[SourceIndex], RightCube, CopyInfo);
-                    }
+                    GradeParams.ColorGradingLUT = GraphBuilder.RegisterExternalTexture(CreateRenderTarget(ColorGradingLUTResource->TextureRHI, TEXT("PanoramaColorGradingLUT")));
                 }
+                FPanoramaColorGradePass::AddComputePass(GraphBuilder, GradeParams);
             }
 
-            FRDGTextureDesc OutputDesc = FRDGTextureDesc::Create2D(OutputResolution.X, OutputResolution.Y, PF_FloatRGBA, FClearValueBinding::Transparent, TexCreate_ShaderResource | TexCreate_UAV);
-            FRDGTextureRef OutputTexture = GraphBuilder.CreateTexture(OutputDesc, TEXT("PanoramaEquirect"));
-
-            FCubemapEquirectDispatchParams DispatchParams;
-            DispatchParams.SourceCubemapLeft = LeftCube;
-            DispatchParams.SourceCubemapRight = RightCube;
-            DispatchParams.DestinationEquirect = OutputTexture;
-            DispatchParams.OutputResolution = OutputResolution;
-            DispatchParams.bStereo = bStereo;
-            DispatchParams.bLinearGamma = bLinearGamma;
-            DispatchParams.bStereoOverUnder = bOverUnder;
-
-            FCubemapEquirectPass::AddComputePass(GraphBuilder, DispatchParams);
+            if (PreviewResource)
+            {
+                const FTextureRHIRef PreviewRHI = PreviewResource->GetRenderTargetTexture();
+                if (PreviewRHI.IsValid())
+                {
+                    FPanoramaPreviewDispatchParams PreviewParams;
+                    PreviewParams.SourceTexture = OutputTexture;
+                    PreviewParams.DestinationPreview = GraphBuilder.RegisterExternalTexture(CreateRenderTarget(PreviewRHI, TEXT("PanoramaPreview")));
+                    PreviewParams.SourceResolution = OutputResolution;
+                    PreviewParams.PreviewResolution = PreviewResolution;
+                    PreviewParams.bApplySRGB = bLinearGamma;
+                    FPanoramaPreviewPass::AddDownsamplePass(GraphBuilder, PreviewParams);
+
+                    // Slate and UMG sample the target directly, so leave it readable once the graph completes.
+                    GraphBuilder.SetTextureAccessFinal(PreviewParams.DestinationPreview, ERHIAccess::SRVMask);
+                }
+            }
 
             const bool bEncodeNVENC =
 #if WITH_PANORAMA_NVENC
@@ -561,9 +1061,20 @@ void UPanoramaCaptureController::CaptureFrame()
                 false;
 #endif
             FRDGTextureRef NVENCEncodeTexture = nullptr;
+            FPanoramaYUVPlaneTextures NVENCEncodePlanes;
 
 #if WITH_PANORAMA_NVENC
-            if (bEncodeNVENC)
+            if (bEncodeNVENC && bEncodePlanes)
+            {
+                FPanoramaYUVConvertParams ConvertParams;
+                ConvertParams.SourceTexture = OutputTexture;
+                ConvertParams.Resolution = OutputResolution;
+                ConvertParams.Matrix = LocalSettings.NVENC.YUVMatrix;
+                ConvertParams.bP010 = LocalSettings.NVENC.bUseP010;
+                ConvertParams.bApplySRGB = bLinearGamma;
+                NVENCEncodePlanes = FPanoramaYUVConvertPass::AddConvertPass(GraphBuilder, ConvertParams);
+            }
+            else if (bEncodeNVENC)
             {
                 const EPixelFormat EncodeFormat = LocalSettings.NVENC.bUseP010 ? PF_A2B10G10R10 : PF_B8G8R8A8;
                 FRDGTextureDesc EncodeDesc = FRDGTextureDesc::Create2D(OutputResolution.X, OutputResolution.Y, EncodeFormat, FClearValueBinding::Transparent, TexCreate_ShaderResource | TexCreate_UAV);
@@ -601,14 +1112,38 @@ void UPanoramaCaptureController::CaptureFrame()
                 GraphBuilder.QueueTextureExtraction(NVENCEncodeTexture, &ExtractedNVENCTexture);
             }
 
+            TRefCountPtr<IPooledRenderTarget> ExtractedNVENCLuma;
+            TRefCountPtr<IPooledRenderTarget> ExtractedNVENCChroma;
+            if (NVENCEncodePlanes.IsValid())
+            {
+                // The encoder copies the planes into its own native surface on this command list, so they end as copy sources.
+                GraphBuilder.QueueTextureExtraction(NVENCEncodePlanes.Luma, &ExtractedNVENCLuma, ERHIAccess::CopySrc);
+                GraphBuilder.QueueTextureExtraction(NVENCEncodePlanes.Chroma, &ExtractedNVENCChroma, ERHIAccess::CopySrc);
+            }
+
             GraphBuilder.Execute();
 
+            if (PendingPayload.IsValid())
+            {
+                PendingPayload->MarkCopySubmitted();
+            }
+
 #if WITH_PANORAMA_NVENC
             if (bEncodeNVENC)
             {
                 if (TSharedPtr<IPanoramaVideoEncoder> Encoder = EncoderWeak.Pin())
                 {
-                    if (ExtractedNVENCTexture.IsValid())
+                    if (ExtractedNVENCLuma.IsValid() && ExtractedNVENCChroma.IsValid())
+                    {
+                        FPanoramaVideoEncoderFrame EncoderFrame;
+                        EncoderFrame.LumaTexture = ExtractedNVENCLuma->GetRHI();
+                        EncoderFrame.ChromaTexture = ExtractedNVENCChroma->GetRHI();
+                        EncoderFrame.bIsP010 = LocalSettings.NVENC.bUseP010;
+                        EncoderFrame.bIsNV12 = !EncoderFrame.bIsP010;
+                        EncoderFrame.TimeSeconds = Now;
+                        Encoder->EncodeFrame(EncoderFrame);
+                    }
+                    else if (ExtractedNVENCTexture.IsValid())
                     {
                         FPanoramaVideoEncoderFrame EncoderFrame;
                         EncoderFrame.RgbaTexture = ExtractedNVENCTexture->GetRHI();
@@ -619,6 +1154,222 @@ void UPanoramaCaptureController::CaptureFrame()
             }
 #endif
         });
+
+    if (PreviewResource)
+    {
+        OnPreviewUpdated().Broadcast(this);
+    }
+}
+
+void UPanoramaCaptureController::UpdateResolutionGovernor()
+{
+    int32 QueuedFrames = FrameBuffer.Num() + PendingReadbacks.Num();
+    int32 LostFrames = FrameBuffer.GetDroppedFrames() + FrameBuffer.GetBlockedFrames();
+    if (ActiveEncoder.IsValid())
+    {
+        const FPanoramaVideoEncoderStats EncoderStats = ActiveEncoder->GetStats();
+        QueuedFrames += EncoderStats.QueuedFrames;
+        LostFrames += EncoderStats.DroppedFrames;
+    }
+
+    FPanoramaGovernorSample Sample;
+    Sample.GPUFrameMilliseconds = GovernorPeakGPUMilliseconds;
+    // A single-slot ring is full whenever one frame is in flight, so measure against at least two.
+    Sample.QueueFill = static_cast<float>(QueuedFrames) / FMath::Max(2, FrameBuffer.Capacity());
+    Sample.NewlyLostFrames = FMath::Max(0, LostFrames - GovernorLostFrames);
+    GovernorLostFrames = LostFrames;
+    GovernorPeakGPUMilliseconds = 0.f;
+
+    if (!ResolutionGovernor.Update(Sample))
+    {
+        return;
+    }
+
+    // The output resolution is untouched; only the faces the projection resamples change size. Their targets were all
+    // allocated by PrepareCapture, so this only rebinds them.
+    if (ManagedRig->SetResolutionScale(ResolutionGovernor.GetScale()))
+    {
+        UE_LOG(LogPanoramaCapture, Verbose, TEXT("Resolution governor: face scale %.2f, %dx%d faces, GPU %.1f of %.1f ms."),
+            ResolutionGovernor.GetScale(), ManagedRig->GetFaceSize(), ManagedRig->GetFaceSize(),
+            ResolutionGovernor.GetGPUFrameMilliseconds(), ResolutionGovernor.GetBudgetMilliseconds());
+    }
+}
+
+bool UPanoramaCaptureController::BenchmarkCaptureBackends(int32 FramesPerBackend, int32 Rounds)
+{
+    if (!bIsCapturing || !ManagedRig || ManagedRig->IsODSActive() || ManagedRig->IsRegionCaptureActive())
+    {
+        UE_LOG(LogPanoramaCapture, Warning, TEXT("Capture backends can only be compared on a running cube-face capture."));
+        return false;
+    }
+    if (bGovernResolution)
+    {
+        UE_LOG(LogPanoramaCapture, Warning, TEXT("Turn the resolution governor off to compare capture backends; its face size steps would skew the timings."));
+        return false;
+    }
+    if (BackendBenchmark.IsSet())
+    {
+        return false;
+    }
+
+    FBackendBenchmark& Benchmark = BackendBenchmark.Emplace();
+    Benchmark.FramesPerPhase = FMath::Clamp(FramesPerBackend, 30, 100000);
+    Benchmark.PhasesLeft = 2 * FMath::Clamp(Rounds, 1, 100);
+    Benchmark.RestoreBackend = ManagedRig->OutputSettings.CaptureBackend;
+    ManagedRig->OutputSettings.CaptureBackend = EPanoramaCaptureBackend::SceneCapture2D;
+
+    UE_LOG(LogPanoramaCapture, Log, TEXT("Comparing capture backends over %d rounds of %d engine frames each."), Benchmark.PhasesLeft / 2, Benchmark.FramesPerPhase);
+    return true;
+}
+
+void UPanoramaCaptureController::TickBackendBenchmark()
+{
+    FBackendBenchmark& Benchmark = BackendBenchmark.GetValue();
+    const int32 Backend = static_cast<int32>(ManagedRig->OutputSettings.CaptureBackend);
+
+    // Engine frames without a capture tick are sampled too; both backends see the same mix, so the means stay comparable.
+    if (Benchmark.PhaseFrame >= BackendBenchmarkSettleFrames)
+    {
+        Benchmark.RenderThreadMilliseconds[Backend] += FPlatformTime::ToMilliseconds(GRenderThreadTime);
+        Benchmark.GPUMilliseconds[Backend] += FPlatformTime::ToMilliseconds(RHIGetGPUFrameCycles());
+        ++Benchmark.SampledFrames[Backend];
+    }
+
+    if (++Benchmark.PhaseFrame < BackendBenchmarkSettleFrames + Benchmark.FramesPerPhase)
+    {
+        return;
+    }
+
+    Benchmark.PhaseFrame = 0;
+    if (--Benchmark.PhasesLeft > 0)
+    {
+        ManagedRig->OutputSettings.CaptureBackend = (ManagedRig->OutputSettings.CaptureBackend == EPanoramaCaptureBackend::SceneCapture2D)
+            ? EPanoramaCaptureBackend::MultiViewFamily
+            : EPanoramaCaptureBackend::SceneCapture2D;
+        return;
+    }
+
+    FinishBackendBenchmark();
+}
+
+void UPanoramaCaptureController::FinishBackendBenchmark()
+{
+    const FBackendBenchmark Benchmark = BackendBenchmark.GetValue();
+    BackendBenchmark.Reset();
+    if (ManagedRig)
+    {
+        ManagedRig->OutputSettings.CaptureBackend = Benchmark.RestoreBackend;
+    }
+
+    double MeanRenderThread[2] = {};
+    double MeanGPU[2] = {};
+    for (int32 Backend = 0; Backend < 2; ++Backend)
+    {
+        const int32 Frames = Benchmark.SampledFrames[Backend];
+        MeanRenderThread[Backend] = Frames > 0 ? Benchmark.RenderThreadMilliseconds[Backend] / Frames : 0.0;
+        MeanGPU[Backend] = Frames > 0 ? Benchmark.GPUMilliseconds[Backend] / Frames : 0.0;
+        UE_LOG(LogPanoramaCapture, Log, TEXT("Capture backend %s: %.2f ms render thread, %.2f ms GPU per engine frame over %d frames."),
+            *StaticEnum<EPanoramaCaptureBackend>()->GetNameStringByValue(Backend), MeanRenderThread[Backend], MeanGPU[Backend], Frames);
+    }
+
+    if (Benchmark.SampledFrames[0] > 0 && Benchmark.SampledFrames[1] > 0)
+    {
+        UE_LOG(LogPanoramaCapture, Log, TEXT("MultiViewFamily against SceneCapture2D: render thread %+.2f ms, GPU %+.2f ms per engine frame."),
+            MeanRenderThread[1] - MeanRenderThread[0], MeanGPU[1] - MeanGPU[0]);
+    }
+    else
+    {
+        UE_LOG(LogPanoramaCapture, Warning, TEXT("The capture stopped before both backends were sampled; no comparison."));
+    }
+}
+
+bool UPanoramaCaptureController::SubmitODSSlices(const FIntPoint& OutputResolution, const FVector2f& LatitudeRange, const FVector2f& LongitudeRange, bool bOverUnder)
+{
+    using namespace PanoramaODS;
+
+    FPanoramaODSStitchParams StitchParams;
+    StitchParams.OutputResolution = OutputResolution;
+    StitchParams.LatitudeRange = LatitudeRange;
+    StitchParams.LongitudeRange = LongitudeRange;
+    StitchParams.SliceCount = ManagedRig->GetODSSliceCount();
+    StitchParams.SliceTanHalfFov = UCubemapCaptureRigComponent::ComputeODSSliceTanHalfFov(ManagedRig->OutputSettings);
+    StitchParams.bStereoOverUnder = bOverUnder;
+
+    const int32 BatchSize = ManagedRig->GetODSBatchSize();
+    const int32 BatchCount = ManagedRig->GetODSBatchCount();
+    for (int32 BatchIndex = 0; BatchIndex < BatchCount; ++BatchIndex)
+    {
+        // The batch's targets are overwritten by the next batch, so each batch is stitched by its own render command,
+        // which the render thread runs before the next batch's captures.
+        const int32 BatchSlices = ManagedRig->CaptureODSBatch(BatchIndex);
+        if (BatchSlices <= 0)
+        {
+            return false;
+        }
+
+        TArray<FTextureRenderTargetResource*> SliceResources;
+        SliceResources.Init(nullptr, BatchSlices * 2 * PitchRows);
+        for (int32 Index = 0; Index < SliceResources.Num(); ++Index)
+        {
+            const int32 BatchSlot = Index / (2 * PitchRows);
+            UTextureRenderTarget2D* Target = ManagedRig->GetODSSliceRenderTarget(BatchSlot, (Index / PitchRows) % 2, Index % PitchRows);
+            SliceResources[Index] = Target ? Target->GameThread_GetRenderTargetResource() : nullptr;
+            if (!SliceResources[Index])
+            {
+                return false;
+            }
+        }
+
+        const int32 FirstSlice = BatchIndex * BatchSize;
+        const bool bFirstBatch = (BatchIndex == 0);
+        ENQUEUE_RENDER_COMMAND(PanoramaODSStitchBatch)(
+            [Accumulation = ODSAccumulation, SliceResources = MoveTemp(SliceResources), StitchParams, FirstSlice, bFirstBatch](FRHICommandListImmediate& RHICmdList)
+            {
+                FRDGBuilder GraphBuilder(RHICmdList);
+
+                FPanoramaODSStitchParams BatchParams = StitchParams;
+                bool bClear = bFirstBatch;
+                FRDGTextureRef AccumulationTexture;
+                if (Accumulation->Target.IsValid() && Accumulation->Target->GetDesc().Extent == StitchParams.OutputResolution)
+                {
+                    AccumulationTexture = GraphBuilder.RegisterExternalTexture(Accumulation->Target, TEXT("PanoramaODSAccumulation"));
+                }
+                else
+                {
+                    AccumulationTexture = GraphBuilder.CreateTexture(FPanoramaODSStitchPass::CreateAccumulationDesc(StitchParams.OutputResolution), TEXT("PanoramaODSAccumulation"));
+                    bClear = true;
+                }
+
+                if (bClear)
+                {
+                    AddClearUAVPass(GraphBuilder, GraphBuilder.CreateUAV(AccumulationTexture), FLinearColor::Transparent);
+                }
+                BatchParams.Accumulation = AccumulationTexture;
+
+                for (int32 BatchSlot = 0; BatchSlot < SliceResources.Num() / (2 * PitchRows); ++BatchSlot)
+                {
+                    FPanoramaODSSliceTextures Slice;
+                    Slice.SliceIndex = FirstSlice + BatchSlot;
+                    for (int32 EyeIndex = 0; EyeIndex < 2; ++EyeIndex)
+                    {
+                        for (int32 Row = 0; Row < PitchRows; ++Row)
+                        {
+                            const FTextureRHIRef TextureRHI = SliceResources[(BatchSlot * 2 + EyeIndex) * PitchRows + Row]->GetRenderTargetTexture();
+                            if (TextureRHI.IsValid())
+                            {
+                                Slice.Rows[EyeIndex][Row] = GraphBuilder.RegisterExternalTexture(CreateRenderTarget(TextureRHI, TEXT("PanoramaODSSlice")));
+                            }
+                        }
+                    }
+                    FPanoramaODSStitchPass::AddSlicePass(GraphBuilder, BatchParams, Slice);
+                }
+
+                GraphBuilder.QueueTextureExtraction(AccumulationTexture, &Accumulation->Target);
+                GraphBuilder.Execute();
+            });
+    }
+
+    return true;
 }
 
 void UPanoramaCaptureController::ConsumeFrameQueue()
@@ -633,6 +1384,8 @@ void UPanoramaCaptureController::ConsumeFrameQueue()
             WritePNGFrame(MoveTemp(Frame));
         }
     }
+
+    ResolveFingerprintedFrames(false);
 }
 
 void UPanoramaCaptureController::ProcessPendingReadbacks()
@@ -642,12 +1395,25 @@ void UPanoramaCaptureController::ProcessPendingReadbacks()
         const TSharedPtr<FPendingCapturePayload, ESPMode::ThreadSafe>& Pending = PendingReadbacks[Index];
         if (Pending.IsValid() && Pending->IsReady())
         {
+            const bool bDiscarded = Pending->IsDiscarded();
             const bool bPreviewOnly = Pending->IsPreviewOnly();
-            FPanoramaCaptureFrame ResolvedFrame = Pending->Resolve();
+            FPanoramaCaptureFrame ResolvedFrame = bDiscarded ? FPanoramaCaptureFrame() : Pending->Resolve(*PayloadPool);
 
-            if (OutputSettings.bEnablePreview)
+            // Staging sized for an earlier output resolution is dropped rather than pooled.
+            if (Pending->GetResolution() == ReadbackPoolResolution)
             {
-                UpdatePreviewFromFrame(ResolvedFrame);
+                ReadbackPool.Add(Pending->ReleaseReadback());
+            }
+
+            if (bDiscarded)
+            {
+                PendingReadbacks.RemoveAtSwap(Index);
+                continue;
+            }
+
+            if (OutputSettings.bEnablePreview && !UsesGPUPreview())
+            {
+                UpdatePreviewFromFrame(ResolvedFrame, bPreviewOnly);
             }
 
             if (!bPreviewOnly)
@@ -667,6 +1433,58 @@ void UPanoramaCaptureController::ProcessPendingReadbacks()
 }
 
 void UPanoramaCaptureController::WritePNGFrame(FPanoramaCaptureFrame&& Frame)
+{
+    if (!OutputSettings.bElideDuplicateFrames)
+    {
+        SubmitPNGWrite(MoveTemp(Frame));
+        return;
+    }
+
+    // Hashing the whole payload costs milliseconds at 8K, so it runs on the pool; the frame only shares the payload with the task.
+    const bool bBuildLumaGrid = OutputSettings.NearDuplicateThreshold > 0.f;
+    FFingerprintedFrame& Pending = FingerprintedFrames.AddDefaulted_GetRef();
+    Pending.Fingerprint = Async(EAsyncExecution::ThreadPool,
+        [HashedFrame = Frame, bBuildLumaGrid]()
+        {
+            return FCaptureFrameFingerprint::Compute(HashedFrame, bBuildLumaGrid);
+        });
+    Pending.Frame = MoveTemp(Frame);
+
+    ResolveFingerprintedFrames(false);
+}
+
+void UPanoramaCaptureController::ResolveFingerprintedFrames(bool bWait)
+{
+    const float Threshold = FMath::Max(0.f, OutputSettings.NearDuplicateThreshold);
+
+    int32 ResolvedCount = 0;
+    for (; ResolvedCount < FingerprintedFrames.Num(); ++ResolvedCount)
+    {
+        FFingerprintedFrame& Pending = FingerprintedFrames[ResolvedCount];
+        if (!bWait && !Pending.Fingerprint.IsReady())
+        {
+            break;
+        }
+
+        FCaptureFrameFingerprint Fingerprint = Pending.Fingerprint.Get();
+
+        // Always compare against the last frame that was actually written so near-duplicates cannot drift over a long static shot.
+        if (CapturedFrameFiles.Num() > 0 && Fingerprint.Matches(LastWrittenFingerprint, Threshold))
+        {
+            ++ElidedFrameCount;
+            LastElidedFrameTime = Pending.Frame.TimeSeconds;
+            continue;
+        }
+
+        LastWrittenFingerprint = MoveTemp(Fingerprint);
+        LastElidedFrameTime.Reset();
+        SubmitPNGWrite(MoveTemp(Pending.Frame));
+    }
+
+    FingerprintedFrames.RemoveAt(0, ResolvedCount);
+}
+
+void UPanoramaCaptureController::SubmitPNGWrite(FPanoramaCaptureFrame&& Frame)
 {
     const FString OutputFile = Frame.OutputFile;
     CapturedFrameFiles.Add(OutputFile);
@@ -675,12 +1493,12 @@ void UPanoramaCaptureController::WritePNGFrame(FPanoramaCaptureFrame&& Frame)
     const bool bUse16BitPNG = Frame.bIs16Bit;
     const FIntPoint Resolution = Frame.Resolution;
 
-    TArray<uint8> Payload = MoveTemp(Frame.Payload);
+    TSharedPtr<const TArray<uint8>, ESPMode::ThreadSafe> Payload = MoveTemp(Frame.Payload);
 
     TFuture<void> WriteTask = Async(EAsyncExecution::ThreadPool,
         [Payload = MoveTemp(Payload), Resolution, OutputFile, bUse16BitPNG]()
         {
-            if (Payload.Num() == 0)
+            if (!Payload.IsValid() || Payload->Num() == 0)
             {
                 return;
             }
@@ -690,7 +1508,7 @@ void UPanoramaCaptureController::WritePNGFrame(FPanoramaCaptureFrame&& Frame)
             const ERGBFormat RGBFormat = ERGBFormat::RGBA;
             const int32 BitDepth = bUse16BitPNG ? 16 : 8;
 
-            if (Wrapper->SetRaw(Payload.GetData(), Payload.Num(), Resolution.X, Resolution.Y, RGBFormat, BitDepth))
+            if (Wrapper->SetRaw(Payload->GetData(), Payload->Num(), Resolution.X, Resolution.Y, RGBFormat, BitDepth))
             {
                 const TArray64<uint8>& Compressed = Wrapper->GetCompressed(0);
                 FFileHelper::SaveArrayToFile(Compressed, *OutputFile);
@@ -700,76 +1518,118 @@ void UPanoramaCaptureController::WritePNGFrame(FPanoramaCaptureFrame&& Frame)
     CapturedFrameTimes.Add(FrameTimeSeconds);
 }
 
-void UPanoramaCaptureController::UpdatePreviewFromFrame(const FPanoramaCaptureFrame& Frame)
+UTexture* UPanoramaCaptureController::GetPreviewTexture() const
 {
-    if (!OutputSettings.bEnablePreview)
+    if (UsesGPUPreview() && PreviewRenderTarget)
     {
-        return;
+        return PreviewRenderTarget;
     }
+    return PreviewTexture;
+}
 
-    const int32 SourceWidth = Frame.Resolution.X;
-    const int32 SourceHeight = Frame.Resolution.Y;
-    const float PreviewScale = FMath::Clamp(OutputSettings.PreviewScale, 0.1f, 1.0f);
-    const int32 PreviewWidth = FMath::Max(1, FMath::RoundToInt(SourceWidth * PreviewScale));
-    const int32 PreviewHeight = FMath::Max(1, FMath::RoundToInt(SourceHeight * PreviewScale));
+bool UPanoramaCaptureController::UsesGPUPreview() const
+{
+    return OutputSettings.bEnablePreview && OutputSettings.bGPUPreview;
+}
 
-    TArray<uint8> PreviewPixels;
-    PreviewPixels.SetNumUninitialized(PreviewWidth * PreviewHeight * 4);
+void UPanoramaCaptureController::EnsurePreviewRenderTarget(const FIntPoint& OutputResolution)
+{
+    const FIntPoint PreviewSize = FPanoramaPreviewDownscaler::ComputePreviewSize(OutputResolution, OutputSettings.PreviewScale);
 
-    const float StepX = static_cast<float>(SourceWidth) / static_cast<float>(PreviewWidth);
-    const float StepY = static_cast<float>(SourceHeight) / static_cast<float>(PreviewHeight);
+    if (!PreviewRenderTarget)
+    {
+        PreviewRenderTarget = NewObject<UTextureRenderTarget2D>(this, TEXT("PanoramaPreviewTarget"));
+        PreviewRenderTarget->ClearColor = FLinearColor::Black;
+        PreviewRenderTarget->bCanCreateUAV = true;
+    }
 
-    if (Frame.bIs16Bit)
+    // Persistent across frames and sessions; only reallocated when the preview size changes.
+    if (PreviewRenderTarget->SizeX != PreviewSize.X || PreviewRenderTarget->SizeY != PreviewSize.Y)
     {
-        const uint16* SourceData = reinterpret_cast<const uint16*>(Frame.Payload.GetData());
-        for (int32 Y = 0; Y < PreviewHeight; ++Y)
-        {
-            const int32 SrcY = FMath::Clamp(static_cast<int32>(Y * StepY), 0, SourceHeight - 1);
-            for (int32 X = 0; X < PreviewWidth; ++X)
-            {
-                const int32 SrcX = FMath::Clamp(static_cast<int32>(X * StepX), 0, SourceWidth - 1);
-                const int32 SrcIndex = (SrcY * SourceWidth + SrcX) * 4;
-                const int32 DstIndex = (Y * PreviewWidth + X) * 4;
-                PreviewPixels[DstIndex + 0] = static_cast<uint8>(SourceData[SrcIndex + 2] >> 8);
-                PreviewPixels[DstIndex + 1] = static_cast<uint8>(SourceData[SrcIndex + 1] >> 8);
-                PreviewPixels[DstIndex + 2] = static_cast<uint8>(SourceData[SrcIndex + 0] >> 8);
-                PreviewPixels[DstIndex + 3] = static_cast<uint8>(SourceData[SrcIndex + 3] >> 8);
-            }
-        }
+        PreviewRenderTarget->InitCustomFormat(PreviewSize.X, PreviewSize.Y, PF_R8G8B8A8, true);
+        PreviewRenderTarget->UpdateResourceImmediate(true);
     }
-    else
+}
+
+bool UPanoramaCaptureController::IsPreviewRefreshDue() const
+{
+    if (!OutputSettings.bEnablePreview || bPreviewTaskInFlight)
+    {
+        return false;
+    }
+
+    const double RefreshInterval = 1.0 / FMath::Clamp(OutputSettings.PreviewRefreshRate, 1.f, 60.f);
+    return (FPlatformTime::Seconds() - LastPreviewRefreshSeconds) >= RefreshInterval;
+}
+
+void UPanoramaCaptureController::UpdatePreviewFromFrame(const FPanoramaCaptureFrame& Frame, bool bPreviewOnly)
+{
+    // Preview-only readbacks were already throttled when they were requested in CaptureFrame.
+    if (!OutputSettings.bEnablePreview || bPreviewTaskInFlight || (!bPreviewOnly && !IsPreviewRefreshDue()))
     {
-        const uint8* SourceData = Frame.Payload.GetData();
-        for (int32 Y = 0; Y < PreviewHeight; ++Y)
+        return;
+    }
+
+    if (!Frame.Payload.IsValid() || Frame.Resolution.X <= 0 || Frame.Resolution.Y <= 0)
+    {
+        return;
+    }
+
+    LastPreviewRefreshSeconds = FPlatformTime::Seconds();
+    bPreviewTaskInFlight = true;
+
+    const FIntPoint SourceSize = Frame.Resolution;
+    const FIntPoint PreviewSize = FPanoramaPreviewDownscaler::ComputePreviewSize(SourceSize, OutputSettings.PreviewScale);
+    const bool bIs16Bit = Frame.bIs16Bit;
+    TSharedPtr<const TArray<uint8>, ESPMode::ThreadSafe> Payload = Frame.Payload;
+    TWeakObjectPtr<UPanoramaCaptureController> WeakThis(this);
+
+    Async(EAsyncExecution::ThreadPool, [WeakThis, Payload, SourceSize, PreviewSize, bIs16Bit]()
+    {
+        TArray<uint8> PreviewPixels;
+        FPanoramaPreviewDownscaler::DownscaleToBGRA8(Payload->GetData(), SourceSize, bIs16Bit, PreviewSize, PreviewPixels);
+
+        AsyncTask(ENamedThreads::GameThread, [WeakThis, PreviewSize, PreviewPixels = MoveTemp(PreviewPixels)]() mutable
         {
-            const int32 SrcY = FMath::Clamp(static_cast<int32>(Y * StepY), 0, SourceHeight - 1);
-            for (int32 X = 0; X < PreviewWidth; ++X)
+            if (UPanoramaCaptureController* Controller = WeakThis.Get())
             {
-                const int32 SrcX = FMath::Clamp(static_cast<int32>(X * StepX), 0, SourceWidth - 1);
-                const int32 SrcIndex = (SrcY * SourceWidth + SrcX) * 4;
-                const int32 DstIndex = (Y * PreviewWidth + X) * 4;
-                PreviewPixels[DstIndex + 0] = SourceData[SrcIndex + 2];
-                PreviewPixels[DstIndex + 1] = SourceData[SrcIndex + 1];
-                PreviewPixels[DstIndex + 2] = SourceData[SrcIndex + 0];
-                PreviewPixels[DstIndex + 3] = SourceData[SrcIndex + 3];
+                Controller->ApplyPreviewPixels(PreviewSize, MoveTemp(PreviewPixels));
             }
-        }
-    }
+        });
+    });
+}
+
+void UPanoramaCaptureController::ApplyPreviewPixels(const FIntPoint& PreviewSize, TArray<uint8>&& PreviewPixels)
+{
+    bPreviewTaskInFlight = false;
 
-    if (!PreviewTexture || PreviewTexture->GetSizeX() != PreviewWidth || PreviewTexture->GetSizeY() != PreviewHeight)
+    if (PreviewPixels.Num() != PreviewSize.X * PreviewSize.Y * 4)
     {
-        PreviewTexture = UTexture2D::CreateTransient(PreviewWidth, PreviewHeight, PF_B8G8R8A8);
-        PreviewTexture->SRGB = true;
+        return;
     }
 
-    if (PreviewTexture && PreviewTexture->GetPlatformData() && PreviewTexture->GetPlatformData()->Mips.Num() > 0)
+    // The texture and its RHI resource are created once per preview size; later frames only stream a region update.
+    if (!PreviewTexture || PreviewTexture->GetSizeX() != PreviewSize.X || PreviewTexture->GetSizeY() != PreviewSize.Y)
     {
-        FTexture2DMipMap& Mip = PreviewTexture->GetPlatformData()->Mips[0];
-        void* TextureData = Mip.BulkData.Lock(LOCK_READ_WRITE);
-        FMemory::Memcpy(TextureData, PreviewPixels.GetData(), PreviewPixels.Num());
-        Mip.BulkData.Unlock();
+        PreviewTexture = UTexture2D::CreateTransient(PreviewSize.X, PreviewSize.Y, PF_B8G8R8A8);
+        if (!PreviewTexture)
+        {
+            return;
+        }
+        PreviewTexture->SRGB = true;
         PreviewTexture->UpdateResource();
     }
+
+    TArray<uint8>* RegionData = new TArray<uint8>(MoveTemp(PreviewPixels));
+    FUpdateTextureRegion2D* Region = new FUpdateTextureRegion2D(0, 0, 0, 0, PreviewSize.X, PreviewSize.Y);
+    PreviewTexture->UpdateTextureRegions(0, 1, Region, PreviewSize.X * 4, 4, RegionData->GetData(),
+        [RegionData](uint8*, const FUpdateTextureRegion2D* InRegions)
+        {
+            delete RegionData;
+            delete InRegions;
+        });
+
+    OnPreviewUpdated().Broadcast(this);
 }
 
 void UPanoramaCaptureController::UpdateStatus(FName NewStatus)
@@ -793,6 +1653,16 @@ void UPanoramaCaptureController::UpdateStatus(FName NewStatus)
         StatusLabel += FString::Printf(TEXT("|Block:%d"), BlockedCount);
     }
 
+    if (ElidedFrameCount > 0)
+    {
+        StatusLabel += FString::Printf(TEXT("|Elide:%d"), ElidedFrameCount);
+    }
+
+    if (GetResolutionScale() < 1.f)
+    {
+        StatusLabel += FString::Printf(TEXT("|Res:%d%%"), FMath::RoundToInt(GetResolutionScale() * 100.f));
+    }
+
     if (ActiveEncoder.IsValid())
     {
         const FPanoramaVideoEncoderStats EncoderStats = ActiveEncoder->GetStats();
@@ -856,6 +1726,20 @@ void UPanoramaCaptureController::InitializeRingBuffer()
     }
 
     FrameBuffer.Initialize(TargetCapacity, OutputSettings.RingBufferPolicy);
+
+    // One payload per ring slot is allocated here; preview-only readbacks are 8-bit, and a GPU preview reads nothing back.
+    const FIntPoint OutputResolution = FPanoramaOutputLayout::GetOutputResolution(OutputSettings);
+    int32 PayloadBytes = 0;
+    if (OutputSettings.OutputPath == ECaptureOutputPath::PNGSequence)
+    {
+        PayloadBytes = OutputResolution.X * OutputResolution.Y * (OutputSettings.bUse16BitPNG ? sizeof(uint16) * 4 : 4);
+    }
+    else if (OutputSettings.bEnablePreview && !UsesGPUPreview())
+    {
+        PayloadBytes = OutputResolution.X * OutputResolution.Y * 4;
+    }
+
+    PayloadPool->Initialize(TargetCapacity, PayloadBytes);
 }
 
 void UPanoramaCaptureController::InitializeOutputDirectory()
@@ -950,6 +1834,8 @@ void UPanoramaCaptureController::ShutdownAudioCapture()
 
 void UPanoramaCaptureController::FinalizeCaptureOutputs()
 {
+    ResolveFingerprintedFrames(true);
+
     for (TFuture<void>& Task : PendingWriteTasks)
     {
         Task.Wait();
@@ -992,12 +1878,24 @@ void UPanoramaCaptureController::FinalizeCaptureOutputs()
             }
         }
 
+        // Trailing repeats have no following unique frame to bound them, so the last entry carries their span explicitly.
+        if (LastElidedFrameTime.IsSet() && TimeCount > 0)
+        {
+            const double Duration = (LastElidedFrameTime.GetValue() - CapturedFrameTimes.Last()) + DefaultDuration;
+            ConcatBuilder.Appendf(TEXT("duration %.6f\n"), FMath::Max(Duration, DefaultDuration));
+        }
+
         if (FrameCount > 0)
         {
             const FString AbsolutePath = FPaths::ConvertRelativePathToFull(CapturedFrameFiles.Last());
             ConcatBuilder.Appendf(TEXT("file '%s'\n"), *AbsolutePath);
         }
 
+        if (ElidedFrameCount > 0)
+        {
+            UE_LOG(LogPanoramaCapture, Log, TEXT("Elided %d duplicate frames (%d unique PNG frames written)."), ElidedFrameCount, FrameCount);
+        }
+
         const FString ConcatFile = FPaths::Combine(ActiveCaptureDirectory, TEXT("frames.ffconcat"));
         if (!FFileHelper::SaveStringToFile(ConcatBuilder.ToString(), *ConcatFile))
         {
@@ -1139,6 +2037,12 @@ bool UPanoramaCaptureController::AssembleWithFFmpeg(const FString& VideoInputArg
     }
 
     UE_LOG(LogPanoramaCapture, Log, TEXT("FFmpeg assembled output '%s'."), *OutputFile);
+
+    const FString SpatialMetadataFile = FPaths::ChangeExtension(OutputFile, TEXT("spatial.json"));
+    if (!FFileHelper::SaveStringToFile(FPanoramaOutputLayout::BuildSpatialMetadata(OutputSettings), *SpatialMetadataFile))
+    {
+        UE_LOG(LogPanoramaCapture, Warning, TEXT("Failed to write spatial metadata '%s'."), *SpatialMetadataFile);
+    }
     return true;
 }
 
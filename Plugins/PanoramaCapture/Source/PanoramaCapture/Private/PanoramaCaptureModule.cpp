@@ -5,6 +5,7 @@
 #include "Interfaces/IPluginManager.h"
 #include "Misc/Paths.h"
 #include "Modules/ModuleManager.h"
+#include "PanoramaProjectionLUT.h"
 #include "ShaderCore.h"
 
 DEFINE_LOG_CATEGORY(LogPanoramaCapture);
@@ -25,6 +26,9 @@ void FPanoramaCaptureModule::StartupModule()
 
 void FPanoramaCaptureModule::ShutdownModule()
 {
+    // The cache is a function static that would otherwise hold its GPU textures past RHI shutdown.
+    FPanoramaProjectionLUTCache::Get().Empty();
+
     if (bShaderDirectoryRegistered)
     {
         RemoveShaderSourceDirectoryMapping(TEXT("/PanoramaCapture"));
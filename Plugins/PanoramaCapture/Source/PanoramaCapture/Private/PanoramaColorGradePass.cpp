@@ -0,0 +1,89 @@
+#include "PanoramaColorGradePass.h"
+
+#include "GlobalShader.h"
+#include "PanoramaCaptureModule.h"
+#include "RenderGraphBuilder.h"
+#include "RenderGraphUtils.h"
+#include "RenderGraphResources.h"
+#include "ShaderParameterStruct.h"
+#include "ShaderParameterUtils.h"
+#include "ShaderCompilerCore.h"
+#include "ComputeShaderUtils.h"
+#include "RenderGraphEvent.h"
+
+DECLARE_GPU_STAT_NAMED(PanoramaColorGrade, TEXT("Panorama Color Grade"));
+
+class FPanoramaColorGradeCS : public FGlobalShader
+{
+public:
+    DECLARE_GLOBAL_SHADER(FPanoramaColorGradeCS);
+    SHADER_USE_PARAMETER_STRUCT(FPanoramaColorGradeCS, FGlobalShader);
+
+    static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+    {
+        return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+    }
+
+    BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+        SHADER_PARAMETER(FVector2f, OutputResolution)
+        SHADER_PARAMETER(float, Exposure)
+        SHADER_PARAMETER(uint32, Tonemapper)
+        SHADER_PARAMETER(float, ColorGradingIntensity)
+        SHADER_PARAMETER(uint32, bApplyLUT)
+        SHADER_PARAMETER(uint32, bLinear)
+        SHADER_PARAMETER_RDG_TEXTURE(Texture2D, ColorGradingLUT)
+        SHADER_PARAMETER_SAMPLER(SamplerState, ColorGradingLUTSampler)
+        SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float4>, OutputTexture)
+    END_SHADER_PARAMETER_STRUCT()
+};
+
+IMPLEMENT_GLOBAL_SHADER(FPanoramaColorGradeCS, "/PanoramaCapture/Private/PanoramaColorGrade.usf", "MainCS", SF_Compute);
+
+FPanoramaColorGradeParams FPanoramaColorGradeParams::FromSettings(const FPanoramaColorGradingSettings& Settings, FRDGTextureRef Target, const FIntPoint& Resolution, bool bLinearOutput)
+{
+    FPanoramaColorGradeParams Params;
+    Params.Target = Target;
+    Params.Resolution = Resolution;
+    Params.Exposure = FMath::Pow(2.f, FMath::Clamp(Settings.ExposureCompensation, -10.f, 10.f));
+    Params.Tonemapper = Settings.Tonemapper;
+    Params.ColorGradingIntensity = FMath::Clamp(Settings.ColorGradingIntensity, 0.f, 1.f);
+    Params.bLinearOutput = bLinearOutput;
+    return Params;
+}
+
+void FPanoramaColorGradePass::AddComputePass(FRDGBuilder& GraphBuilder, const FPanoramaColorGradeParams& Params)
+{
+    if (!Params.Target || Params.Resolution.X <= 0 || Params.Resolution.Y <= 0)
+    {
+        return;
+    }
+
+    RDG_GPU_STAT_SCOPE(GraphBuilder, PanoramaColorGrade);
+
+    FPanoramaColorGradeCS::FParameters* PassParameters = GraphBuilder.AllocParameters<FPanoramaColorGradeCS::FParameters>();
+    PassParameters->OutputResolution = FVector2f(Params.Resolution);
+    PassParameters->Exposure = Params.Exposure;
+    PassParameters->Tonemapper = static_cast<uint32>(Params.Tonemapper);
+    PassParameters->ColorGradingIntensity = Params.ColorGradingIntensity;
+    PassParameters->bApplyLUT = Params.ColorGradingLUT ? 1u : 0u;
+    PassParameters->bLinear = Params.bLinearOutput ? 1u : 0u;
+    PassParameters->OutputTexture = GraphBuilder.CreateUAV(Params.Target);
+    PassParameters->ColorGradingLUTSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+
+    FRDGTextureRef ColorGradingLUT = Params.ColorGradingLUT;
+    if (!ColorGradingLUT)
+    {
+        ColorGradingLUT = GraphBuilder.CreateTexture(FRDGTextureDesc::Create2D(FIntPoint(1, 1), PF_B8G8R8A8, FClearValueBinding::Black, TexCreate_ShaderResource | TexCreate_UAV), TEXT("PanoramaColorGradingLUTDummy"));
+        AddClearUAVPass(GraphBuilder, GraphBuilder.CreateUAV(ColorGradingLUT), FLinearColor::Black);
+    }
+    PassParameters->ColorGradingLUT = ColorGradingLUT;
+
+    TShaderMapRef<FPanoramaColorGradeCS> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+
+    const FIntVector GroupCount(
+        FMath::DivideAndRoundUp(Params.Resolution.X, 8),
+        FMath::DivideAndRoundUp(Params.Resolution.Y, 8),
+        1);
+
+    FComputeShaderUtils::AddPass(GraphBuilder, RDG_EVENT_NAME("Panorama::ColorGrade"), ComputeShader, PassParameters, GroupCount);
+}
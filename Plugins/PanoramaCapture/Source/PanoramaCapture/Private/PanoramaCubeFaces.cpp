@@ -0,0 +1,108 @@
+#include "PanoramaCubeFaces.h"
+
+#include "RenderGraphBuilder.h"
+#include "RenderGraphUtils.h"
+
+bool FPanoramaCubeFaces::IsValid() const
+{
+    if (FaceSize <= 0)
+    {
+        return false;
+    }
+
+    bool bHasFace = false;
+    for (int32 FaceIndex = 0; FaceIndex < PanoramaProjection::FacesPerEye; ++FaceIndex)
+    {
+        if (!Left[FaceIndex])
+        {
+            continue;
+        }
+        if (bStereo && !Right[FaceIndex] && (SharedFaceMask & (1u << FaceIndex)) == 0)
+        {
+            return false;
+        }
+        bHasFace = true;
+    }
+    return bHasFace;
+}
+
+void PanoramaCubeFaces::SetupParameters(FRDGBuilder& GraphBuilder, const FPanoramaCubeFaces& Faces, FPanoramaCubeFaceParameters& OutParameters)
+{
+    using namespace PanoramaProjection;
+
+    FRDGTextureRef BlackFace = nullptr;
+    auto ResolveFace = [&GraphBuilder, &BlackFace](FRDGTextureRef Face)
+    {
+        if (Face)
+        {
+            return Face;
+        }
+        if (!BlackFace)
+        {
+            BlackFace = GraphBuilder.CreateTexture(FRDGTextureDesc::Create2D(FIntPoint(1, 1), PF_FloatRGBA, FClearValueBinding::Black, TexCreate_ShaderResource | TexCreate_UAV), TEXT("PanoramaFaceDummy"));
+            AddClearUAVPass(GraphBuilder, GraphBuilder.CreateUAV(BlackFace), FLinearColor::Black);
+        }
+        return BlackFace;
+    };
+
+    FRDGTextureRef Slots[FacesPerEye * 2];
+    for (int32 FaceIndex = 0; FaceIndex < FacesPerEye; ++FaceIndex)
+    {
+        Slots[FaceIndex] = ResolveFace(Faces.Left[FaceIndex]);
+        Slots[FacesPerEye + FaceIndex] = Faces.Right[FaceIndex] ? Faces.Right[FaceIndex] : Slots[FaceIndex];
+    }
+
+    // Both eyes share a face's quality profile, so the left face stands for the slice. The shader wants the
+    // interior edge; FaceUVRects carries the border.
+    float FaceSizes[FacesPerEye];
+    for (int32 FaceIndex = 0; FaceIndex < FacesPerEye; ++FaceIndex)
+    {
+        int32 InteriorSize = Faces.Left[FaceIndex] ? Faces.Left[FaceIndex]->Desc.Extent.X - 2 * FaceBorderTexels : Faces.FaceSize;
+        if (Faces.RegionFaceSizes[FaceIndex] > 0)
+        {
+            InteriorSize = Faces.RegionFaceSizes[FaceIndex];
+        }
+        FaceSizes[FaceIndex] = static_cast<float>(FMath::Max(InteriorSize, 1));
+    }
+    OutParameters.FaceSizes[0] = FVector4f(FaceSizes[0], FaceSizes[1], FaceSizes[2], FaceSizes[3]);
+    OutParameters.FaceSizes[1] = FVector4f(FaceSizes[4], FaceSizes[5], 0.f, 0.f);
+
+    for (int32 Slot = 0; Slot < FacesPerEye * 2; ++Slot)
+    {
+        const int32 FaceIndex = Slot % FacesPerEye;
+        // A right slot without its own face samples the left one, so it takes the left face's rectangle too.
+        const int32 SourceSlot = (Slot >= FacesPerEye && !Faces.Right[FaceIndex]) ? FaceIndex : Slot;
+        const FRDGTextureRef SourceFace = SourceSlot < FacesPerEye ? Faces.Left[FaceIndex] : Faces.Right[FaceIndex];
+        const FBox2f& Region = Faces.Regions[SourceSlot];
+
+        FVector2f RectMin;
+        FVector2f RectSize;
+        if (SourceFace && Region.bIsValid)
+        {
+            RectMin = Region.Min;
+            RectSize = Region.GetSize();
+        }
+        else
+        {
+            // The whole face, with its border texels just outside 0-1.
+            const float Border = static_cast<float>(FaceBorderTexels) / FaceSizes[FaceIndex];
+            RectMin = FVector2f(-Border);
+            RectSize = FVector2f(1.f + 2.f * Border);
+        }
+        OutParameters.FaceUVRects[Slot] = FVector4f(RectMin.X, RectMin.Y, 1.f / FMath::Max(RectSize.X, UE_SMALL_NUMBER), 1.f / FMath::Max(RectSize.Y, UE_SMALL_NUMBER));
+    }
+
+    OutParameters.FaceTexture0 = Slots[0];
+    OutParameters.FaceTexture1 = Slots[1];
+    OutParameters.FaceTexture2 = Slots[2];
+    OutParameters.FaceTexture3 = Slots[3];
+    OutParameters.FaceTexture4 = Slots[4];
+    OutParameters.FaceTexture5 = Slots[5];
+    OutParameters.FaceTexture6 = Slots[6];
+    OutParameters.FaceTexture7 = Slots[7];
+    OutParameters.FaceTexture8 = Slots[8];
+    OutParameters.FaceTexture9 = Slots[9];
+    OutParameters.FaceTexture10 = Slots[10];
+    OutParameters.FaceTexture11 = Slots[11];
+    OutParameters.FaceSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+}
@@ -0,0 +1,87 @@
+#include "PanoramaDepthCompositePass.h"
+
+#include "GlobalShader.h"
+#include "PanoramaCaptureModule.h"
+#include "RenderGraphBuilder.h"
+#include "RenderGraphUtils.h"
+#include "RenderGraphResources.h"
+#include "ShaderParameterStruct.h"
+#include "ShaderParameterUtils.h"
+#include "ShaderCompilerCore.h"
+#include "ComputeShaderUtils.h"
+#include "RenderGraphEvent.h"
+
+DECLARE_GPU_STAT_NAMED(PanoramaDepthComposite, TEXT("Panorama Depth Composite"));
+
+class FPanoramaDepthCompositeCS : public FGlobalShader
+{
+public:
+    DECLARE_GLOBAL_SHADER(FPanoramaDepthCompositeCS);
+    SHADER_USE_PARAMETER_STRUCT(FPanoramaDepthCompositeCS, FGlobalShader);
+
+    static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+    {
+        return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+    }
+
+    BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+        SHADER_PARAMETER(FUintVector2, FaceSize)
+        SHADER_PARAMETER(float, FarFieldDistance)
+        SHADER_PARAMETER_RDG_TEXTURE(Texture2D<float4>, NearFieldTexture)
+        SHADER_PARAMETER_RDG_TEXTURE(Texture2D<float4>, FarFieldTexture)
+        SHADER_PARAMETER_SAMPLER(SamplerState, FarFieldSampler)
+        SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float4>, OutputTexture)
+    END_SHADER_PARAMETER_STRUCT()
+};
+
+IMPLEMENT_GLOBAL_SHADER(FPanoramaDepthCompositeCS, "/PanoramaCapture/Private/PanoramaDepthComposite.usf", "MainCS", SF_Compute);
+
+FRDGTextureRef FPanoramaDepthCompositePass::AddComputePass(FRDGBuilder& GraphBuilder, const FPanoramaDepthCompositeParams& Params)
+{
+    if (!Params.NearField || !Params.FarField)
+    {
+        return nullptr;
+    }
+
+    RDG_GPU_STAT_SCOPE(GraphBuilder, PanoramaDepthComposite);
+
+    const FIntPoint FaceSize = Params.NearField->Desc.Extent;
+    FRDGTextureRef Output = GraphBuilder.CreateTexture(FRDGTextureDesc::Create2D(FaceSize, PF_FloatRGBA, FClearValueBinding::Black, TexCreate_ShaderResource | TexCreate_UAV), TEXT("PanoramaCompositedFace"));
+
+    FPanoramaDepthCompositeCS::FParameters* PassParameters = GraphBuilder.AllocParameters<FPanoramaDepthCompositeCS::FParameters>();
+    PassParameters->FaceSize = FUintVector2(FaceSize.X, FaceSize.Y);
+    PassParameters->FarFieldDistance = Params.FarFieldDistance;
+    PassParameters->NearFieldTexture = Params.NearField;
+    PassParameters->FarFieldTexture = Params.FarField;
+    PassParameters->FarFieldSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+    PassParameters->OutputTexture = GraphBuilder.CreateUAV(Output);
+
+    TShaderMapRef<FPanoramaDepthCompositeCS> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+
+    const FIntVector GroupCount(
+        FMath::DivideAndRoundUp(FaceSize.X, 8),
+        FMath::DivideAndRoundUp(FaceSize.Y, 8),
+        1);
+
+    FComputeShaderUtils::AddPass(GraphBuilder, RDG_EVENT_NAME("Panorama::DepthComposite %dx%d", FaceSize.X, FaceSize.Y), ComputeShader, PassParameters, GroupCount);
+    return Output;
+}
+
+void FPanoramaDepthCompositePass::CompositeFaces(FRDGBuilder& GraphBuilder, FPanoramaCubeFaces& Faces, const FRDGTextureRef (&FarFieldFaces)[PanoramaProjection::FacesPerEye], float FarFieldDistance)
+{
+    for (int32 FaceIndex = 0; FaceIndex < PanoramaProjection::FacesPerEye; ++FaceIndex)
+    {
+        // A null right face keeps falling back to the left one, which is composited here already.
+        for (FRDGTextureRef* Face : { &Faces.Left[FaceIndex], &Faces.Right[FaceIndex] })
+        {
+            FPanoramaDepthCompositeParams Params;
+            Params.NearField = *Face;
+            Params.FarField = FarFieldFaces[FaceIndex];
+            Params.FarFieldDistance = FarFieldDistance;
+            if (FRDGTextureRef Composited = AddComputePass(GraphBuilder, Params))
+            {
+                *Face = Composited;
+            }
+        }
+    }
+}
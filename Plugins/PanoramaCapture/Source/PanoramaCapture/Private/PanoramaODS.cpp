@@ -0,0 +1,92 @@
+#include "PanoramaODS.h"
+
+namespace
+{
+    constexpr float EncodeGamma = 1.f / 2.2f;
+
+    FLinearColor SampleSliceBilinear(const FCubemapFaceImage& Image, const FVector2f& UV)
+    {
+        const float TexelX = UV.X * Image.Size.X - 0.5f;
+        const float TexelY = UV.Y * Image.Size.Y - 0.5f;
+        const int32 BaseX = FMath::FloorToInt(TexelX);
+        const int32 BaseY = FMath::FloorToInt(TexelY);
+        const float FracX = TexelX - BaseX;
+        const float FracY = TexelY - BaseY;
+
+        auto Fetch = [&Image](int32 X, int32 Y)
+        {
+            return Image.Pixels[FMath::Clamp(Y, 0, Image.Size.Y - 1) * Image.Size.X + FMath::Clamp(X, 0, Image.Size.X - 1)];
+        };
+
+        const FLinearColor Top = FMath::Lerp(Fetch(BaseX, BaseY), Fetch(BaseX + 1, BaseY), FracX);
+        const FLinearColor Bottom = FMath::Lerp(Fetch(BaseX, BaseY + 1), Fetch(BaseX + 1, BaseY + 1), FracX);
+        return FMath::Lerp(Top, Bottom, FracY);
+    }
+}
+
+bool FPanoramaODSStitchCPU::StitchReference(const FPanoramaODSStitchCPUParams& Params, TArray<FLinearColor>& OutPixels)
+{
+    using namespace PanoramaODS;
+
+    const int32 SliceCount = Params.SliceCount;
+    if (SliceCount < 1 || Params.OutputResolution.X <= 0 || Params.OutputResolution.Y <= 0 || Params.Slices.Num() < SliceCount * 2 * PitchRows)
+    {
+        return false;
+    }
+
+    for (const FCubemapFaceImage& Slice : Params.Slices)
+    {
+        if (!Slice.IsValid())
+        {
+            return false;
+        }
+    }
+
+    const FIntPoint EyeResolution = Params.bStereoOverUnder
+        ? FIntPoint(Params.OutputResolution.X, FMath::Max(1, Params.OutputResolution.Y / 2))
+        : FIntPoint(FMath::Max(1, Params.OutputResolution.X / 2), Params.OutputResolution.Y);
+    const float SliceSpacing = GetSliceSpacing(SliceCount);
+
+    OutPixels.SetNumUninitialized(Params.OutputResolution.X * Params.OutputResolution.Y);
+
+    for (int32 Y = 0; Y < Params.OutputResolution.Y; ++Y)
+    {
+        for (int32 X = 0; X < Params.OutputResolution.X; ++X)
+        {
+            const int32 EyeIndex = Params.bStereoOverUnder ? (Y >= EyeResolution.Y ? 1 : 0) : (X >= EyeResolution.X ? 1 : 0);
+            const FIntPoint EyePixel = Params.bStereoOverUnder ? FIntPoint(X, Y - EyeIndex * EyeResolution.Y) : FIntPoint(X - EyeIndex * EyeResolution.X, Y);
+            const float U = Params.LongitudeRange.X + (EyePixel.X + 0.5f) / EyeResolution.X * Params.LongitudeRange.Y;
+            const float V = Params.LatitudeRange.X + (EyePixel.Y + 0.5f) / EyeResolution.Y * Params.LatitudeRange.Y;
+            const float Yaw = GetYawFromEquirectU(U);
+            const float Pitch = GetPitchFromEquirectV(V);
+            const int32 Row = GetRowForPitch(Pitch);
+
+            // Only the two slices either side of the column carry weight.
+            const int32 FirstSlice = FMath::FloorToInt(FMath::Fmod(Yaw + 4.f * UE_PI, 2.f * UE_PI) / SliceSpacing) % SliceCount;
+
+            FLinearColor Sum(0.f, 0.f, 0.f, 0.f);
+            for (int32 Offset = 0; Offset < 2; ++Offset)
+            {
+                const int32 SliceIndex = (FirstSlice + Offset) % SliceCount;
+                const float SliceYaw = GetSliceYaw(SliceIndex, SliceCount);
+                const float Weight = GetSliceWeight(Yaw, SliceYaw, SliceSpacing);
+
+                FVector2f SliceUV;
+                if (Weight > 0.f && ProjectToSlice(Yaw, Pitch, SliceYaw, Row, Params.SliceTanHalfFov, SliceUV))
+                {
+                    Sum += SampleSliceBilinear(Params.Slices[(SliceIndex * 2 + EyeIndex) * PitchRows + Row], SliceUV) * Weight;
+                }
+            }
+
+            if (!Params.bLinearGamma)
+            {
+                Sum.R = FMath::Pow(FMath::Clamp(Sum.R, 0.f, 1.f), EncodeGamma);
+                Sum.G = FMath::Pow(FMath::Clamp(Sum.G, 0.f, 1.f), EncodeGamma);
+                Sum.B = FMath::Pow(FMath::Clamp(Sum.B, 0.f, 1.f), EncodeGamma);
+            }
+            OutPixels[Y * Params.OutputResolution.X + X] = Sum;
+        }
+    }
+
+    return true;
+}
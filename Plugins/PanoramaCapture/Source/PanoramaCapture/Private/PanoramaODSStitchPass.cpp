@@ -0,0 +1,170 @@
+#include "PanoramaODSStitchPass.h"
+
+#include "GlobalShader.h"
+#include "PanoramaCaptureModule.h"
+#include "RenderGraphBuilder.h"
+#include "RenderGraphUtils.h"
+#include "ShaderParameterStruct.h"
+#include "ShaderParameterUtils.h"
+#include "ShaderCompilerCore.h"
+#include "ComputeShaderUtils.h"
+#include "RenderGraphEvent.h"
+
+DECLARE_GPU_STAT_NAMED(PanoramaODSStitch, TEXT("Panorama ODS Stitch"));
+
+class FODSStitchSliceCS : public FGlobalShader
+{
+public:
+    DECLARE_GLOBAL_SHADER(FODSStitchSliceCS);
+    SHADER_USE_PARAMETER_STRUCT(FODSStitchSliceCS, FGlobalShader);
+
+    static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+    {
+        return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+    }
+
+    BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+        SHADER_PARAMETER(FIntPoint, EyeResolution)
+        SHADER_PARAMETER(FVector2f, LatitudeRange)
+        SHADER_PARAMETER(FVector2f, LongitudeRange)
+        SHADER_PARAMETER(uint32, bStereoOverUnder)
+        SHADER_PARAMETER(int32, ColumnStart)
+        SHADER_PARAMETER(uint32, bWrapColumns)
+        SHADER_PARAMETER(float, SliceYaw)
+        SHADER_PARAMETER(float, SliceSpacing)
+        SHADER_PARAMETER(FVector2f, SliceTanHalfFov)
+        SHADER_PARAMETER_RDG_TEXTURE(Texture2D, LeftRow0)
+        SHADER_PARAMETER_RDG_TEXTURE(Texture2D, LeftRow1)
+        SHADER_PARAMETER_RDG_TEXTURE(Texture2D, LeftRow2)
+        SHADER_PARAMETER_RDG_TEXTURE(Texture2D, RightRow0)
+        SHADER_PARAMETER_RDG_TEXTURE(Texture2D, RightRow1)
+        SHADER_PARAMETER_RDG_TEXTURE(Texture2D, RightRow2)
+        SHADER_PARAMETER_SAMPLER(SamplerState, SliceSampler)
+        SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float4>, AccumulationTexture)
+    END_SHADER_PARAMETER_STRUCT()
+};
+
+class FODSStitchResolveCS : public FGlobalShader
+{
+public:
+    DECLARE_GLOBAL_SHADER(FODSStitchResolveCS);
+    SHADER_USE_PARAMETER_STRUCT(FODSStitchResolveCS, FGlobalShader);
+
+    static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+    {
+        return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+    }
+
+    BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+        SHADER_PARAMETER(FVector2f, OutputResolution)
+        SHADER_PARAMETER(uint32, bLinear)
+        SHADER_PARAMETER_RDG_TEXTURE(Texture2D<float4>, ResolveSource)
+        SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float4>, OutputTexture)
+    END_SHADER_PARAMETER_STRUCT()
+};
+
+IMPLEMENT_GLOBAL_SHADER(FODSStitchSliceCS, "/PanoramaCapture/Private/ODSStitch.usf", "SliceCS", SF_Compute);
+IMPLEMENT_GLOBAL_SHADER(FODSStitchResolveCS, "/PanoramaCapture/Private/ODSStitch.usf", "ResolveCS", SF_Compute);
+
+bool FPanoramaODSSliceTextures::IsValid() const
+{
+    for (const FRDGTextureRef (&EyeRows)[PanoramaODS::PitchRows] : Rows)
+    {
+        for (FRDGTextureRef Row : EyeRows)
+        {
+            if (!Row)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+FRDGTextureDesc FPanoramaODSStitchPass::CreateAccumulationDesc(const FIntPoint& OutputResolution)
+{
+    return FRDGTextureDesc::Create2D(OutputResolution, PF_FloatRGBA, FClearValueBinding::Transparent, TexCreate_ShaderResource | TexCreate_UAV);
+}
+
+void FPanoramaODSStitchPass::AddSlicePass(FRDGBuilder& GraphBuilder, const FPanoramaODSStitchParams& Params, const FPanoramaODSSliceTextures& Slice)
+{
+    if (!Params.Accumulation || !Slice.IsValid() || Params.SliceCount < 1)
+    {
+        return;
+    }
+
+    RDG_GPU_STAT_SCOPE(GraphBuilder, PanoramaODSStitch);
+
+    const FIntPoint EyeResolution = Params.bStereoOverUnder
+        ? FIntPoint(Params.OutputResolution.X, FMath::Max(1, Params.OutputResolution.Y / 2))
+        : FIntPoint(FMath::Max(1, Params.OutputResolution.X / 2), Params.OutputResolution.Y);
+    const float SliceSpacing = PanoramaODS::GetSliceSpacing(Params.SliceCount);
+    const float SliceYaw = PanoramaODS::GetSliceYaw(Slice.SliceIndex, Params.SliceCount);
+
+    // The slice covers yaws within one spacing of its own, which is a band of output columns around its centre U.
+    // Yaw decreases with U, so the band starts at the highest yaw. A full 360 eye wraps the band around the seam.
+    const float LongitudeExtent = FMath::Max(Params.LongitudeRange.Y, UE_KINDA_SMALL_NUMBER);
+    const float CenterU = FMath::Frac(0.75f - SliceYaw / (2.f * UE_PI));
+    const float BandStartU = CenterU - SliceSpacing / (2.f * UE_PI);
+    const bool bWrapColumns = LongitudeExtent >= 1.f;
+    const int32 ColumnStart = FMath::FloorToInt((BandStartU - Params.LongitudeRange.X) / LongitudeExtent * EyeResolution.X) - 1;
+    int32 ColumnCount = FMath::CeilToInt(SliceSpacing / UE_PI / LongitudeExtent * EyeResolution.X) + 3;
+    if (bWrapColumns)
+    {
+        // Wrapped columns past a full turn would add the same slice twice.
+        ColumnCount = FMath::Min(ColumnCount, EyeResolution.X);
+    }
+
+    FODSStitchSliceCS::FParameters* PassParameters = GraphBuilder.AllocParameters<FODSStitchSliceCS::FParameters>();
+    PassParameters->EyeResolution = EyeResolution;
+    PassParameters->LatitudeRange = Params.LatitudeRange;
+    PassParameters->LongitudeRange = Params.LongitudeRange;
+    PassParameters->bStereoOverUnder = Params.bStereoOverUnder ? 1u : 0u;
+    PassParameters->ColumnStart = ColumnStart;
+    PassParameters->bWrapColumns = bWrapColumns ? 1u : 0u;
+    PassParameters->SliceYaw = SliceYaw;
+    PassParameters->SliceSpacing = SliceSpacing;
+    PassParameters->SliceTanHalfFov = Params.SliceTanHalfFov;
+    PassParameters->LeftRow0 = Slice.Rows[0][0];
+    PassParameters->LeftRow1 = Slice.Rows[0][1];
+    PassParameters->LeftRow2 = Slice.Rows[0][2];
+    PassParameters->RightRow0 = Slice.Rows[1][0];
+    PassParameters->RightRow1 = Slice.Rows[1][1];
+    PassParameters->RightRow2 = Slice.Rows[1][2];
+    PassParameters->SliceSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+    PassParameters->AccumulationTexture = GraphBuilder.CreateUAV(Params.Accumulation);
+
+    TShaderMapRef<FODSStitchSliceCS> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+
+    const FIntVector GroupCount(
+        FMath::DivideAndRoundUp(ColumnCount, 8),
+        FMath::DivideAndRoundUp(EyeResolution.Y, 8),
+        2);
+
+    FComputeShaderUtils::AddPass(GraphBuilder, RDG_EVENT_NAME("Panorama::ODSStitchSlice %d", Slice.SliceIndex), ComputeShader, PassParameters, GroupCount);
+}
+
+void FPanoramaODSStitchPass::AddResolvePass(FRDGBuilder& GraphBuilder, FRDGTextureRef Accumulation, FRDGTextureRef Destination, const FIntPoint& OutputResolution, bool bLinearGamma)
+{
+    if (!Accumulation || !Destination)
+    {
+        return;
+    }
+
+    RDG_GPU_STAT_SCOPE(GraphBuilder, PanoramaODSStitch);
+
+    FODSStitchResolveCS::FParameters* PassParameters = GraphBuilder.AllocParameters<FODSStitchResolveCS::FParameters>();
+    PassParameters->OutputResolution = FVector2f(OutputResolution);
+    PassParameters->bLinear = bLinearGamma ? 1u : 0u;
+    PassParameters->ResolveSource = Accumulation;
+    PassParameters->OutputTexture = GraphBuilder.CreateUAV(Destination);
+
+    TShaderMapRef<FODSStitchResolveCS> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+
+    const FIntVector GroupCount(
+        FMath::DivideAndRoundUp(OutputResolution.X, 8),
+        FMath::DivideAndRoundUp(OutputResolution.Y, 8),
+        1);
+
+    FComputeShaderUtils::AddPass(GraphBuilder, RDG_EVENT_NAME("Panorama::ODSStitchResolve"), ComputeShader, PassParameters, GroupCount);
+}
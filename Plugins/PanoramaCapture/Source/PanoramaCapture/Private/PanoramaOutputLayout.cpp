@@ -0,0 +1,221 @@
+#include "PanoramaOutputLayout.h"
+
+#include "PanoramaProjectionLUT.h"
+#include "PanoramaProjectionMath.h"
+
+namespace
+{
+    constexpr int32 CoverageSamplesX = 256;
+    constexpr int32 CoverageSamplesY = 128;
+
+    int32 CoverageSampleCoordinate(int32 SampleIndex, int32 SampleCount, int32 Extent)
+    {
+        return SampleCount > 1 ? FMath::Min(Extent - 1, static_cast<int32>((static_cast<int64>(SampleIndex) * (Extent - 1)) / (SampleCount - 1))) : 0;
+    }
+}
+
+FIntPoint FPanoramaOutputLayout::GetOutputResolution(const FCaptureOutputSettings& Settings)
+{
+    FIntPoint Resolution(FMath::Max(1, Settings.Resolution.Width), FMath::Max(1, Settings.Resolution.Height));
+    const EEquiLayout Layout = GetEffectiveLayout(Settings);
+
+    if (Settings.Projection == EPanoramaProjection::Equirectangular)
+    {
+        if (Layout == EEquiLayout::UpperHemisphere || Layout == EEquiLayout::LowerHemisphere)
+        {
+            Resolution.Y = FMath::Max(1, Resolution.Y / 2);
+        }
+        else if (Layout == EEquiLayout::VR180)
+        {
+            Resolution.X = FMath::Max(1, Resolution.X / 2);
+        }
+    }
+    else if (Settings.Projection == EPanoramaProjection::Domemaster)
+    {
+        // Each eye is the largest square that fits its share of Resolution; VR180 only spans half of the eye's 360 degree width.
+        const bool bOverUnder = Settings.StereoMode == EPanoramaStereoMode::StereoOverUnder;
+        const bool bSideBySide = Settings.StereoMode == EPanoramaStereoMode::StereoSideBySide;
+        const int32 EyeWidth = Resolution.X / (bSideBySide ? 2 : 1) / (Layout == EEquiLayout::VR180 ? 2 : 1);
+        const int32 Edge = FMath::Max(1, FMath::Min(EyeWidth, Resolution.Y / (bOverUnder ? 2 : 1)));
+        Resolution = FIntPoint(bSideBySide ? Edge * 2 : Edge, bOverUnder ? Edge * 2 : Edge);
+    }
+    return Resolution;
+}
+
+EEquiLayout FPanoramaOutputLayout::GetEffectiveLayout(const FCaptureOutputSettings& Settings)
+{
+    switch (Settings.Projection)
+    {
+    case EPanoramaProjection::Equirectangular:
+        return Settings.OutputLayout;
+    case EPanoramaProjection::Domemaster:
+        return Settings.OutputLayout == EEquiLayout::VR180 ? EEquiLayout::VR180 : EEquiLayout::Full360;
+    default:
+        return EEquiLayout::Full360;
+    }
+}
+
+FIntPoint FPanoramaOutputLayout::GetEyeResolution(const FCaptureOutputSettings& Settings)
+{
+    FIntPoint Resolution = GetOutputResolution(Settings);
+    if (Settings.StereoMode == EPanoramaStereoMode::StereoOverUnder)
+    {
+        Resolution.Y = FMath::Max(1, Resolution.Y / 2);
+    }
+    else if (Settings.StereoMode == EPanoramaStereoMode::StereoSideBySide)
+    {
+        Resolution.X = FMath::Max(1, Resolution.X / 2);
+    }
+    return Resolution;
+}
+
+float FPanoramaOutputLayout::GetFisheyeFieldOfView(const FCaptureOutputSettings& Settings)
+{
+    return FMath::Clamp(Settings.FisheyeFOV, 180.f, 220.f);
+}
+
+FVector2f FPanoramaOutputLayout::GetLatitudeRange(EEquiLayout Layout)
+{
+    switch (Layout)
+    {
+    case EEquiLayout::UpperHemisphere:
+        return FVector2f(0.f, 0.5f);
+    case EEquiLayout::LowerHemisphere:
+        return FVector2f(0.5f, 0.5f);
+    default:
+        return FVector2f(0.f, 1.f);
+    }
+}
+
+FVector2f FPanoramaOutputLayout::GetLongitudeRange(EEquiLayout Layout)
+{
+    // Forward (+Z) sits at U = 0.75, so the forward half spans U 0.5-1.
+    return Layout == EEquiLayout::VR180 ? FVector2f(0.5f, 0.5f) : FVector2f(0.f, 1.f);
+}
+
+FString FPanoramaOutputLayout::BuildSpatialMetadata(const FCaptureOutputSettings& Settings)
+{
+    const bool bEAC = Settings.Projection == EPanoramaProjection::EquiAngularCubemap;
+    const bool bFisheye = Settings.Projection == EPanoramaProjection::Domemaster;
+    const FIntPoint Resolution = GetOutputResolution(Settings);
+    const EEquiLayout EffectiveLayout = GetEffectiveLayout(Settings);
+    const bool bEquirect = Settings.Projection == EPanoramaProjection::Equirectangular;
+    const FVector2f LatitudeRange = bEquirect ? GetLatitudeRange(EffectiveLayout) : FVector2f(0.f, 1.f);
+    const FVector2f LongitudeRange = bEquirect ? GetLongitudeRange(EffectiveLayout) : FVector2f(0.f, 1.f);
+
+    const TCHAR* Projection = TEXT("equirectangular");
+    const TCHAR* Layout = TEXT("equirect");
+    if (bEAC)
+    {
+        Projection = TEXT("cubemap");
+        Layout = TEXT("eac_3x2");
+    }
+    else if (bFisheye)
+    {
+        Projection = TEXT("fisheye");
+        Layout = EffectiveLayout == EEquiLayout::VR180 ? TEXT("vr180_fisheye") : TEXT("domemaster");
+    }
+
+    const TCHAR* StereoMode = TEXT("mono");
+    if (Settings.StereoMode == EPanoramaStereoMode::StereoOverUnder)
+    {
+        StereoMode = TEXT("top-bottom");
+    }
+    else if (Settings.StereoMode == EPanoramaStereoMode::StereoSideBySide)
+    {
+        StereoMode = TEXT("left-right");
+    }
+
+    return FString::Printf(TEXT("{\n  \"projection\": \"%s\",\n  \"layout\": \"%s\",\n  \"stereo_mode\": \"%s\",\n  \"width\": %d,\n  \"height\": %d,\n  \"crop_top\": %.6f,\n  \"crop_bottom\": %.6f,\n  \"crop_left\": %.6f,\n  \"crop_right\": %.6f,\n  \"fov_degrees\": %.1f\n}\n"),
+        Projection,
+        Layout,
+        StereoMode,
+        Resolution.X,
+        Resolution.Y,
+        LatitudeRange.X,
+        1.f - (LatitudeRange.X + LatitudeRange.Y),
+        LongitudeRange.X,
+        1.f - (LongitudeRange.X + LongitudeRange.Y),
+        bFisheye ? GetFisheyeFieldOfView(Settings) : 360.f);
+}
+
+uint8 FPanoramaOutputLayout::ComputeFaceCoverageMask(const FPanoramaProjectionLUTKey& Key)
+{
+    return ComputeFaceCoverageMask(Key, FIntRect(FIntPoint::ZeroValue, Key.Resolution));
+}
+
+uint8 FPanoramaOutputLayout::ComputeFaceCoverageMask(const FPanoramaProjectionLUTKey& Key, const FIntRect& PixelRect)
+{
+    if (!Key.IsValid())
+    {
+        return AllFacesMask;
+    }
+
+    FIntRect Rect = PixelRect;
+    Rect.Clip(FIntRect(FIntPoint::ZeroValue, Key.Resolution));
+    if (Rect.Area() <= 0)
+    {
+        return 0;
+    }
+
+    const int32 SamplesX = FMath::Min(CoverageSamplesX, Rect.Width());
+    const int32 SamplesY = FMath::Min(CoverageSamplesY, Rect.Height());
+
+    uint8 Mask = 0;
+    for (int32 SampleY = 0; SampleY < SamplesY && Mask != AllFacesMask; ++SampleY)
+    {
+        const int32 Y = Rect.Min.Y + CoverageSampleCoordinate(SampleY, SamplesY, Rect.Height());
+        for (int32 SampleX = 0; SampleX < SamplesX; ++SampleX)
+        {
+            const int32 X = Rect.Min.X + CoverageSampleCoordinate(SampleX, SamplesX, Rect.Width());
+
+            int32 EyeIndex = 0;
+            FVector3f Direction;
+            if (FPanoramaProjectionLUT::EvaluatePixel(Key, FIntPoint(X, Y), EyeIndex, Direction))
+            {
+                FVector2f FaceUV;
+                Mask |= static_cast<uint8>(1u << PanoramaProjection::CubeFaceFromDirection(Direction, FaceUV));
+            }
+        }
+    }
+
+    return Mask;
+}
+
+void FPanoramaOutputLayout::ComputeFaceCoverageRects(const FPanoramaProjectionLUTKey& Key, const FIntRect& PixelRect, int32 SamplesPerAxis, TArrayView<FBox2f> OutRects)
+{
+    for (FBox2f& Rect : OutRects)
+    {
+        Rect.Init();
+    }
+
+    FIntRect Rect = PixelRect;
+    Rect.Clip(FIntRect(FIntPoint::ZeroValue, Key.Resolution));
+    if (!Key.IsValid() || Rect.Area() <= 0)
+    {
+        return;
+    }
+
+    const int32 SamplesX = FMath::Clamp(SamplesPerAxis, 1, Rect.Width());
+    const int32 SamplesY = FMath::Clamp(SamplesPerAxis, 1, Rect.Height());
+    for (int32 SampleY = 0; SampleY < SamplesY; ++SampleY)
+    {
+        const int32 Y = Rect.Min.Y + CoverageSampleCoordinate(SampleY, SamplesY, Rect.Height());
+        for (int32 SampleX = 0; SampleX < SamplesX; ++SampleX)
+        {
+            const int32 X = Rect.Min.X + CoverageSampleCoordinate(SampleX, SamplesX, Rect.Width());
+
+            int32 EyeIndex = 0;
+            FVector3f Direction;
+            if (FPanoramaProjectionLUT::EvaluatePixel(Key, FIntPoint(X, Y), EyeIndex, Direction))
+            {
+                FVector2f FaceUV;
+                const int32 Slot = EyeIndex * PanoramaProjection::FacesPerEye + PanoramaProjection::CubeFaceFromDirection(Direction, FaceUV);
+                if (OutRects.IsValidIndex(Slot))
+                {
+                    OutRects[Slot] += FaceUV;
+                }
+            }
+        }
+    }
+}
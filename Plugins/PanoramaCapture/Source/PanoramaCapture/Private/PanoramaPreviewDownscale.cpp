@@ -0,0 +1,162 @@
+#include "PanoramaPreviewDownscale.h"
+
+#include "Async/ParallelFor.h"
+
+#define PANORAMA_PREVIEW_SSE (PLATFORM_ENABLE_VECTORINTRINSICS && PLATFORM_CPU_X86_FAMILY)
+
+#if PANORAMA_PREVIEW_SSE
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    struct FBoxSpan
+    {
+        int32 Start = 0;
+        int32 End = 0;
+    };
+
+    void BuildSpans(int32 SourceExtent, int32 TargetExtent, TArray<FBoxSpan>& OutSpans)
+    {
+        OutSpans.SetNumUninitialized(TargetExtent);
+        for (int32 Index = 0; Index < TargetExtent; ++Index)
+        {
+            FBoxSpan& Span = OutSpans[Index];
+            Span.Start = static_cast<int32>((static_cast<int64>(Index) * SourceExtent) / TargetExtent);
+            Span.End = FMath::Max(Span.Start + 1, static_cast<int32>((static_cast<int64>(Index + 1) * SourceExtent) / TargetExtent));
+            Span.End = FMath::Min(Span.End, SourceExtent);
+        }
+    }
+
+#if PANORAMA_PREVIEW_SSE
+    FORCEINLINE __m128i LoadPixel8(const uint8* Pixel)
+    {
+        int32 Packed;
+        FMemory::Memcpy(&Packed, Pixel, sizeof(Packed));
+        const __m128i Zero = _mm_setzero_si128();
+        return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(Packed), Zero), Zero);
+    }
+
+    FORCEINLINE __m128i LoadPixel16(const uint16* Pixel)
+    {
+        return _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(Pixel)), _mm_setzero_si128());
+    }
+
+    template <bool bIs16Bit>
+    void DownscaleRowSSE(const uint8* Payload, int32 SourceWidth, const FBoxSpan& RowSpan, const TArray<FBoxSpan>& ColumnSpans, uint8* DestRow)
+    {
+        for (int32 X = 0; X < ColumnSpans.Num(); ++X)
+        {
+            const FBoxSpan& ColumnSpan = ColumnSpans[X];
+            __m128i Sum = _mm_setzero_si128();
+
+            for (int32 SourceY = RowSpan.Start; SourceY < RowSpan.End; ++SourceY)
+            {
+                const int64 RowOffset = static_cast<int64>(SourceY) * SourceWidth;
+                for (int32 SourceX = ColumnSpan.Start; SourceX < ColumnSpan.End; ++SourceX)
+                {
+                    if constexpr (bIs16Bit)
+                    {
+                        Sum = _mm_add_epi32(Sum, LoadPixel16(reinterpret_cast<const uint16*>(Payload) + (RowOffset + SourceX) * 4));
+                    }
+                    else
+                    {
+                        Sum = _mm_add_epi32(Sum, LoadPixel8(Payload + (RowOffset + SourceX) * 4));
+                    }
+                }
+            }
+
+            const int32 Count = (RowSpan.End - RowSpan.Start) * (ColumnSpan.End - ColumnSpan.Start);
+            const float Scale = (bIs16Bit ? (255.f / 65535.f) : 1.f) / static_cast<float>(Count);
+            const __m128 Average = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(Sum), _mm_set1_ps(Scale)), _mm_set1_ps(0.5f));
+
+            // RGBA -> BGRA lane swizzle, then saturate down to bytes.
+            const __m128i Swizzled = _mm_shuffle_epi32(_mm_cvttps_epi32(Average), _MM_SHUFFLE(3, 0, 1, 2));
+            const __m128i Packed16 = _mm_packs_epi32(Swizzled, Swizzled);
+            const int32 Packed8 = _mm_cvtsi128_si32(_mm_packus_epi16(Packed16, Packed16));
+            FMemory::Memcpy(DestRow + X * 4, &Packed8, sizeof(Packed8));
+        }
+    }
+#endif
+
+    template <bool bIs16Bit>
+    void DownscaleRowScalar(const uint8* Payload, int32 SourceWidth, const FBoxSpan& RowSpan, const TArray<FBoxSpan>& ColumnSpans, uint8* DestRow)
+    {
+        for (int32 X = 0; X < ColumnSpans.Num(); ++X)
+        {
+            const FBoxSpan& ColumnSpan = ColumnSpans[X];
+            uint32 Sum[4] = { 0, 0, 0, 0 };
+
+            for (int32 SourceY = RowSpan.Start; SourceY < RowSpan.End; ++SourceY)
+            {
+                const int64 RowOffset = static_cast<int64>(SourceY) * SourceWidth;
+                for (int32 SourceX = ColumnSpan.Start; SourceX < ColumnSpan.End; ++SourceX)
+                {
+                    const int64 PixelOffset = (RowOffset + SourceX) * 4;
+                    for (int32 Channel = 0; Channel < 4; ++Channel)
+                    {
+                        Sum[Channel] += bIs16Bit ? reinterpret_cast<const uint16*>(Payload)[PixelOffset + Channel] : Payload[PixelOffset + Channel];
+                    }
+                }
+            }
+
+            const int32 Count = (RowSpan.End - RowSpan.Start) * (ColumnSpan.End - ColumnSpan.Start);
+            const float Scale = (bIs16Bit ? (255.f / 65535.f) : 1.f) / static_cast<float>(Count);
+            static constexpr int32 Swizzle[4] = { 2, 1, 0, 3 };
+            for (int32 Channel = 0; Channel < 4; ++Channel)
+            {
+                DestRow[X * 4 + Channel] = static_cast<uint8>(FMath::Clamp(static_cast<int32>(Sum[Swizzle[Channel]] * Scale + 0.5f), 0, 255));
+            }
+        }
+    }
+}
+
+FIntPoint FPanoramaPreviewDownscaler::ComputePreviewSize(const FIntPoint& SourceSize, float PreviewScale)
+{
+    const float Scale = FMath::Clamp(PreviewScale, 0.1f, 1.0f);
+    return FIntPoint(
+        FMath::Max(1, FMath::RoundToInt(SourceSize.X * Scale)),
+        FMath::Max(1, FMath::RoundToInt(SourceSize.Y * Scale)));
+}
+
+bool FPanoramaPreviewDownscaler::DownscaleToBGRA8(const uint8* Payload, const FIntPoint& SourceSize, bool bIs16Bit, const FIntPoint& PreviewSize, TArray<uint8>& OutPixels)
+{
+    if (!Payload || SourceSize.X <= 0 || SourceSize.Y <= 0 || PreviewSize.X <= 0 || PreviewSize.Y <= 0)
+    {
+        return false;
+    }
+
+    TArray<FBoxSpan> ColumnSpans;
+    TArray<FBoxSpan> RowSpans;
+    BuildSpans(SourceSize.X, PreviewSize.X, ColumnSpans);
+    BuildSpans(SourceSize.Y, PreviewSize.Y, RowSpans);
+
+    OutPixels.SetNumUninitialized(PreviewSize.X * PreviewSize.Y * 4);
+    uint8* DestData = OutPixels.GetData();
+
+    ParallelFor(PreviewSize.Y, [&](int32 Y)
+    {
+        uint8* DestRow = DestData + static_cast<int64>(Y) * PreviewSize.X * 4;
+#if PANORAMA_PREVIEW_SSE
+        if (bIs16Bit)
+        {
+            DownscaleRowSSE<true>(Payload, SourceSize.X, RowSpans[Y], ColumnSpans, DestRow);
+        }
+        else
+        {
+            DownscaleRowSSE<false>(Payload, SourceSize.X, RowSpans[Y], ColumnSpans, DestRow);
+        }
+#else
+        if (bIs16Bit)
+        {
+            DownscaleRowScalar<true>(Payload, SourceSize.X, RowSpans[Y], ColumnSpans, DestRow);
+        }
+        else
+        {
+            DownscaleRowScalar<false>(Payload, SourceSize.X, RowSpans[Y], ColumnSpans, DestRow);
+        }
+#endif
+    });
+
+    return true;
+}
@@ -0,0 +1,53 @@
+#include "PanoramaPreviewPass.h"
+
+#include "GlobalShader.h"
+#include "RenderGraphBuilder.h"
+#include "RenderGraphUtils.h"
+#include "ShaderParameterStruct.h"
+#include "ComputeShaderUtils.h"
+
+class FPanoramaPreviewDownsampleCS : public FGlobalShader
+{
+public:
+    DECLARE_GLOBAL_SHADER(FPanoramaPreviewDownsampleCS);
+    SHADER_USE_PARAMETER_STRUCT(FPanoramaPreviewDownsampleCS, FGlobalShader);
+
+    static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+    {
+        return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+    }
+
+    BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+        SHADER_PARAMETER(FUintVector2, SourceResolution)
+        SHADER_PARAMETER(FUintVector2, OutputResolution)
+        SHADER_PARAMETER(uint32, bApplySRGB)
+        SHADER_PARAMETER_RDG_TEXTURE(Texture2D<float4>, SourceTexture)
+        SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float4>, OutputTexture)
+    END_SHADER_PARAMETER_STRUCT()
+};
+
+IMPLEMENT_GLOBAL_SHADER(FPanoramaPreviewDownsampleCS, "/PanoramaCapture/Private/PreviewDownsample.usf", "MainCS", SF_Compute);
+
+void FPanoramaPreviewPass::AddDownsamplePass(FRDGBuilder& GraphBuilder, const FPanoramaPreviewDispatchParams& Params)
+{
+    if (!Params.SourceTexture || !Params.DestinationPreview || Params.PreviewResolution.X <= 0 || Params.PreviewResolution.Y <= 0)
+    {
+        return;
+    }
+
+    FPanoramaPreviewDownsampleCS::FParameters* PassParameters = GraphBuilder.AllocParameters<FPanoramaPreviewDownsampleCS::FParameters>();
+    PassParameters->SourceResolution = FUintVector2(Params.SourceResolution.X, Params.SourceResolution.Y);
+    PassParameters->OutputResolution = FUintVector2(Params.PreviewResolution.X, Params.PreviewResolution.Y);
+    PassParameters->bApplySRGB = Params.bApplySRGB ? 1u : 0u;
+    PassParameters->SourceTexture = Params.SourceTexture;
+    PassParameters->OutputTexture = GraphBuilder.CreateUAV(Params.DestinationPreview);
+
+    TShaderMapRef<FPanoramaPreviewDownsampleCS> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+
+    const FIntVector GroupCount(
+        FMath::DivideAndRoundUp(Params.PreviewResolution.X, 8),
+        FMath::DivideAndRoundUp(Params.PreviewResolution.Y, 8),
+        1);
+
+    FComputeShaderUtils::AddPass(GraphBuilder, RDG_EVENT_NAME("Panorama::PreviewDownsample"), ComputeShader, PassParameters, GroupCount);
+}
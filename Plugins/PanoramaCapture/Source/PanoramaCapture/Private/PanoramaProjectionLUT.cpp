@@ -0,0 +1,276 @@
+#include "PanoramaProjectionLUT.h"
+
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "PanoramaCaptureModule.h"
+#include "PanoramaOutputLayout.h"
+#include "PanoramaProjectionMath.h"
+#include "RenderingThread.h"
+#include "RHICommandList.h"
+
+namespace
+{
+    constexpr uint32 LUTFileMagic = 0x54554C50; // 'PLUT'
+
+    struct FLUTFileHeader
+    {
+        uint32 Magic = LUTFileMagic;
+        uint32 Version = FPanoramaProjectionLUT::FormatVersion;
+        int32 Width = 0;
+        int32 Height = 0;
+        uint8 Projection = 0;
+        uint8 Layout = 0;
+        uint8 StereoMode = 0;
+        uint8 Padding = 0;
+        float FieldOfView = 0.f;
+    };
+
+    FLUTFileHeader MakeHeader(const FPanoramaProjectionLUTKey& Key)
+    {
+        FLUTFileHeader Header;
+        Header.Width = Key.Resolution.X;
+        Header.Height = Key.Resolution.Y;
+        Header.Projection = static_cast<uint8>(Key.Projection);
+        Header.Layout = static_cast<uint8>(Key.Layout);
+        Header.StereoMode = static_cast<uint8>(Key.StereoMode);
+        Header.FieldOfView = Key.FieldOfView;
+        return Header;
+    }
+}
+
+FPanoramaProjectionLUTKey FPanoramaProjectionLUTKey::FromSettings(const FCaptureOutputSettings& Settings)
+{
+    FPanoramaProjectionLUTKey Key;
+    Key.Resolution = FPanoramaOutputLayout::GetOutputResolution(Settings);
+    Key.Projection = Settings.Projection;
+    Key.Layout = FPanoramaOutputLayout::GetEffectiveLayout(Settings);
+    Key.StereoMode = Settings.StereoMode;
+    Key.FieldOfView = Settings.Projection == EPanoramaProjection::Domemaster ? FPanoramaOutputLayout::GetFisheyeFieldOfView(Settings) : 0.f;
+    return Key;
+}
+
+FString FPanoramaProjectionLUTKey::ToString() const
+{
+    FString Result = FString::Printf(TEXT("%s_%s_%s_%dx%d"),
+        *StaticEnum<EPanoramaProjection>()->GetNameStringByValue(static_cast<int64>(Projection)),
+        *StaticEnum<EEquiLayout>()->GetNameStringByValue(static_cast<int64>(Layout)),
+        *StaticEnum<EPanoramaStereoMode>()->GetNameStringByValue(static_cast<int64>(StereoMode)),
+        Resolution.X,
+        Resolution.Y);
+
+    if (FieldOfView > 0.f)
+    {
+        Result += FString::Printf(TEXT("_%.1fdeg"), FieldOfView);
+    }
+    return Result;
+}
+
+uint32 FPanoramaProjectionLUT::PackEntry(int32 Face, const FVector2f& FaceUV, int32 EyeIndex)
+{
+    const uint32 U = static_cast<uint32>(FMath::Clamp(FMath::RoundToInt(FaceUV.X * UVMax), 0, static_cast<int32>(UVMax)));
+    const uint32 V = static_cast<uint32>(FMath::Clamp(FMath::RoundToInt(FaceUV.Y * UVMax), 0, static_cast<int32>(UVMax)));
+    return U | (V << 14) | (static_cast<uint32>(Face & 7) << 28) | (static_cast<uint32>(EyeIndex & 1) << 31);
+}
+
+int32 FPanoramaProjectionLUT::UnpackEntry(uint32 Entry, FVector2f& OutFaceUV, int32& OutEyeIndex)
+{
+    OutFaceUV = FVector2f(static_cast<float>(Entry & UVMax), static_cast<float>((Entry >> 14) & UVMax)) / static_cast<float>(UVMax);
+    OutEyeIndex = static_cast<int32>(Entry >> 31);
+    return static_cast<int32>((Entry >> 28) & 7);
+}
+
+bool FPanoramaProjectionLUT::EvaluatePixel(const FPanoramaProjectionLUTKey& Key, const FIntPoint& Pixel, int32& OutEyeIndex, FVector3f& OutDirection)
+{
+    const FVector2f OutputUV((Pixel.X + 0.5f) / Key.Resolution.X, (Pixel.Y + 0.5f) / Key.Resolution.Y);
+    const bool bStereo = Key.StereoMode != EPanoramaStereoMode::Mono;
+    const bool bOverUnder = Key.StereoMode == EPanoramaStereoMode::StereoOverUnder;
+
+    FVector2f SampleUV;
+    OutEyeIndex = PanoramaProjection::ResolveStereoUV(OutputUV, bStereo, bOverUnder, SampleUV);
+
+    switch (Key.Projection)
+    {
+    case EPanoramaProjection::EquiAngularCubemap:
+        // The 3x2 layout always covers the full sphere, so the hemisphere layouts do not apply.
+        OutDirection = PanoramaProjection::DirectionFromEAC(SampleUV);
+        return true;
+
+    case EPanoramaProjection::Domemaster:
+        return PanoramaProjection::DirectionFromFisheye(SampleUV, FMath::DegreesToRadians(Key.FieldOfView), Key.Layout == EEquiLayout::VR180, OutDirection);
+
+    default:
+    {
+        const FVector2f LatitudeRange = FPanoramaOutputLayout::GetLatitudeRange(Key.Layout);
+        const FVector2f LongitudeRange = FPanoramaOutputLayout::GetLongitudeRange(Key.Layout);
+        OutDirection = PanoramaProjection::DirectionFromEquirect(LongitudeRange.X + SampleUV.X * LongitudeRange.Y, LatitudeRange.X + SampleUV.Y * LatitudeRange.Y);
+        return true;
+    }
+    }
+}
+
+TSharedPtr<FPanoramaProjectionLUT, ESPMode::ThreadSafe> FPanoramaProjectionLUT::Build(const FPanoramaProjectionLUTKey& Key)
+{
+    if (!Key.IsValid())
+    {
+        return nullptr;
+    }
+
+    TSharedPtr<FPanoramaProjectionLUT, ESPMode::ThreadSafe> Table = MakeShared<FPanoramaProjectionLUT, ESPMode::ThreadSafe>();
+    Table->Key = Key;
+    Table->Entries.SetNumUninitialized(Key.Resolution.X * Key.Resolution.Y);
+    uint32* Entries = Table->Entries.GetData();
+
+    ParallelFor(Key.Resolution.Y, [&Key, Entries](int32 Y)
+    {
+        uint32* Row = Entries + static_cast<int64>(Y) * Key.Resolution.X;
+        for (int32 X = 0; X < Key.Resolution.X; ++X)
+        {
+            int32 EyeIndex = 0;
+            FVector3f Direction;
+            if (!EvaluatePixel(Key, FIntPoint(X, Y), EyeIndex, Direction))
+            {
+                Row[X] = PackEntry(UncoveredFace, FVector2f::ZeroVector, EyeIndex);
+                continue;
+            }
+
+            FVector2f FaceUV;
+            const int32 Face = PanoramaProjection::CubeFaceFromDirection(Direction, FaceUV);
+            Row[X] = PackEntry(Face, FaceUV, EyeIndex);
+        }
+    });
+
+    return Table;
+}
+
+TSharedPtr<FPanoramaProjectionLUT, ESPMode::ThreadSafe> FPanoramaProjectionLUT::LoadFromFile(const FString& FilePath, const FPanoramaProjectionLUTKey& Key)
+{
+    TArray<uint8> Bytes;
+    if (!FFileHelper::LoadFileToArray(Bytes, *FilePath, FILEREAD_Silent))
+    {
+        return nullptr;
+    }
+
+    const FLUTFileHeader Expected = MakeHeader(Key);
+    const int64 EntryCount = static_cast<int64>(Key.Resolution.X) * Key.Resolution.Y;
+    if (Bytes.Num() != sizeof(FLUTFileHeader) + EntryCount * sizeof(uint32) || FMemory::Memcmp(Bytes.GetData(), &Expected, sizeof(FLUTFileHeader)) != 0)
+    {
+        UE_LOG(LogPanoramaCapture, Log, TEXT("Ignoring stale projection LUT %s"), *FilePath);
+        return nullptr;
+    }
+
+    TSharedPtr<FPanoramaProjectionLUT, ESPMode::ThreadSafe> Table = MakeShared<FPanoramaProjectionLUT, ESPMode::ThreadSafe>();
+    Table->Key = Key;
+    Table->Entries.SetNumUninitialized(EntryCount);
+    FMemory::Memcpy(Table->Entries.GetData(), Bytes.GetData() + sizeof(FLUTFileHeader), EntryCount * sizeof(uint32));
+    return Table;
+}
+
+bool FPanoramaProjectionLUT::SaveToFile(const FString& FilePath) const
+{
+    const FLUTFileHeader Header = MakeHeader(Key);
+
+    TArray<uint8> Bytes;
+    Bytes.SetNumUninitialized(sizeof(FLUTFileHeader) + Entries.Num() * sizeof(uint32));
+    FMemory::Memcpy(Bytes.GetData(), &Header, sizeof(FLUTFileHeader));
+    FMemory::Memcpy(Bytes.GetData() + sizeof(FLUTFileHeader), Entries.GetData(), Entries.Num() * sizeof(uint32));
+    return FFileHelper::SaveArrayToFile(Bytes, *FilePath);
+}
+
+FTextureRHIRef FPanoramaProjectionLUT::GetOrCreateRHITexture(FRHICommandListImmediate& RHICmdList) const
+{
+    check(IsInRenderingThread());
+
+    if (!RHITexture.IsValid() && Entries.Num() > 0)
+    {
+        const FRHITextureCreateDesc Desc = FRHITextureCreateDesc::Create2D(TEXT("PanoramaProjectionLUT"), Key.Resolution.X, Key.Resolution.Y, PF_R32_UINT)
+            .SetFlags(ETextureCreateFlags::ShaderResource)
+            .SetInitialState(ERHIAccess::SRVMask);
+        RHITexture = RHICreateTexture(Desc);
+
+        const FUpdateTextureRegion2D Region(0, 0, 0, 0, Key.Resolution.X, Key.Resolution.Y);
+        RHICmdList.UpdateTexture2D(RHITexture, 0, Region, Key.Resolution.X * sizeof(uint32), reinterpret_cast<const uint8*>(Entries.GetData()));
+    }
+
+    return RHITexture;
+}
+
+void FPanoramaProjectionLUT::ReleaseRHITexture() const
+{
+    check(IsInRenderingThread());
+    RHITexture.SafeRelease();
+}
+
+FPanoramaProjectionLUTCache& FPanoramaProjectionLUTCache::Get()
+{
+    static FPanoramaProjectionLUTCache Instance;
+    return Instance;
+}
+
+TSharedPtr<const FPanoramaProjectionLUT, ESPMode::ThreadSafe> FPanoramaProjectionLUTCache::FindOrBuild(const FPanoramaProjectionLUTKey& Key, bool bPersist)
+{
+    if (!Key.IsValid())
+    {
+        return nullptr;
+    }
+
+    FScopeLock Lock(&CacheLock);
+
+    if (const TSharedPtr<const FPanoramaProjectionLUT, ESPMode::ThreadSafe>* Existing = CachedTables.Find(Key))
+    {
+        return *Existing;
+    }
+
+    const FString FilePath = FPaths::Combine(GetPersistentDirectory(), Key.ToString() + TEXT(".lut"));
+    const double StartSeconds = FPlatformTime::Seconds();
+
+    TSharedPtr<FPanoramaProjectionLUT, ESPMode::ThreadSafe> Table = bPersist ? FPanoramaProjectionLUT::LoadFromFile(FilePath, Key) : nullptr;
+    const bool bLoaded = Table.IsValid();
+    if (!bLoaded)
+    {
+        Table = FPanoramaProjectionLUT::Build(Key);
+        if (Table.IsValid() && bPersist && !Table->SaveToFile(FilePath))
+        {
+            UE_LOG(LogPanoramaCapture, Warning, TEXT("Failed to persist projection LUT to %s"), *FilePath);
+        }
+    }
+
+    if (Table.IsValid())
+    {
+        UE_LOG(LogPanoramaCapture, Log, TEXT("Projection LUT %s %s in %.1f ms (%.1f MB)"), *Key.ToString(), bLoaded ? TEXT("loaded") : TEXT("generated"),
+            (FPlatformTime::Seconds() - StartSeconds) * 1000.0, Table->GetAllocatedSize() / (1024.0 * 1024.0));
+        CachedTables.Add(Key, Table);
+    }
+
+    return Table;
+}
+
+void FPanoramaProjectionLUTCache::Empty()
+{
+    TArray<TSharedPtr<const FPanoramaProjectionLUT, ESPMode::ThreadSafe>> Tables;
+    {
+        FScopeLock Lock(&CacheLock);
+        CachedTables.GenerateValueArray(Tables);
+        CachedTables.Empty();
+    }
+
+    if (Tables.Num() > 0)
+    {
+        // The render command keeps the tables alive until their textures are released, even if no controller holds them.
+        ENQUEUE_RENDER_COMMAND(PanoramaReleaseProjectionLUTs)([Tables = MoveTemp(Tables)](FRHICommandListImmediate&)
+        {
+            for (const TSharedPtr<const FPanoramaProjectionLUT, ESPMode::ThreadSafe>& Table : Tables)
+            {
+                Table->ReleaseRHITexture();
+            }
+        });
+        FlushRenderingCommands();
+    }
+}
+
+FString FPanoramaProjectionLUTCache::GetPersistentDirectory()
+{
+    return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("PanoramaCapture"), TEXT("LUT"));
+}
@@ -0,0 +1,92 @@
+#include "PanoramaResolutionGovernor.h"
+
+namespace
+{
+    /** Weight of the newest GPU frame time in the running average. */
+    constexpr float GPUTimeSmoothing = 0.2f;
+    /** Below this share of the budget, with a quiet queue, the faces grow again. */
+    constexpr float HeadroomRatio = 0.75f;
+    /** Growth aims this far under the budget so a raise does not immediately overshoot it. */
+    constexpr float GrowthTargetRatio = 0.85f;
+    constexpr float QueuePressureFill = 0.5f;
+    constexpr float QueueHeadroomFill = 0.25f;
+    /** Most a single adjustment shrinks the face edge by, so one stalled frame cannot drop straight to MinScale. */
+    constexpr float MaxShrinkRatio = 0.7f;
+}
+
+void FPanoramaResolutionGovernor::Reset(const FPanoramaResolutionGovernorSettings& InSettings, int32 FrameRate)
+{
+    Settings = InSettings;
+    Settings.MinScale = FMath::Clamp(Settings.MinScale, 0.25f, 1.f);
+    Settings.MaxScale = FMath::Clamp(Settings.MaxScale, Settings.MinScale, 1.f);
+    BudgetMilliseconds = 1000.f / FMath::Max(1, FrameRate) * FMath::Clamp(Settings.GPUBudgetFraction, 0.25f, 1.f);
+
+    const int32 LevelCount = Settings.MinScale < Settings.MaxScale ? FMath::Clamp(Settings.ScaleLevels, 2, 6) : 1;
+    ScaleLevels.Reset(LevelCount);
+    for (int32 Index = 0; Index < LevelCount; ++Index)
+    {
+        ScaleLevels.Add(LevelCount > 1 ? FMath::Lerp(Settings.MaxScale, Settings.MinScale, static_cast<float>(Index) / (LevelCount - 1)) : Settings.MaxScale);
+    }
+    Level = 0;
+    SmoothedGPUMilliseconds = 0.f;
+    PeakQueueFill = 0.f;
+    LostFrames = 0;
+    FramesSinceAdjust = 0;
+    bHasGPUSample = false;
+}
+
+bool FPanoramaResolutionGovernor::Update(const FPanoramaGovernorSample& Sample)
+{
+    if (Sample.GPUFrameMilliseconds > 0.f)
+    {
+        SmoothedGPUMilliseconds = bHasGPUSample ? FMath::Lerp(SmoothedGPUMilliseconds, Sample.GPUFrameMilliseconds, GPUTimeSmoothing) : Sample.GPUFrameMilliseconds;
+        bHasGPUSample = true;
+    }
+    PeakQueueFill = FMath::Max(PeakQueueFill, Sample.QueueFill);
+    LostFrames += Sample.NewlyLostFrames;
+
+    if (++FramesSinceAdjust < FMath::Max(1, Settings.AdjustIntervalFrames))
+    {
+        return false;
+    }
+
+    const float Pressure = bHasGPUSample && BudgetMilliseconds > 0.f ? SmoothedGPUMilliseconds / BudgetMilliseconds : 0.f;
+    const float Scale = GetScale();
+    int32 TargetLevel = Level;
+    if (Pressure > 1.f)
+    {
+        // At least one level down, and further while the next level is still above the scale the budget asks for.
+        const float TargetScale = Scale * FMath::Max(FMath::InvSqrt(Pressure), MaxShrinkRatio);
+        TargetLevel = Level + 1;
+        while (TargetLevel + 1 < ScaleLevels.Num() && ScaleLevels[TargetLevel] > TargetScale)
+        {
+            ++TargetLevel;
+        }
+    }
+    else if (LostFrames > 0 || PeakQueueFill > QueuePressureFill)
+    {
+        // The GPU fits but something downstream is behind; fewer face texels still shorten the whole frame.
+        TargetLevel = Level + 1;
+    }
+    else if (bHasGPUSample && Pressure < HeadroomRatio && PeakQueueFill < QueueHeadroomFill && Level > 0)
+    {
+        const float FittingScale = Scale * FMath::Sqrt(GrowthTargetRatio / FMath::Max(Pressure, UE_KINDA_SMALL_NUMBER));
+        if (FittingScale >= ScaleLevels[Level - 1])
+        {
+            TargetLevel = Level - 1;
+        }
+    }
+
+    FramesSinceAdjust = 0;
+    PeakQueueFill = 0.f;
+    LostFrames = 0;
+
+    TargetLevel = FMath::Clamp(TargetLevel, 0, ScaleLevels.Num() - 1);
+    if (TargetLevel == Level)
+    {
+        return false;
+    }
+
+    Level = TargetLevel;
+    return true;
+}
@@ -0,0 +1,491 @@
+#include "PanoramaStillWriter.h"
+
+#include "HAL/FileManager.h"
+#include "PanoramaCaptureModule.h"
+#include "Serialization/Archive.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "zlib.h"
+THIRD_PARTY_INCLUDES_END
+
+namespace
+{
+    /** Owns the file and the row bookkeeping; subclasses only encode rows and write their container structures. */
+    class FPanoramaStillWriterBase : public IPanoramaStillWriter
+    {
+    public:
+        FPanoramaStillWriterBase(TUniquePtr<FArchive>&& InArchive, const FPanoramaStillDesc& InDesc)
+            : Archive(MoveTemp(InArchive))
+            , Desc(InDesc)
+        {
+        }
+
+        virtual bool WriteRows(TArrayView<const FFloat16Color> Pixels, int32 RowCount) override
+        {
+            if (!IsHealthy() || RowCount <= 0 || RowsWritten + RowCount > Desc.Size.Y || Pixels.Num() < static_cast<int64>(RowCount) * Desc.Size.X)
+            {
+                bFailed = true;
+                return false;
+            }
+
+            for (int32 Row = 0; Row < RowCount && IsHealthy(); ++Row)
+            {
+                EncodeRow(Pixels.Slice(Row * Desc.Size.X, Desc.Size.X));
+                ++RowsWritten;
+            }
+            return IsHealthy();
+        }
+
+        virtual bool Finish() override
+        {
+            if (IsHealthy() && RowsWritten == Desc.Size.Y)
+            {
+                WriteTrailer();
+            }
+            else
+            {
+                bFailed = true;
+            }
+
+            const bool bSucceeded = IsHealthy() && Archive->Close();
+            Archive.Reset();
+            return bSucceeded;
+        }
+
+    protected:
+        virtual void EncodeRow(TArrayView<const FFloat16Color> Row) = 0;
+        virtual void WriteTrailer() {}
+
+        bool IsHealthy() const
+        {
+            return !bFailed && Archive.IsValid() && !Archive->IsError();
+        }
+
+        void WriteBytes(const void* Data, int64 Num)
+        {
+            Archive->Serialize(const_cast<void*>(Data), Num);
+        }
+
+        void WriteU16LE(uint16 Value) { const uint8 Bytes[2] = { uint8(Value), uint8(Value >> 8) }; WriteBytes(Bytes, 2); }
+        void WriteU32LE(uint32 Value) { const uint8 Bytes[4] = { uint8(Value), uint8(Value >> 8), uint8(Value >> 16), uint8(Value >> 24) }; WriteBytes(Bytes, 4); }
+        void WriteU64LE(uint64 Value) { WriteU32LE(uint32(Value)); WriteU32LE(uint32(Value >> 32)); }
+        void WriteU32BE(uint32 Value) { const uint8 Bytes[4] = { uint8(Value >> 24), uint8(Value >> 16), uint8(Value >> 8), uint8(Value) }; WriteBytes(Bytes, 4); }
+
+        TUniquePtr<FArchive> Archive;
+        FPanoramaStillDesc Desc;
+        int32 RowsWritten = 0;
+        bool bFailed = false;
+    };
+
+    /**
+     * Base for the integer formats. Every half-float bit pattern is quantized once up front, with the same rounding as the
+     * readback resolve, so encoding a row is a table lookup per channel instead of a pow per pixel.
+     */
+    class FPanoramaQuantizedStillWriter : public FPanoramaStillWriterBase
+    {
+    public:
+        FPanoramaQuantizedStillWriter(TUniquePtr<FArchive>&& InArchive, const FPanoramaStillDesc& InDesc)
+            : FPanoramaStillWriterBase(MoveTemp(InArchive), InDesc)
+        {
+            const float Scale = Desc.b16Bit ? 65535.f : 255.f;
+            ColorTable.SetNumUninitialized(65536);
+            AlphaTable.SetNumUninitialized(65536);
+            for (int32 Encoded = 0; Encoded < 65536; ++Encoded)
+            {
+                FFloat16 Half;
+                Half.Encoded = static_cast<uint16>(Encoded);
+                const float Linear = FMath::IsFinite(Half.GetFloat()) ? FMath::Clamp(Half.GetFloat(), 0.f, 1.f) : 0.f;
+                const float Color = Desc.bEncodeGamma ? FMath::Pow(Linear, 1.f / 2.2f) : Linear;
+                ColorTable[Encoded] = static_cast<uint16>(FMath::Clamp<int32>(FMath::RoundToInt(Color * Scale), 0, static_cast<int32>(Scale)));
+                AlphaTable[Encoded] = static_cast<uint16>(FMath::Clamp<int32>(FMath::RoundToInt(Linear * Scale), 0, static_cast<int32>(Scale)));
+            }
+        }
+
+    protected:
+        int32 GetBytesPerPixel() const { return Desc.b16Bit ? 8 : 4; }
+
+        /** Writes RGBA samples of Row to Dest, 16-bit samples in the requested byte order. */
+        void QuantizeRow(TArrayView<const FFloat16Color> Row, uint8* Dest, bool bBigEndian) const
+        {
+            for (const FFloat16Color& Pixel : Row)
+            {
+                const uint16 Samples[4] = { ColorTable[Pixel.R.Encoded], ColorTable[Pixel.G.Encoded], ColorTable[Pixel.B.Encoded], AlphaTable[Pixel.A.Encoded] };
+                for (uint16 Sample : Samples)
+                {
+                    if (!Desc.b16Bit)
+                    {
+                        *Dest++ = static_cast<uint8>(Sample);
+                    }
+                    else if (bBigEndian)
+                    {
+                        *Dest++ = static_cast<uint8>(Sample >> 8);
+                        *Dest++ = static_cast<uint8>(Sample);
+                    }
+                    else
+                    {
+                        *Dest++ = static_cast<uint8>(Sample);
+                        *Dest++ = static_cast<uint8>(Sample >> 8);
+                    }
+                }
+            }
+        }
+
+    private:
+        TArray<uint16> ColorTable;
+        TArray<uint16> AlphaTable;
+    };
+
+    /** RGBA PNG with each row Sub-filtered and fed to one deflate stream that is flushed into IDAT chunks as it fills. */
+    class FPanoramaPNGStillWriter final : public FPanoramaQuantizedStillWriter
+    {
+    public:
+        FPanoramaPNGStillWriter(TUniquePtr<FArchive>&& InArchive, const FPanoramaStillDesc& InDesc)
+            : FPanoramaQuantizedStillWriter(MoveTemp(InArchive), InDesc)
+        {
+            FMemory::Memzero(Stream);
+            bStreamReady = deflateInit(&Stream, Z_DEFAULT_COMPRESSION) == Z_OK;
+            if (!bStreamReady)
+            {
+                bFailed = true;
+                return;
+            }
+
+            RowBuffer.SetNumUninitialized(1 + Desc.Size.X * GetBytesPerPixel());
+            ChunkBuffer.SetNumUninitialized(ChunkBufferSize);
+
+            static const uint8 Signature[8] = { 0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A };
+            WriteBytes(Signature, sizeof(Signature));
+
+            uint8 Header[13];
+            const uint32 Width = static_cast<uint32>(Desc.Size.X);
+            const uint32 Height = static_cast<uint32>(Desc.Size.Y);
+            Header[0] = uint8(Width >> 24); Header[1] = uint8(Width >> 16); Header[2] = uint8(Width >> 8); Header[3] = uint8(Width);
+            Header[4] = uint8(Height >> 24); Header[5] = uint8(Height >> 16); Header[6] = uint8(Height >> 8); Header[7] = uint8(Height);
+            Header[8] = Desc.b16Bit ? 16 : 8;
+            Header[9] = 6; // Truecolour with alpha.
+            Header[10] = 0;
+            Header[11] = 0;
+            Header[12] = 0;
+            WriteChunk("IHDR", Header, sizeof(Header));
+        }
+
+        virtual ~FPanoramaPNGStillWriter() override
+        {
+            if (bStreamReady)
+            {
+                deflateEnd(&Stream);
+            }
+        }
+
+    protected:
+        virtual void EncodeRow(TArrayView<const FFloat16Color> Row) override
+        {
+            uint8* Bytes = RowBuffer.GetData();
+            Bytes[0] = 1; // Sub filter.
+            QuantizeRow(Row, Bytes + 1, true);
+
+            // Walk backwards so each byte is predicted from the unfiltered byte one pixel to its left.
+            const int32 BytesPerPixel = GetBytesPerPixel();
+            for (int32 Index = RowBuffer.Num() - 1; Index > BytesPerPixel; --Index)
+            {
+                Bytes[Index] = static_cast<uint8>(Bytes[Index] - Bytes[Index - BytesPerPixel]);
+            }
+
+            Deflate(Bytes, RowBuffer.Num(), Z_NO_FLUSH);
+        }
+
+        virtual void WriteTrailer() override
+        {
+            Deflate(nullptr, 0, Z_FINISH);
+            WriteChunk("IEND", nullptr, 0);
+        }
+
+    private:
+        static constexpr int32 ChunkBufferSize = 1 << 20;
+
+        void Deflate(const uint8* Data, int32 Num, int32 FlushMode)
+        {
+            Stream.next_in = const_cast<Bytef*>(Data);
+            Stream.avail_in = static_cast<uInt>(Num);
+
+            int32 Result = Z_OK;
+            do
+            {
+                Stream.next_out = ChunkBuffer.GetData();
+                Stream.avail_out = static_cast<uInt>(ChunkBufferSize);
+                Result = deflate(&Stream, FlushMode);
+                if (Result == Z_STREAM_ERROR)
+                {
+                    bFailed = true;
+                    return;
+                }
+
+                const int32 Produced = ChunkBufferSize - static_cast<int32>(Stream.avail_out);
+                if (Produced > 0)
+                {
+                    WriteChunk("IDAT", ChunkBuffer.GetData(), Produced);
+                }
+            }
+            while (Stream.avail_out == 0 || (FlushMode == Z_FINISH && Result != Z_STREAM_END));
+        }
+
+        void WriteChunk(const char* Type, const uint8* Data, int32 Num)
+        {
+            WriteU32BE(static_cast<uint32>(Num));
+            WriteBytes(Type, 4);
+            uLong Crc = crc32(0L, reinterpret_cast<const Bytef*>(Type), 4);
+            if (Num > 0)
+            {
+                WriteBytes(Data, Num);
+                Crc = crc32(Crc, Data, static_cast<uInt>(Num));
+            }
+            WriteU32BE(static_cast<uint32>(Crc));
+        }
+
+        z_stream Stream;
+        bool bStreamReady = false;
+        TArray<uint8> RowBuffer;
+        TArray<uint8> ChunkBuffer;
+    };
+
+    /**
+     * Baseline little-endian TIFF with uncompressed RGBA strips. Pixel data follows the header directly; the strip tables
+     * and the IFD are appended once every row is known, and the header is patched to point at them.
+     */
+    class FPanoramaTIFFStillWriter final : public FPanoramaQuantizedStillWriter
+    {
+    public:
+        FPanoramaTIFFStillWriter(TUniquePtr<FArchive>&& InArchive, const FPanoramaStillDesc& InDesc)
+            : FPanoramaQuantizedStillWriter(MoveTemp(InArchive), InDesc)
+        {
+            RowBuffer.SetNumUninitialized(Desc.Size.X * GetBytesPerPixel());
+
+            WriteBytes("II", 2);
+            WriteU16LE(42);
+            WriteU32LE(0);
+        }
+
+        /** Classic TIFF addresses everything with 32-bit offsets. */
+        static bool Fits(const FPanoramaStillDesc& Desc)
+        {
+            const int64 PixelBytes = static_cast<int64>(Desc.Size.X) * Desc.Size.Y * (Desc.b16Bit ? 8 : 4);
+            return PixelBytes + (64ll << 20) < static_cast<int64>(MAX_uint32);
+        }
+
+    protected:
+        virtual void EncodeRow(TArrayView<const FFloat16Color> Row) override
+        {
+            QuantizeRow(Row, RowBuffer.GetData(), false);
+            WriteBytes(RowBuffer.GetData(), RowBuffer.Num());
+        }
+
+        virtual void WriteTrailer() override
+        {
+            constexpr uint32 PixelDataOffset = 8;
+            const uint32 RowBytes = static_cast<uint32>(RowBuffer.Num());
+            const uint32 RowsPerStrip = FMath::Max<uint32>(1, (1u << 20) / RowBytes);
+            const uint32 StripCount = FMath::DivideAndRoundUp(static_cast<uint32>(Desc.Size.Y), RowsPerStrip);
+
+            if ((Archive->Tell() & 1) != 0)
+            {
+                const uint8 Pad = 0;
+                WriteBytes(&Pad, 1);
+            }
+
+            const uint32 BitsPerSampleOffset = static_cast<uint32>(Archive->Tell());
+            for (int32 Channel = 0; Channel < 4; ++Channel)
+            {
+                WriteU16LE(Desc.b16Bit ? 16 : 8);
+            }
+
+            const uint32 StripOffsetsOffset = static_cast<uint32>(Archive->Tell());
+            for (uint32 Strip = 0; Strip < StripCount; ++Strip)
+            {
+                WriteU32LE(PixelDataOffset + Strip * RowsPerStrip * RowBytes);
+            }
+
+            const uint32 StripByteCountsOffset = static_cast<uint32>(Archive->Tell());
+            for (uint32 Strip = 0; Strip < StripCount; ++Strip)
+            {
+                const uint32 StripRows = FMath::Min(RowsPerStrip, static_cast<uint32>(Desc.Size.Y) - Strip * RowsPerStrip);
+                WriteU32LE(StripRows * RowBytes);
+            }
+
+            constexpr uint16 TypeShort = 3;
+            constexpr uint16 TypeLong = 4;
+            const uint32 IFDOffset = static_cast<uint32>(Archive->Tell());
+            WriteU16LE(11);
+            WriteEntry(256, TypeLong, 1, static_cast<uint32>(Desc.Size.X));           // ImageWidth
+            WriteEntry(257, TypeLong, 1, static_cast<uint32>(Desc.Size.Y));           // ImageLength
+            WriteEntry(258, TypeShort, 4, BitsPerSampleOffset);                       // BitsPerSample
+            WriteEntry(259, TypeShort, 1, 1);                                         // Compression: none
+            WriteEntry(262, TypeShort, 1, 2);                                         // PhotometricInterpretation: RGB
+            WriteEntry(273, TypeLong, StripCount, StripCount == 1 ? PixelDataOffset : StripOffsetsOffset);
+            WriteEntry(277, TypeShort, 1, 4);                                         // SamplesPerPixel
+            WriteEntry(278, TypeLong, 1, RowsPerStrip);
+            WriteEntry(279, TypeLong, StripCount, StripCount == 1 ? RowBytes * static_cast<uint32>(Desc.Size.Y) : StripByteCountsOffset);
+            WriteEntry(284, TypeShort, 1, 1);                                         // PlanarConfiguration: chunky
+            WriteEntry(338, TypeShort, 1, 2);                                         // ExtraSamples: unassociated alpha
+            WriteU32LE(0);
+
+            Archive->Seek(4);
+            WriteU32LE(IFDOffset);
+        }
+
+    private:
+        /** Single SHORT and LONG values sit left-justified in the value field, which little-endian makes a plain 32-bit write. */
+        void WriteEntry(uint16 Tag, uint16 Type, uint32 Count, uint32 ValueOrOffset)
+        {
+            WriteU16LE(Tag);
+            WriteU16LE(Type);
+            WriteU32LE(Count);
+            WriteU32LE(ValueOrOffset);
+        }
+
+        TArray<uint8> RowBuffer;
+    };
+
+    /**
+     * Scanline OpenEXR with half RGBA channels and no compression. Every line block has the same size, so the offset table
+     * is written up front and rows go straight to disk.
+     */
+    class FPanoramaEXRStillWriter final : public FPanoramaStillWriterBase
+    {
+    public:
+        FPanoramaEXRStillWriter(TUniquePtr<FArchive>&& InArchive, const FPanoramaStillDesc& InDesc)
+            : FPanoramaStillWriterBase(MoveTemp(InArchive), InDesc)
+        {
+            RowBuffer.SetNumUninitialized(Desc.Size.X * 4);
+
+            WriteU32LE(20000630);
+            WriteU32LE(2);
+
+            // Channels are stored in alphabetical order: A, B, G, R; each HALF (1), linear flag 0, sampling 1x1.
+            TArray<uint8> Channels;
+            for (const char* Name : { "A", "B", "G", "R" })
+            {
+                Channels.Add(static_cast<uint8>(Name[0]));
+                Channels.Add(0);
+                AppendU32(Channels, 1);
+                AppendU32(Channels, 0);
+                AppendU32(Channels, 1);
+                AppendU32(Channels, 1);
+            }
+            Channels.Add(0);
+            WriteAttribute("channels", "chlist", Channels);
+
+            WriteAttribute("compression", "compression", { 0 });
+
+            TArray<uint8> Window;
+            AppendU32(Window, 0);
+            AppendU32(Window, 0);
+            AppendU32(Window, static_cast<uint32>(Desc.Size.X - 1));
+            AppendU32(Window, static_cast<uint32>(Desc.Size.Y - 1));
+            WriteAttribute("dataWindow", "box2i", Window);
+            WriteAttribute("displayWindow", "box2i", Window);
+
+            WriteAttribute("lineOrder", "lineOrder", { 0 });
+
+            TArray<uint8> One;
+            AppendU32(One, 0x3F800000);
+            WriteAttribute("pixelAspectRatio", "float", One);
+            WriteAttribute("screenWindowCenter", "v2f", { 0, 0, 0, 0, 0, 0, 0, 0 });
+            WriteAttribute("screenWindowWidth", "float", One);
+
+            const uint8 EndOfHeader = 0;
+            WriteBytes(&EndOfHeader, 1);
+
+            const uint64 LineBlockSize = 8 + static_cast<uint64>(RowBuffer.Num()) * sizeof(uint16);
+            const uint64 FirstLineBlock = static_cast<uint64>(Archive->Tell()) + static_cast<uint64>(Desc.Size.Y) * sizeof(uint64);
+            for (int32 Line = 0; Line < Desc.Size.Y; ++Line)
+            {
+                WriteU64LE(FirstLineBlock + Line * LineBlockSize);
+            }
+        }
+
+    protected:
+        virtual void EncodeRow(TArrayView<const FFloat16Color> Row) override
+        {
+            const int32 Width = Desc.Size.X;
+            uint16* Planes = RowBuffer.GetData();
+            for (int32 X = 0; X < Width; ++X)
+            {
+                Planes[X] = Row[X].A.Encoded;
+                Planes[Width + X] = Row[X].B.Encoded;
+                Planes[Width * 2 + X] = Row[X].G.Encoded;
+                Planes[Width * 3 + X] = Row[X].R.Encoded;
+            }
+
+            WriteU32LE(static_cast<uint32>(RowsWritten));
+            WriteU32LE(static_cast<uint32>(RowBuffer.Num() * sizeof(uint16)));
+#if PLATFORM_LITTLE_ENDIAN
+            WriteBytes(RowBuffer.GetData(), RowBuffer.Num() * sizeof(uint16));
+#else
+            for (uint16 Sample : RowBuffer)
+            {
+                WriteU16LE(Sample);
+            }
+#endif
+        }
+
+    private:
+        static void AppendU32(TArray<uint8>& Bytes, uint32 Value)
+        {
+            Bytes.Append({ uint8(Value), uint8(Value >> 8), uint8(Value >> 16), uint8(Value >> 24) });
+        }
+
+        void WriteAttribute(const char* Name, const char* Type, const TArray<uint8>& Value)
+        {
+            WriteBytes(Name, FCStringAnsi::Strlen(Name) + 1);
+            WriteBytes(Type, FCStringAnsi::Strlen(Type) + 1);
+            WriteU32LE(static_cast<uint32>(Value.Num()));
+            WriteBytes(Value.GetData(), Value.Num());
+        }
+
+        TArray<uint16> RowBuffer;
+    };
+}
+
+TUniquePtr<IPanoramaStillWriter> IPanoramaStillWriter::Create(EPanoramaStillFormat Format, const FString& OutputFile, const FPanoramaStillDesc& Desc)
+{
+    if (Desc.Size.X <= 0 || Desc.Size.Y <= 0)
+    {
+        return nullptr;
+    }
+
+    if (Format == EPanoramaStillFormat::TIFF && !FPanoramaTIFFStillWriter::Fits(Desc))
+    {
+        UE_LOG(LogPanoramaCapture, Error, TEXT("A %dx%d still exceeds the 4 GB limit of uncompressed TIFF; use PNG or EXR."), Desc.Size.X, Desc.Size.Y);
+        return nullptr;
+    }
+
+    TUniquePtr<FArchive> Archive(IFileManager::Get().CreateFileWriter(*OutputFile));
+    if (!Archive)
+    {
+        UE_LOG(LogPanoramaCapture, Error, TEXT("Cannot open '%s' for writing."), *OutputFile);
+        return nullptr;
+    }
+
+    switch (Format)
+    {
+    case EPanoramaStillFormat::EXR:
+        return MakeUnique<FPanoramaEXRStillWriter>(MoveTemp(Archive), Desc);
+    case EPanoramaStillFormat::TIFF:
+        return MakeUnique<FPanoramaTIFFStillWriter>(MoveTemp(Archive), Desc);
+    default:
+        return MakeUnique<FPanoramaPNGStillWriter>(MoveTemp(Archive), Desc);
+    }
+}
+
+const TCHAR* IPanoramaStillWriter::GetFileExtension(EPanoramaStillFormat Format)
+{
+    switch (Format)
+    {
+    case EPanoramaStillFormat::EXR:
+        return TEXT("exr");
+    case EPanoramaStillFormat::TIFF:
+        return TEXT("tif");
+    default:
+        return TEXT("png");
+    }
+}
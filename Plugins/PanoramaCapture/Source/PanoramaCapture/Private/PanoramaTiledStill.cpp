@@ -0,0 +1,423 @@
+#include "PanoramaTiledStill.h"
+
+#include "CubemapCaptureRigComponent.h"
+#include "CubemapEquirectPass.h"
+#include "Engine/Texture.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "HAL/PlatformTime.h"
+#include "PanoramaCaptureModule.h"
+#include "PanoramaColorGradePass.h"
+#include "PanoramaCubeFaces.h"
+#include "PanoramaOutputLayout.h"
+#include "PanoramaProjectionLUT.h"
+#include "PanoramaStillWriter.h"
+#include "RenderGraphBuilder.h"
+#include "RenderGraphUtils.h"
+#include "RenderingThread.h"
+#include "RHIGlobals.h"
+#include "RHIGPUReadback.h"
+#include "TextureResource.h"
+
+#include <atomic>
+
+/** Render thread state reused by every tile: one tile-sized accumulation target and one readback. */
+struct FTiledStillRenderState
+{
+    TRefCountPtr<IPooledRenderTarget> Accumulation;
+    TUniquePtr<FRHIGPUTextureReadback> Readback = MakeUnique<FRHIGPUTextureReadback>(TEXT("PanoramaStillTileReadback"));
+    /** Set on the render thread once the tile's copy is enqueued, so the game thread never polls a readback with no work. */
+    std::atomic<bool> bCopySubmitted { false };
+
+    bool IsReady() const
+    {
+        return bCopySubmitted && Readback && Readback->IsReady();
+    }
+};
+
+namespace
+{
+    constexpr int32 FacesPerEye = PanoramaProjection::FacesPerEye;
+    constexpr double TileReadbackTimeoutSeconds = 30.0;
+
+    /** Output pixels added around a tile before measuring its face regions, so filter taps next to the tile edge find texels. */
+    constexpr int32 TileCoverageMargin = 8;
+
+    /** Pixel centres sampled per axis when measuring a tile's face regions. */
+    constexpr int32 CoverageSamplesPerAxis = 65;
+
+    /** Smallest tile Begin shrinks Still.TileSize to when keeping face regions within a texture. */
+    constexpr int32 MinTileSize = 256;
+
+    float Halton(int32 Index, int32 Base)
+    {
+        float Result = 0.f;
+        float Fraction = 1.f;
+        for (int32 Remaining = Index; Remaining > 0; Remaining /= Base)
+        {
+            Fraction /= static_cast<float>(Base);
+            Result += Fraction * static_cast<float>(Remaining % Base);
+        }
+        return Result;
+    }
+}
+
+TArray<FIntRect> FPanoramaTiledStill::BuildTileGrid(const FIntPoint& OutputResolution, int32 TileSize)
+{
+    TArray<FIntRect> Tiles;
+    const int32 Step = FMath::Max(1, TileSize);
+    for (int32 Y = 0; Y < OutputResolution.Y; Y += Step)
+    {
+        for (int32 X = 0; X < OutputResolution.X; X += Step)
+        {
+            Tiles.Add(FIntRect(X, Y, FMath::Min(X + Step, OutputResolution.X), FMath::Min(Y + Step, OutputResolution.Y)));
+        }
+    }
+    return Tiles;
+}
+
+FVector2f FPanoramaTiledStill::GetSampleJitter(int32 SampleIndex)
+{
+    if (SampleIndex <= 0)
+    {
+        return FVector2f::ZeroVector;
+    }
+    return FVector2f(Halton(SampleIndex, 2) - 0.5f, Halton(SampleIndex, 3) - 0.5f);
+}
+
+TSharedPtr<FPanoramaTiledStill> FPanoramaTiledStill::Begin(UCubemapCaptureRigComponent& Rig, const FCaptureOutputSettings& Settings, const FString& OutputFile)
+{
+    if (Settings.Projection != EPanoramaProjection::Equirectangular)
+    {
+        UE_LOG(LogPanoramaCapture, Warning, TEXT("Tiled stills are only available for the equirectangular projection."));
+        return nullptr;
+    }
+
+    const FIntPoint OutputResolution = FPanoramaOutputLayout::GetOutputResolution(Settings);
+
+    FPanoramaStillDesc Desc;
+    Desc.Size = OutputResolution;
+    Desc.b16Bit = Settings.bUse16BitPNG;
+    Desc.bEncodeGamma = Settings.GammaSpace != EPanoramaGammaSpace::Linear;
+
+    TUniquePtr<IPanoramaStillWriter> Writer = IPanoramaStillWriter::Create(Settings.Still.Format, OutputFile, Desc);
+    if (!Writer)
+    {
+        return nullptr;
+    }
+
+    if (!Rig.IsRegionCaptureActive())
+    {
+        UE_LOG(LogPanoramaCapture, Warning, TEXT("Tiled stills need a rig initialized for region capture."));
+        return nullptr;
+    }
+
+    // A face holds half its edge in texels per radian at its centre and up to three times that towards its corners, and an
+    // output pixel spans at most RadiansPerPixel. A region can therefore never be larger than the tile's span times that.
+    const EEquiLayout EffectiveLayout = FPanoramaOutputLayout::GetEffectiveLayout(Settings);
+    const FIntPoint EyeResolution = FPanoramaOutputLayout::GetEyeResolution(Settings);
+    const double RadiansPerPixel = FMath::Max(
+        FPanoramaOutputLayout::GetLongitudeRange(EffectiveLayout).Y * 2.0 * UE_DOUBLE_PI / FMath::Max(1, EyeResolution.X),
+        FPanoramaOutputLayout::GetLatitudeRange(EffectiveLayout).Y * UE_DOUBLE_PI / FMath::Max(1, EyeResolution.Y));
+    int32 MaxFaceSize = 1;
+    for (int32 FaceIndex = 0; FaceIndex < FacesPerEye; ++FaceIndex)
+    {
+        MaxFaceSize = FMath::Max(MaxFaceSize, Rig.GetFaceTargetSize(FaceIndex));
+    }
+    const double TexelsPerPixel = 1.5 * MaxFaceSize * RadiansPerPixel;
+
+    // The coverage grid can miss one grid step of a region's edge; the border keeps bilinear taps at that edge inside.
+    auto GetRegionMargin = [TexelsPerPixel](int32 InTileSize)
+    {
+        const double GridStep = static_cast<double>(InTileSize + 2 * TileCoverageMargin) / (CoverageSamplesPerAxis - 1);
+        return FMath::CeilToInt(GridStep * TexelsPerPixel) + PanoramaProjection::FaceBorderTexels;
+    };
+
+    const int32 MaxRegionExtent = static_cast<int32>(GetMax2DTextureDimension());
+    const int32 RequestedTileSize = FMath::Clamp(Settings.Still.TileSize, 256, 8192);
+    int32 TileSize = RequestedTileSize;
+    while (TileSize > MinTileSize && 2.0 * (TileSize + 2 * TileCoverageMargin) * TexelsPerPixel + 2 * GetRegionMargin(TileSize) > MaxRegionExtent)
+    {
+        TileSize = FMath::Max(MinTileSize, AlignDown(TileSize * 3 / 4, 64));
+    }
+    if (TileSize != RequestedTileSize)
+    {
+        UE_LOG(LogPanoramaCapture, Log, TEXT("Still tiles reduced from %d to %d so every face region fits a %d texture."), RequestedTileSize, TileSize, MaxRegionExtent);
+    }
+
+    TSharedPtr<FPanoramaTiledStill> Still = MakeShareable(new FPanoramaTiledStill());
+    Still->Rig = &Rig;
+    Still->Writer = MoveTemp(Writer);
+    Still->RenderState = MakeShared<FTiledStillRenderState, ESPMode::ThreadSafe>();
+    Still->Settings = Settings;
+    Still->OutputFile = OutputFile;
+    Still->OutputResolution = OutputResolution;
+    Still->TileSize = TileSize;
+    Still->RegionMarginTexels = GetRegionMargin(TileSize);
+    Still->SampleCount = FMath::Clamp(Settings.Still.SamplesPerTile, 1, 16);
+    Still->Tiles = BuildTileGrid(OutputResolution, Still->TileSize);
+    return Still;
+}
+
+FPanoramaTiledStill::~FPanoramaTiledStill()
+{
+    // A still abandoned mid-way releases its tile target the same way a finished one does.
+    if (RenderState.IsValid())
+    {
+        ENQUEUE_RENDER_COMMAND(PanoramaStillRelease)(
+            [RenderState = MoveTemp(RenderState)](FRHICommandListImmediate&)
+            {
+                RenderState->Accumulation.SafeRelease();
+                RenderState->Readback.Reset();
+            });
+    }
+}
+
+FPanoramaTiledStill::EState FPanoramaTiledStill::Tick()
+{
+    if (State != EState::Rendering)
+    {
+        return State;
+    }
+
+    if (!Rig.IsValid())
+    {
+        UE_LOG(LogPanoramaCapture, Error, TEXT("The capture rig was destroyed while writing still '%s'."), *OutputFile);
+        return Finish(false);
+    }
+
+    if (bTileInFlight)
+    {
+        if (!RenderState->IsReady())
+        {
+            if (FPlatformTime::Seconds() - TileSubmitSeconds > TileReadbackTimeoutSeconds)
+            {
+                UE_LOG(LogPanoramaCapture, Error, TEXT("Timed out reading back still tile %d of %d."), NextTile, Tiles.Num());
+                return Finish(false);
+            }
+            return EState::Rendering;
+        }
+
+        bTileInFlight = false;
+        if (!ResolveTile(Tiles[NextTile - 1]))
+        {
+            return Finish(false);
+        }
+        if (NextTile == Tiles.Num())
+        {
+            return Finish(true);
+        }
+    }
+
+    SubmitTile(Tiles[NextTile++]);
+    bTileInFlight = true;
+    TileSubmitSeconds = FPlatformTime::Seconds();
+    return EState::Rendering;
+}
+
+void FPanoramaTiledStill::SubmitTile(const FIntRect& Tile)
+{
+    UCubemapCaptureRigComponent& RigComponent = *Rig.Get();
+    const EEquiLayout EffectiveLayout = FPanoramaOutputLayout::GetEffectiveLayout(Settings);
+    const bool bStereo = Settings.StereoMode != EPanoramaStereoMode::Mono;
+    const int32 EyeCount = bStereo ? 2 : 1;
+
+    // Tiles are converted scene-linear so jittered samples average correctly; the writer applies the output curve.
+    FCubemapEquirectDispatchParams BaseParams;
+    BaseParams.OutputResolution = OutputResolution;
+    BaseParams.LatitudeRange = FPanoramaOutputLayout::GetLatitudeRange(EffectiveLayout);
+    BaseParams.LongitudeRange = FPanoramaOutputLayout::GetLongitudeRange(EffectiveLayout);
+    BaseParams.Filter = Settings.ResampleFilter;
+    BaseParams.SupersampleGrid = Settings.SupersampleGrid;
+    BaseParams.bStereo = bStereo;
+    BaseParams.bStereoOverUnder = Settings.StereoMode == EPanoramaStereoMode::StereoOverUnder;
+    BaseParams.PolarStereoFadeRadians = RigComponent.SharesPolarFaces() ? FMath::DegreesToRadians(Settings.PolarStereoFadeDegrees) : 0.f;
+    BaseParams.Faces.bStereo = bStereo;
+    BaseParams.Faces.SharedFaceMask = RigComponent.SharesPolarFaces() ? FPanoramaOutputLayout::PolarFacesMask : 0;
+    BaseParams.bLinearGamma = true;
+    BaseParams.TileOffset = Tile.Min;
+    BaseParams.TileSize = Tile.Size();
+
+    // Each face only renders the part of it this tile samples, at the face's full texel density, into a region-sized target.
+    FBox2f CoverageRects[FacesPerEye * 2];
+    FPanoramaOutputLayout::ComputeFaceCoverageRects(FPanoramaProjectionLUTKey::FromSettings(Settings), Tile.Inner(-TileCoverageMargin), CoverageSamplesPerAxis, CoverageRects);
+    for (int32 FaceIndex = 0; FaceIndex < FacesPerEye; ++FaceIndex)
+    {
+        // The right eye reads the left eye's shared polar faces, so the left one covers both.
+        if ((BaseParams.Faces.SharedFaceMask & (1u << FaceIndex)) != 0 && CoverageRects[FacesPerEye + FaceIndex].bIsValid)
+        {
+            CoverageRects[FaceIndex] += CoverageRects[FacesPerEye + FaceIndex];
+            CoverageRects[FacesPerEye + FaceIndex].Init();
+        }
+    }
+
+    FIntRect TexelRects[FacesPerEye * 2];
+    int32 RegionFaceSizes[FacesPerEye] = {};
+    for (int32 Slot = 0; Slot < EyeCount * FacesPerEye; ++Slot)
+    {
+        const int32 FaceIndex = Slot % FacesPerEye;
+        if (!CoverageRects[Slot].bIsValid || !RigComponent.IsFaceActive(FaceIndex))
+        {
+            continue;
+        }
+
+        const int32 FaceSize = RigComponent.GetFaceTargetSize(FaceIndex);
+        const FIntPoint FaceMin(-PanoramaProjection::FaceBorderTexels);
+        const FIntPoint FaceMax(FaceSize + PanoramaProjection::FaceBorderTexels);
+        FIntRect& TexelRect = TexelRects[Slot];
+        TexelRect.Min = FIntPoint(FMath::FloorToInt(CoverageRects[Slot].Min.X * FaceSize), FMath::FloorToInt(CoverageRects[Slot].Min.Y * FaceSize)) - RegionMarginTexels;
+        TexelRect.Max = FIntPoint(FMath::CeilToInt(CoverageRects[Slot].Max.X * FaceSize), FMath::CeilToInt(CoverageRects[Slot].Max.Y * FaceSize)) + RegionMarginTexels;
+        TexelRect.Min = TexelRect.Min.ComponentMax(FaceMin);
+        TexelRect.Max = TexelRect.Max.ComponentMin(FaceMax);
+        RegionFaceSizes[FaceIndex] = FaceSize;
+    }
+
+    // Graded faces are scene-linear. EXR keeps them that way; every other format is graded once per tile, left linear for the writer.
+    const bool bGradeTiles = UCubemapCaptureRigComponent::CapturesSceneLinear(RigComponent.OutputSettings) && Settings.Still.Format != EPanoramaStillFormat::EXR;
+    UTexture* ColorGradingLUT = bGradeTiles ? Settings.ColorGrading.ColorGradingLUT.LoadSynchronous() : nullptr;
+    FTextureResource* ColorGradingLUTResource = ColorGradingLUT ? ColorGradingLUT->GetResource() : nullptr;
+    const FPanoramaColorGradingSettings ColorGrading = Settings.ColorGrading;
+
+    // The previous tile's copy has been collected, so the readback is free for this one.
+    RenderState->bCopySubmitted = false;
+
+    for (int32 SampleIndex = 0; SampleIndex < SampleCount; ++SampleIndex)
+    {
+        // The jitter moves the face cameras, so each sample renders new scene detail; the conversion samples the same output pixels.
+        const FVector2f Jitter = GetSampleJitter(SampleIndex);
+        TArray<FTextureRenderTargetResource*, TInlineAllocator<FacesPerEye * 2>> FaceResources;
+        FaceResources.Init(nullptr, FacesPerEye * 2);
+        FCubemapEquirectDispatchParams TileParams = BaseParams;
+        for (int32 Slot = 0; Slot < EyeCount * FacesPerEye; ++Slot)
+        {
+            if (TexelRects[Slot].Area() > 0)
+            {
+                if (UTextureRenderTarget2D* Target = RigComponent.CaptureFaceRegion(Slot, TexelRects[Slot], Jitter))
+                {
+                    const float FaceSize = static_cast<float>(RegionFaceSizes[Slot % FacesPerEye]);
+                    FaceResources[Slot] = Target->GameThread_GetRenderTargetResource();
+                    TileParams.Faces.Regions[Slot] = FBox2f(FVector2f(TexelRects[Slot].Min) / FaceSize, FVector2f(TexelRects[Slot].Max) / FaceSize);
+                }
+            }
+        }
+        for (int32 FaceIndex = 0; FaceIndex < FacesPerEye; ++FaceIndex)
+        {
+            TileParams.Faces.RegionFaceSizes[FaceIndex] = RegionFaceSizes[FaceIndex];
+
+            // A tile inside one eye's half of a stereo frame only renders that eye; the other eye's slot is never sampled, but
+            // the pass wants both filled.
+            const int32 RightSlot = FacesPerEye + FaceIndex;
+            if (bStereo && (BaseParams.Faces.SharedFaceMask & (1u << FaceIndex)) == 0 && (FaceResources[FaceIndex] == nullptr) != (FaceResources[RightSlot] == nullptr))
+            {
+                const int32 From = FaceResources[FaceIndex] ? FaceIndex : RightSlot;
+                const int32 To = From == FaceIndex ? RightSlot : FaceIndex;
+                FaceResources[To] = FaceResources[From];
+                TileParams.Faces.Regions[To] = TileParams.Faces.Regions[From];
+            }
+        }
+
+        TileParams.AccumulationWeight = 1.f / static_cast<float>(SampleIndex + 1);
+        const bool bLastSample = SampleIndex + 1 == SampleCount;
+
+        ENQUEUE_RENDER_COMMAND(PanoramaStillTile)(
+            [RenderState = RenderState, FaceResources, FaceSize = RigComponent.GetFaceSize(), TileParams, TileSize = TileSize, bLastSample, bGradeTiles, ColorGrading, ColorGradingLUTResource](FRHICommandListImmediate& RHICmdList)
+            {
+                FRDGBuilder GraphBuilder(RHICmdList);
+
+                FCubemapEquirectDispatchParams Params = TileParams;
+                Params.Faces.FaceSize = FaceSize;
+                for (int32 Index = 0; Index < FaceResources.Num(); ++Index)
+                {
+                    FTextureRHIRef TextureRHI;
+                    if (FaceResources[Index])
+                    {
+                        TextureRHI = FaceResources[Index]->GetRenderTargetTexture();
+                    }
+                    if (TextureRHI.IsValid())
+                    {
+                        FRDGTextureRef& Slot = Index < FacesPerEye ? Params.Faces.Left[Index] : Params.Faces.Right[Index - FacesPerEye];
+                        Slot = GraphBuilder.RegisterExternalTexture(CreateRenderTarget(TextureRHI, TEXT("PanoramaStillFace")));
+                    }
+                }
+
+                FRDGTextureRef TileTexture;
+                if (RenderState->Accumulation.IsValid())
+                {
+                    TileTexture = GraphBuilder.RegisterExternalTexture(RenderState->Accumulation);
+                }
+                else
+                {
+                    const FRDGTextureDesc TileDesc = FRDGTextureDesc::Create2D(FIntPoint(TileSize, TileSize), PF_FloatRGBA, FClearValueBinding::Black, TexCreate_ShaderResource | TexCreate_UAV);
+                    TileTexture = GraphBuilder.CreateTexture(TileDesc, TEXT("PanoramaStillTile"));
+                }
+
+                Params.DestinationEquirect = TileTexture;
+                FCubemapEquirectPass::AddComputePass(GraphBuilder, Params);
+
+                if (bLastSample && bGradeTiles)
+                {
+                    FPanoramaColorGradeParams GradeParams = FPanoramaColorGradeParams::FromSettings(ColorGrading, TileTexture, Params.TileSize, true);
+                    if (ColorGradingLUTResource && ColorGradingLUTResource->TextureRHI.IsValid())
+                    {
+                        GradeParams.ColorGradingLUT = GraphBuilder.RegisterExternalTexture(CreateRenderTarget(ColorGradingLUTResource->TextureRHI, TEXT("PanoramaColorGradingLUT")));
+                    }
+                    FPanoramaColorGradePass::AddComputePass(GraphBuilder, GradeParams);
+                }
+
+                if (bLastSample)
+                {
+                    AddEnqueueCopyPass(GraphBuilder, RenderState->Readback.Get(), TileTexture, FIntRect(FIntPoint::ZeroValue, Params.TileSize));
+                }
+                GraphBuilder.QueueTextureExtraction(TileTexture, &RenderState->Accumulation);
+                GraphBuilder.Execute();
+
+                if (bLastSample)
+                {
+                    RenderState->bCopySubmitted = true;
+                }
+            });
+    }
+}
+
+bool FPanoramaTiledStill::ResolveTile(const FIntRect& Tile)
+{
+    if (Tile.Min.X == 0)
+    {
+        Band.SetNumUninitialized(OutputResolution.X * Tile.Height());
+    }
+
+    int32 RowPitchInPixels = 0;
+    const FFloat16Color* Source = static_cast<const FFloat16Color*>(RenderState->Readback->Lock(RowPitchInPixels));
+    if (!Source)
+    {
+        UE_LOG(LogPanoramaCapture, Error, TEXT("Failed to map still tile %d of %d."), NextTile, Tiles.Num());
+        return false;
+    }
+    for (int32 Row = 0; Row < Tile.Height(); ++Row)
+    {
+        FMemory::Memcpy(Band.GetData() + Row * OutputResolution.X + Tile.Min.X, Source + Row * RowPitchInPixels, Tile.Width() * sizeof(FFloat16Color));
+    }
+    RenderState->Readback->Unlock();
+
+    if (Tile.Max.X == OutputResolution.X)
+    {
+        if (!Writer->WriteRows(Band, Tile.Height()))
+        {
+            return false;
+        }
+        UE_LOG(LogPanoramaCapture, Log, TEXT("Still rows %d-%d of %d written."), Tile.Min.Y, Tile.Max.Y - 1, OutputResolution.Y);
+    }
+    return true;
+}
+
+FPanoramaTiledStill::EState FPanoramaTiledStill::Finish(bool bSucceeded)
+{
+    bSucceeded = Writer->Finish() && bSucceeded;
+    if (bSucceeded)
+    {
+        UE_LOG(LogPanoramaCapture, Log, TEXT("Wrote %dx%d still to '%s' in %d tiles, %d sample(s) each."), OutputResolution.X, OutputResolution.Y, *OutputFile, Tiles.Num(), SampleCount);
+    }
+
+    bTileInFlight = false;
+    State = bSucceeded ? EState::Succeeded : EState::Failed;
+    return State;
+}
@@ -0,0 +1,249 @@
+#include "PanoramaViewFamilyCapture.h"
+
+#include "CanvasTypes.h"
+#include "Components/SceneCaptureComponent2D.h"
+#include "Engine/Engine.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "LegacyScreenPercentageDriver.h"
+#include "RenderGraphBuilder.h"
+#include "RenderGraphUtils.h"
+#include "RendererInterface.h"
+#include "RenderingThread.h"
+#include "RHIGlobals.h"
+#include "SceneView.h"
+#include "SceneViewExtension.h"
+#include "TextureResource.h"
+
+namespace
+{
+    /** As the engine's scene capture decides it: only the final colour sources resolve through post processing into the target. */
+    bool CaptureNeedsSceneColor(ESceneCaptureSource CaptureSource)
+    {
+        return CaptureSource != ESceneCaptureSource::SCS_FinalColorLDR
+            && CaptureSource != ESceneCaptureSource::SCS_FinalColorHDR
+            && CaptureSource != ESceneCaptureSource::SCS_FinalToneCurveHDR;
+    }
+
+    FMatrix GetCaptureProjection(const USceneCaptureComponent2D& Capture, const FIntPoint& ViewSize)
+    {
+        if (Capture.bUseCustomProjectionMatrix)
+        {
+            return Capture.CustomProjectionMatrix;
+        }
+
+        // The capture's FOVAngle is horizontal; the vertical angle follows the view's aspect ratio.
+        const float NearClip = Capture.bOverride_CustomNearClippingPlane ? Capture.CustomNearClippingPlane : GNearClippingPlane;
+        const float HalfFov = FMath::DegreesToRadians(Capture.FOVAngle) * 0.5f;
+        return FReversedZPerspectiveMatrix(HalfFov, HalfFov, 1.f, static_cast<float>(ViewSize.X) / ViewSize.Y, NearClip, NearClip);
+    }
+
+    void AddHiddenPrimitives(const USceneCaptureComponent2D& Capture, TSet<FPrimitiveComponentId>& OutHiddenPrimitives)
+    {
+        for (const TWeakObjectPtr<UPrimitiveComponent>& Component : Capture.HiddenComponents)
+        {
+            if (const UPrimitiveComponent* Primitive = Component.Get())
+            {
+                OutHiddenPrimitives.Add(Primitive->ComponentId);
+            }
+        }
+
+        for (const AActor* Actor : Capture.HiddenActors)
+        {
+            if (Actor)
+            {
+                Actor->ForEachComponent<UPrimitiveComponent>(false, [&OutHiddenPrimitives](const UPrimitiveComponent* Primitive)
+                {
+                    OutHiddenPrimitives.Add(Primitive->ComponentId);
+                });
+            }
+        }
+    }
+
+    struct FViewCopy
+    {
+        FTextureRenderTargetResource* Target = nullptr;
+        FIntRect AtlasRect;
+    };
+}
+
+bool FPanoramaViewFamilyCapture::CanShareFamily(const USceneCaptureComponent2D& A, const USceneCaptureComponent2D& B)
+{
+    const UTextureRenderTarget2D* TargetA = A.TextureTarget;
+    const UTextureRenderTarget2D* TargetB = B.TextureTarget;
+    if (!TargetA || !TargetB || TargetA->GetFormat() != TargetB->GetFormat() || TargetA->TargetGamma != TargetB->TargetGamma)
+    {
+        return false;
+    }
+
+    if (A.CaptureSource != B.CaptureSource || A.CompositeMode != B.CompositeMode || A.bAlwaysPersistRenderingState != B.bAlwaysPersistRenderingState)
+    {
+        return false;
+    }
+
+    for (uint32 FlagIndex = 0; FlagIndex < FEngineShowFlags::SF_FirstCustom; ++FlagIndex)
+    {
+        if (A.ShowFlags.GetSingleFlag(FlagIndex) != B.ShowFlags.GetSingleFlag(FlagIndex))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int32 FPanoramaViewFamilyCapture::LayoutViews(TArrayView<FFaceView> Views, FIntPoint& OutAtlasSize)
+{
+    OutAtlasSize = FIntPoint::ZeroValue;
+    if (Views.IsEmpty())
+    {
+        return 0;
+    }
+
+    // Equal cells waste the difference between quality-scaled faces, but the layout then depends on the view count alone and
+    // the atlas stops growing once it fits the largest family.
+    FIntPoint CellSize(1, 1);
+    for (const FFaceView& View : Views)
+    {
+        if (const UTextureRenderTarget2D* Target = View.Capture ? View.Capture->TextureTarget.Get() : nullptr)
+        {
+            CellSize = CellSize.ComponentMax(FIntPoint(Target->SizeX, Target->SizeY));
+        }
+    }
+
+    const int32 MaxTextureSize = static_cast<int32>(GetMax2DTextureDimension());
+    const int32 MaxColumns = FMath::Max(1, MaxTextureSize / CellSize.X);
+    const int32 MaxRows = FMath::Max(1, MaxTextureSize / CellSize.Y);
+    const int32 FittedViews = FMath::Min(Views.Num(), MaxColumns * MaxRows);
+    const int32 Columns = FMath::Min(MaxColumns, FMath::CeilToInt(FMath::Sqrt(static_cast<float>(FittedViews))));
+    const int32 Rows = FMath::DivideAndRoundUp(FittedViews, Columns);
+
+    for (int32 Index = 0; Index < FittedViews; ++Index)
+    {
+        FFaceView& View = Views[Index];
+        const UTextureRenderTarget2D* Target = View.Capture ? View.Capture->TextureTarget.Get() : nullptr;
+        const FIntPoint Min((Index % Columns) * CellSize.X, (Index / Columns) * CellSize.Y);
+        View.AtlasRect = FIntRect(Min, Min + (Target ? FIntPoint(Target->SizeX, Target->SizeY) : FIntPoint::ZeroValue));
+    }
+
+    OutAtlasSize = FIntPoint(Columns * CellSize.X, Rows * CellSize.Y);
+    return FittedViews;
+}
+
+void FPanoramaViewFamilyCapture::Render(UWorld& World, UTextureRenderTarget2D& Atlas, TConstArrayView<FFaceView> Views)
+{
+    FSceneInterface* Scene = World.Scene;
+    FTextureRenderTargetResource* AtlasResource = Atlas.GameThread_GetRenderTargetResource();
+    if (!Scene || !AtlasResource || Views.IsEmpty() || !Views[0].Capture)
+    {
+        return;
+    }
+
+    // CaptureScene does the same, so the views see this frame's transforms.
+    World.SendAllEndOfFrameUpdates();
+
+    // CanShareFamily guarantees the family settings are the same for every view.
+    const USceneCaptureComponent2D& FamilyCapture = *Views[0].Capture;
+    FSceneViewFamilyContext ViewFamily(FSceneViewFamily::ConstructionValues(AtlasResource, Scene, FamilyCapture.ShowFlags)
+        .SetTime(World.GetTime())
+        .SetResolveScene(!CaptureNeedsSceneColor(FamilyCapture.CaptureSource))
+        .SetRealtimeUpdate(FamilyCapture.bAlwaysPersistRenderingState));
+    ViewFamily.SceneCaptureSource = FamilyCapture.CaptureSource;
+    ViewFamily.SceneCaptureCompositeMode = FamilyCapture.CompositeMode;
+
+    ViewFamily.ViewExtensions = GEngine->ViewExtensions->GatherActiveExtensions(FSceneViewExtensionContext(Scene));
+    for (const FSceneViewExtensionRef& Extension : ViewFamily.ViewExtensions)
+    {
+        Extension->SetupViewFamily(ViewFamily);
+    }
+
+    TArray<FViewCopy> Copies;
+    Copies.Reserve(Views.Num());
+    for (const FFaceView& FaceView : Views)
+    {
+        USceneCaptureComponent2D* Capture = FaceView.Capture;
+        FTextureRenderTargetResource* TargetResource = (Capture && Capture->TextureTarget) ? Capture->TextureTarget->GameThread_GetRenderTargetResource() : nullptr;
+        if (!TargetResource || FaceView.AtlasRect.Area() <= 0)
+        {
+            continue;
+        }
+
+        FSceneViewInitOptions ViewInitOptions;
+        ViewInitOptions.SetViewRectangle(FaceView.AtlasRect);
+        ViewInitOptions.ViewFamily = &ViewFamily;
+        ViewInitOptions.ViewActor = Capture->GetViewOwner();
+        ViewInitOptions.ViewOrigin = Capture->GetComponentLocation();
+        // Same basis change as the engine's scene capture: UE's X forward, Y right, Z up to the view's Z forward, X right, Y up.
+        ViewInitOptions.ViewRotationMatrix = FInverseRotationMatrix(Capture->GetComponentRotation()) * FMatrix(
+            FPlane(0, 0, 1, 0),
+            FPlane(1, 0, 0, 0),
+            FPlane(0, 1, 0, 0),
+            FPlane(0, 0, 0, 1));
+        ViewInitOptions.ProjectionMatrix = GetCaptureProjection(*Capture, FaceView.AtlasRect.Size());
+        ViewInitOptions.FOV = Capture->FOVAngle;
+        ViewInitOptions.DesiredFOV = Capture->FOVAngle;
+        ViewInitOptions.OverrideFarClippingPlaneDistance = Capture->MaxViewDistanceOverride;
+        ViewInitOptions.LODDistanceFactor = FMath::Clamp(Capture->LODDistanceFactor, 0.01f, 100.f);
+        // Each face keeps the capture's own view state, so occlusion history and exposure carry over between backends.
+        ViewInitOptions.SceneViewStateInterface = Capture->GetViewState(0);
+        ViewInitOptions.BackgroundColor = FLinearColor::Black;
+        ViewInitOptions.StereoPass = EStereoscopicPass::eSSP_FULL;
+        ViewInitOptions.bIsSceneCapture = true;
+        AddHiddenPrimitives(*Capture, ViewInitOptions.HiddenPrimitives);
+
+        FSceneView* View = new FSceneView(ViewInitOptions);
+        ViewFamily.Views.Add(View);
+
+        View->StartFinalPostprocessSettings(ViewInitOptions.ViewOrigin);
+        View->OverridePostProcessSettings(Capture->PostProcessSettings, Capture->PostProcessBlendWeight);
+        View->EndFinalPostprocessSettings(ViewInitOptions);
+
+        for (const FSceneViewExtensionRef& Extension : ViewFamily.ViewExtensions)
+        {
+            Extension->SetupView(ViewFamily, *View);
+        }
+
+        FViewCopy& Copy = Copies.AddDefaulted_GetRef();
+        Copy.Target = TargetResource;
+        Copy.AtlasRect = FaceView.AtlasRect;
+    }
+
+    if (ViewFamily.Views.IsEmpty())
+    {
+        return;
+    }
+
+    ViewFamily.SetScreenPercentageInterface(new FLegacyScreenPercentageDriver(ViewFamily, 1.f));
+
+    FCanvas Canvas(AtlasResource, nullptr, &World, World.GetFeatureLevel(), FCanvas::CDM_DeferDrawing, 1.f);
+    GetRendererModule().BeginRenderingViewFamily(&Canvas, &ViewFamily);
+
+    // Queued behind the family's render, so the face targets hold this frame before any projection pass reads them.
+    ENQUEUE_RENDER_COMMAND(PanoramaCopyFaceViews)(
+        [AtlasResource, Copies = MoveTemp(Copies)](FRHICommandListImmediate& RHICmdList)
+        {
+            FTextureRHIRef AtlasRHI = AtlasResource->GetRenderTargetTexture();
+            if (!AtlasRHI.IsValid())
+            {
+                return;
+            }
+
+            FRDGBuilder GraphBuilder(RHICmdList);
+            FRDGTextureRef AtlasTexture = GraphBuilder.RegisterExternalTexture(CreateRenderTarget(AtlasRHI, TEXT("PanoramaViewFamilyAtlas")));
+            for (const FViewCopy& Copy : Copies)
+            {
+                FTextureRHIRef TargetRHI = Copy.Target->GetRenderTargetTexture();
+                if (!TargetRHI.IsValid())
+                {
+                    continue;
+                }
+
+                FRHICopyTextureInfo CopyInfo;
+                CopyInfo.SourcePosition = FIntVector(Copy.AtlasRect.Min.X, Copy.AtlasRect.Min.Y, 0);
+                CopyInfo.Size = FIntVector(Copy.AtlasRect.Width(), Copy.AtlasRect.Height(), 1);
+                FRDGTextureRef TargetTexture = GraphBuilder.RegisterExternalTexture(CreateRenderTarget(TargetRHI, TEXT("PanoramaFace")));
+                AddCopyTexturePass(GraphBuilder, AtlasTexture, TargetTexture, CopyInfo);
+            }
+            GraphBuilder.Execute();
+        });
+}
@@ -0,0 +1,231 @@
+#include "PanoramaYUV.h"
+
+#include "Async/ParallelFor.h"
+#include "Math/VectorRegister.h"
+
+namespace
+{
+    constexpr float EncodeGamma = 1.f / 2.2f;
+    constexpr int32 BlockRowsPerTask = 16;
+
+    bool ValidateParams(const FPanoramaYUVConvertCPUParams& Params)
+    {
+        if (Params.Size.X <= 0 || Params.Size.Y <= 0)
+        {
+            return false;
+        }
+
+        const int64 BytesPerPixel = Params.bIs16Bit ? 8 : 4;
+        return Params.Payload.Num() >= static_cast<int64>(Params.Size.X) * Params.Size.Y * BytesPerPixel;
+    }
+
+    void AllocatePlanes(const FPanoramaYUVConvertCPUParams& Params, FPanoramaYUVPlanes& OutPlanes)
+    {
+        OutPlanes.Size = Params.Size;
+        OutPlanes.bIsP010 = Params.bP010;
+        OutPlanes.Luma.SetNumUninitialized(OutPlanes.GetLumaPitch() * Params.Size.Y);
+        OutPlanes.Chroma.SetNumUninitialized(OutPlanes.GetChromaPitch() * PanoramaYUV::GetChromaSize(Params.Size).Y);
+    }
+
+    /** Rounds a code already clamped to the valid range into sample Index of Plane. */
+    FORCEINLINE void StoreSample(uint8* Plane, int64 Index, float Code, bool bP010)
+    {
+        if (bP010)
+        {
+            const uint16 Value = static_cast<uint16>(FMath::RoundToInt(Code) << PanoramaYUV::P010Shift);
+            FMemory::Memcpy(Plane + Index * sizeof(uint16), &Value, sizeof(Value));
+        }
+        else
+        {
+            Plane[Index] = static_cast<uint8>(FMath::RoundToInt(Code));
+        }
+    }
+
+    FORCEINLINE int64 GetPayloadIndex(const FPanoramaYUVConvertCPUParams& Params, int32 X, int32 Y)
+    {
+        // Odd sizes repeat the last column and row into the final chroma block.
+        return (static_cast<int64>(FMath::Min(Y, Params.Size.Y - 1)) * Params.Size.X + FMath::Min(X, Params.Size.X - 1)) * 4;
+    }
+
+    FVector3f FetchScalar(const FPanoramaYUVConvertCPUParams& Params, int32 X, int32 Y)
+    {
+        const int64 Index = GetPayloadIndex(Params, X, Y);
+        FVector3f Color;
+        if (Params.bIs16Bit)
+        {
+            const uint16* Pixel = reinterpret_cast<const uint16*>(Params.Payload.GetData()) + Index;
+            Color = FVector3f(Pixel[0], Pixel[1], Pixel[2]) / 65535.f;
+        }
+        else
+        {
+            const uint8* Pixel = Params.Payload.GetData() + Index;
+            Color = FVector3f(Pixel[0], Pixel[1], Pixel[2]) / 255.f;
+        }
+
+        if (Params.bEncodeGamma)
+        {
+            Color = FVector3f(
+                FMath::Pow(FMath::Clamp(Color.X, 0.f, 1.f), EncodeGamma),
+                FMath::Pow(FMath::Clamp(Color.Y, 0.f, 1.f), EncodeGamma),
+                FMath::Pow(FMath::Clamp(Color.Z, 0.f, 1.f), EncodeGamma));
+        }
+        return Color;
+    }
+
+    /** The conversion matrix by column, with the code range and offset of each output channel. W is unused. */
+    struct FVectorConversion
+    {
+        VectorRegister4Float Red;
+        VectorRegister4Float Green;
+        VectorRegister4Float Blue;
+        VectorRegister4Float CodeRange;
+        VectorRegister4Float CodeOffset;
+        VectorRegister4Float MaxCode;
+        VectorRegister4Float PayloadScale;
+        VectorRegister4Float Gamma;
+
+        explicit FVectorConversion(const FPanoramaYUVConvertCPUParams& Params)
+        {
+            const PanoramaYUV::FCoefficients Coefficients = PanoramaYUV::GetCoefficients(Params.Matrix);
+            const float CodeScale = PanoramaYUV::GetCodeScale(Params.bP010);
+            Red = MakeVectorRegisterFloat(Coefficients.Luma.X, Coefficients.Cb.X, Coefficients.Cr.X, 0.f);
+            Green = MakeVectorRegisterFloat(Coefficients.Luma.Y, Coefficients.Cb.Y, Coefficients.Cr.Y, 0.f);
+            Blue = MakeVectorRegisterFloat(Coefficients.Luma.Z, Coefficients.Cb.Z, Coefficients.Cr.Z, 0.f);
+            CodeRange = MakeVectorRegisterFloat(219.f * CodeScale, 224.f * CodeScale, 224.f * CodeScale, 0.f);
+            CodeOffset = MakeVectorRegisterFloat(16.f * CodeScale, 128.f * CodeScale, 128.f * CodeScale, 0.f);
+            MaxCode = VectorSetFloat1(256.f * CodeScale - 1.f);
+            PayloadScale = VectorSetFloat1(Params.bIs16Bit ? 1.f / 65535.f : 1.f / 255.f);
+            Gamma = VectorSetFloat1(EncodeGamma);
+        }
+    };
+
+    FORCEINLINE VectorRegister4Float FetchVector(const FPanoramaYUVConvertCPUParams& Params, const FVectorConversion& Conversion, int32 X, int32 Y)
+    {
+        const int64 Index = GetPayloadIndex(Params, X, Y);
+        VectorRegister4Float Color;
+        if (Params.bIs16Bit)
+        {
+            const uint16* Pixel = reinterpret_cast<const uint16*>(Params.Payload.GetData()) + Index;
+            Color = VectorMultiply(MakeVectorRegisterFloat(static_cast<float>(Pixel[0]), static_cast<float>(Pixel[1]), static_cast<float>(Pixel[2]), 0.f), Conversion.PayloadScale);
+        }
+        else
+        {
+            Color = VectorMultiply(VectorLoadByte4(Params.Payload.GetData() + Index), Conversion.PayloadScale);
+        }
+
+        if (Params.bEncodeGamma)
+        {
+            Color = VectorPow(VectorMin(VectorMax(Color, VectorZeroFloat()), VectorOneFloat()), Conversion.Gamma);
+        }
+        return Color;
+    }
+
+    /** Y', Cb and Cr of one pixel in XYZ, as unclamped codes. */
+    FORCEINLINE VectorRegister4Float TransformVector(const FVectorConversion& Conversion, const VectorRegister4Float& Color)
+    {
+        VectorRegister4Float Result = VectorMultiply(VectorReplicate(Color, 0), Conversion.Red);
+        Result = VectorMultiplyAdd(VectorReplicate(Color, 1), Conversion.Green, Result);
+        Result = VectorMultiplyAdd(VectorReplicate(Color, 2), Conversion.Blue, Result);
+        return VectorMultiplyAdd(Result, Conversion.CodeRange, Conversion.CodeOffset);
+    }
+
+    void ConvertBlockRows(const FPanoramaYUVConvertCPUParams& Params, const FVectorConversion& Conversion, int32 FirstBlockRow, int32 EndBlockRow, FPanoramaYUVPlanes& OutPlanes)
+    {
+        const FIntPoint ChromaSize = PanoramaYUV::GetChromaSize(Params.Size);
+        const VectorRegister4Float Quarter = VectorSetFloat1(0.25f);
+        uint8* Luma = OutPlanes.Luma.GetData();
+        uint8* Chroma = OutPlanes.Chroma.GetData();
+
+        alignas(16) float Codes[4];
+
+        for (int32 BlockY = FirstBlockRow; BlockY < EndBlockRow; ++BlockY)
+        {
+            for (int32 BlockX = 0; BlockX < ChromaSize.X; ++BlockX)
+            {
+                // The transform is linear, so the mean of the four pixels' codes is the code of their mean colour.
+                VectorRegister4Float BlockSum = VectorZeroFloat();
+                for (int32 Corner = 0; Corner < 4; ++Corner)
+                {
+                    const int32 X = BlockX * 2 + (Corner & 1);
+                    const int32 Y = BlockY * 2 + (Corner >> 1);
+                    const VectorRegister4Float Code = TransformVector(Conversion, FetchVector(Params, Conversion, X, Y));
+                    BlockSum = VectorAdd(BlockSum, Code);
+
+                    if (X < Params.Size.X && Y < Params.Size.Y)
+                    {
+                        VectorStoreAligned(VectorMin(VectorMax(Code, VectorZeroFloat()), Conversion.MaxCode), Codes);
+                        StoreSample(Luma, static_cast<int64>(Y) * Params.Size.X + X, Codes[0], Params.bP010);
+                    }
+                }
+
+                VectorStoreAligned(VectorMin(VectorMax(VectorMultiply(BlockSum, Quarter), VectorZeroFloat()), Conversion.MaxCode), Codes);
+                const int64 ChromaIndex = (static_cast<int64>(BlockY) * ChromaSize.X + BlockX) * 2;
+                StoreSample(Chroma, ChromaIndex, Codes[1], Params.bP010);
+                StoreSample(Chroma, ChromaIndex + 1, Codes[2], Params.bP010);
+            }
+        }
+    }
+}
+
+bool FPanoramaYUVConvertCPU::Convert(const FPanoramaYUVConvertCPUParams& Params, FPanoramaYUVPlanes& OutPlanes)
+{
+    if (!ValidateParams(Params))
+    {
+        return false;
+    }
+
+    AllocatePlanes(Params, OutPlanes);
+
+    const FVectorConversion Conversion(Params);
+    const int32 BlockRows = PanoramaYUV::GetChromaSize(Params.Size).Y;
+    const int32 TaskCount = FMath::DivideAndRoundUp(BlockRows, BlockRowsPerTask);
+
+    ParallelFor(TaskCount, [&Params, &Conversion, &OutPlanes, BlockRows](int32 TaskIndex)
+    {
+        const int32 FirstBlockRow = TaskIndex * BlockRowsPerTask;
+        ConvertBlockRows(Params, Conversion, FirstBlockRow, FMath::Min(FirstBlockRow + BlockRowsPerTask, BlockRows), OutPlanes);
+    });
+
+    return true;
+}
+
+bool FPanoramaYUVConvertCPU::ConvertReference(const FPanoramaYUVConvertCPUParams& Params, FPanoramaYUVPlanes& OutPlanes)
+{
+    if (!ValidateParams(Params))
+    {
+        return false;
+    }
+
+    AllocatePlanes(Params, OutPlanes);
+
+    const PanoramaYUV::FCoefficients Coefficients = PanoramaYUV::GetCoefficients(Params.Matrix);
+    const float CodeScale = PanoramaYUV::GetCodeScale(Params.bP010);
+    const float MaxCode = 256.f * CodeScale - 1.f;
+    const FIntPoint ChromaSize = PanoramaYUV::GetChromaSize(Params.Size);
+
+    for (int32 Y = 0; Y < Params.Size.Y; ++Y)
+    {
+        for (int32 X = 0; X < Params.Size.X; ++X)
+        {
+            const float Luma = (16.f + 219.f * (FetchScalar(Params, X, Y) | Coefficients.Luma)) * CodeScale;
+            StoreSample(OutPlanes.Luma.GetData(), static_cast<int64>(Y) * Params.Size.X + X, FMath::Clamp(Luma, 0.f, MaxCode), Params.bP010);
+        }
+    }
+
+    for (int32 BlockY = 0; BlockY < ChromaSize.Y; ++BlockY)
+    {
+        for (int32 BlockX = 0; BlockX < ChromaSize.X; ++BlockX)
+        {
+            const FVector3f Mean = (FetchScalar(Params, BlockX * 2, BlockY * 2) + FetchScalar(Params, BlockX * 2 + 1, BlockY * 2)
+                + FetchScalar(Params, BlockX * 2, BlockY * 2 + 1) + FetchScalar(Params, BlockX * 2 + 1, BlockY * 2 + 1)) * 0.25f;
+            const float Cb = (128.f + 224.f * (Mean | Coefficients.Cb)) * CodeScale;
+            const float Cr = (128.f + 224.f * (Mean | Coefficients.Cr)) * CodeScale;
+
+            const int64 ChromaIndex = (static_cast<int64>(BlockY) * ChromaSize.X + BlockX) * 2;
+            StoreSample(OutPlanes.Chroma.GetData(), ChromaIndex, FMath::Clamp(Cb, 0.f, MaxCode), Params.bP010);
+            StoreSample(OutPlanes.Chroma.GetData(), ChromaIndex + 1, FMath::Clamp(Cr, 0.f, MaxCode), Params.bP010);
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,80 @@
+#include "PanoramaYUVConvertPass.h"
+
+#include "GlobalShader.h"
+#include "PanoramaCaptureModule.h"
+#include "RenderGraphBuilder.h"
+#include "RenderGraphUtils.h"
+#include "ShaderParameterStruct.h"
+#include "ShaderParameterUtils.h"
+#include "ShaderCompilerCore.h"
+#include "ComputeShaderUtils.h"
+#include "RenderGraphEvent.h"
+
+DECLARE_GPU_STAT_NAMED(PanoramaYUVConvert, TEXT("Panorama YUV Convert"));
+
+class FRGBToYUVCS : public FGlobalShader
+{
+public:
+    DECLARE_GLOBAL_SHADER(FRGBToYUVCS);
+    SHADER_USE_PARAMETER_STRUCT(FRGBToYUVCS, FGlobalShader);
+
+    static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+    {
+        return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+    }
+
+    BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+        SHADER_PARAMETER(FUintVector2, SourceSize)
+        SHADER_PARAMETER(FVector3f, LumaWeights)
+        SHADER_PARAMETER(FVector3f, CbWeights)
+        SHADER_PARAMETER(FVector3f, CrWeights)
+        SHADER_PARAMETER(float, CodeScale)
+        SHADER_PARAMETER(float, StorageScale)
+        SHADER_PARAMETER(uint32, bApplySRGB)
+        SHADER_PARAMETER_RDG_TEXTURE(Texture2D<float4>, SourceTexture)
+        SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float>, LumaTexture)
+        SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float2>, ChromaTexture)
+    END_SHADER_PARAMETER_STRUCT()
+};
+
+IMPLEMENT_GLOBAL_SHADER(FRGBToYUVCS, "/PanoramaCapture/Private/RGBToYUV.usf", "MainCS", SF_Compute);
+
+FPanoramaYUVPlaneTextures FPanoramaYUVConvertPass::AddConvertPass(FRDGBuilder& GraphBuilder, const FPanoramaYUVConvertParams& Params)
+{
+    FPanoramaYUVPlaneTextures Planes;
+    if (!Params.SourceTexture || Params.Resolution.X <= 0 || Params.Resolution.Y <= 0)
+    {
+        return Planes;
+    }
+
+    RDG_GPU_STAT_SCOPE(GraphBuilder, PanoramaYUVConvert);
+
+    const FIntPoint ChromaSize = PanoramaYUV::GetChromaSize(Params.Resolution);
+    const ETextureCreateFlags PlaneFlags = TexCreate_ShaderResource | TexCreate_UAV;
+    Planes.Luma = GraphBuilder.CreateTexture(FRDGTextureDesc::Create2D(Params.Resolution, Params.bP010 ? PF_G16 : PF_G8, FClearValueBinding::Black, PlaneFlags), TEXT("PanoramaEncodeLuma"));
+    Planes.Chroma = GraphBuilder.CreateTexture(FRDGTextureDesc::Create2D(ChromaSize, Params.bP010 ? PF_G16R16 : PF_R8G8, FClearValueBinding::Black, PlaneFlags), TEXT("PanoramaEncodeChroma"));
+
+    const PanoramaYUV::FCoefficients Coefficients = PanoramaYUV::GetCoefficients(Params.Matrix);
+
+    FRGBToYUVCS::FParameters* PassParameters = GraphBuilder.AllocParameters<FRGBToYUVCS::FParameters>();
+    PassParameters->SourceSize = FUintVector2(Params.Resolution.X, Params.Resolution.Y);
+    PassParameters->LumaWeights = Coefficients.Luma;
+    PassParameters->CbWeights = Coefficients.Cb;
+    PassParameters->CrWeights = Coefficients.Cr;
+    PassParameters->CodeScale = PanoramaYUV::GetCodeScale(Params.bP010);
+    PassParameters->StorageScale = Params.bP010 ? static_cast<float>(1 << PanoramaYUV::P010Shift) / 65535.f : 1.f / 255.f;
+    PassParameters->bApplySRGB = Params.bApplySRGB ? 1u : 0u;
+    PassParameters->SourceTexture = Params.SourceTexture;
+    PassParameters->LumaTexture = GraphBuilder.CreateUAV(Planes.Luma);
+    PassParameters->ChromaTexture = GraphBuilder.CreateUAV(Planes.Chroma);
+
+    TShaderMapRef<FRGBToYUVCS> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+
+    const FIntVector GroupCount(
+        FMath::DivideAndRoundUp(ChromaSize.X, 8),
+        FMath::DivideAndRoundUp(ChromaSize.Y, 8),
+        1);
+
+    FComputeShaderUtils::AddPass(GraphBuilder, RDG_EVENT_NAME("Panorama::RGBToYUV %s", Params.bP010 ? TEXT("P010") : TEXT("NV12")), ComputeShader, PassParameters, GroupCount);
+    return Planes;
+}
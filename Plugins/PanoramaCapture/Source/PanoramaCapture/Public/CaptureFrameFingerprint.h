@@ -0,0 +1,28 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FPanoramaCaptureFrame;
+
+/**
+ * Compact identity of a resolved frame payload used to elide repeated frames.
+ * The hash catches exact repeats; the coarse luma grid catches near repeats.
+ */
+struct PANORAMACAPTURE_API FCaptureFrameFingerprint
+{
+    static constexpr int32 GridWidth = 32;
+    static constexpr int32 GridHeight = 16;
+
+    uint64 Hash = 0;
+    FIntPoint Resolution = FIntPoint::ZeroValue;
+    bool bIs16Bit = false;
+    TArray<uint8> LumaGrid;
+
+    bool IsValid() const { return Resolution.X > 0 && Resolution.Y > 0; }
+
+    /** Hashes the payload and, when requested, builds the luma grid used for near-duplicate tests. */
+    static FCaptureFrameFingerprint Compute(const FPanoramaCaptureFrame& Frame, bool bBuildLumaGrid);
+
+    /** Exact match when Threshold is zero, otherwise mean absolute luma difference (0-1) must not exceed Threshold. */
+    bool Matches(const FCaptureFrameFingerprint& Other, float Threshold) const;
+};
@@ -8,6 +8,16 @@ struct FPanoramaCaptureFrame
     FPanoramaCaptureFrame() = default;
 
     FPanoramaCaptureFrame(const FIntPoint InResolution, const double InTimeSeconds, const int32 InFrameIndex, const FString& InOutputFile, bool bInIs16Bit, TArray<uint8>&& InPayload)
+        : Resolution(InResolution)
+        , TimeSeconds(InTimeSeconds)
+        , FrameIndex(InFrameIndex)
+        , OutputFile(InOutputFile)
+        , bIs16Bit(bInIs16Bit)
+        , Payload(MakeShared<TArray<uint8>, ESPMode::ThreadSafe>(MoveTemp(InPayload)))
+    {
+    }
+
+    FPanoramaCaptureFrame(const FIntPoint InResolution, const double InTimeSeconds, const int32 InFrameIndex, const FString& InOutputFile, bool bInIs16Bit, TSharedPtr<const TArray<uint8>, ESPMode::ThreadSafe> InPayload)
         : Resolution(InResolution)
         , TimeSeconds(InTimeSeconds)
         , FrameIndex(InFrameIndex)
@@ -17,12 +27,45 @@ struct FPanoramaCaptureFrame
     {
     }
 
+    const uint8* GetPayloadData() const { return Payload.IsValid() ? Payload->GetData() : nullptr; }
+    int64 GetPayloadSize() const { return Payload.IsValid() ? Payload->Num() : 0; }
+
     FIntPoint Resolution = FIntPoint::ZeroValue;
     double TimeSeconds = 0.0;
     int32 FrameIndex = 0;
     FString OutputFile;
     bool bIs16Bit = false;
-    TArray<uint8> Payload;
+    /** Layout of the pixels, so consumers such as the preview and container metadata do not assume equirect. */
+    EPanoramaProjection Projection = EPanoramaProjection::Equirectangular;
+    /** Shared so the PNG writer and preview worker can read the same pixels without copying. */
+    TSharedPtr<const TArray<uint8>, ESPMode::ThreadSafe> Payload;
+};
+
+/**
+ * Recycles frame payload buffers so each readback does not allocate a fresh output-sized array. A buffer handed out by
+ * Acquire returns to the pool when its last reference drops, which for a PNG frame is the end of its write task.
+ */
+class PANORAMACAPTURE_API FCapturePayloadPool : public TSharedFromThis<FCapturePayloadPool, ESPMode::ThreadSafe>
+{
+public:
+    /** Keeps up to InCapacity buffers of InPayloadBytes, allocating them now; buffers of any other size are released. */
+    void Initialize(int32 InCapacity, int32 InPayloadBytes);
+
+    /** A buffer of PayloadBytes from the free list, or a new one when every pooled buffer is still in flight. */
+    TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe> Acquire(int32 PayloadBytes);
+
+    /** Frees every pooled buffer; buffers still in flight are freed when released. */
+    void Empty();
+
+    int32 GetFreeCount() const;
+
+private:
+    void Release(TArray<uint8>* Buffer);
+
+    mutable FCriticalSection CriticalSection;
+    TArray<TUniquePtr<TArray<uint8>>> FreeBuffers;
+    int32 MaxCapacity = 0;
+    int32 BufferBytes = 0;
 };
 
 class PANORAMACAPTURE_API FCaptureFrameRingBuffer
@@ -4,6 +4,8 @@
 #include "Engine/DeveloperSettings.h"
 #include "CaptureOutputSettings.generated.h"
 
+class UTexture;
+
 UENUM(BlueprintType)
 enum class EPanoramaStereoMode : uint8
 {
@@ -12,6 +14,35 @@ enum class EPanoramaStereoMode : uint8
     StereoSideBySide
 };
 
+/** How the rig produces the two eyes of a stereo capture. */
+UENUM(BlueprintType)
+enum class EPanoramaStereoCapture : uint8
+{
+    /** Two cubemaps from eyes offset along the rig's right vector. Stereo is only correct straight ahead and reversed behind. */
+    OffsetCubemaps,
+    /** Omni-directional stereo: narrow vertical slices per eye from points on the viewing circle, stitched per column. Equirect only. */
+    ODSSlices UMETA(DisplayName = "Omni-Directional Stereo Slices"),
+    /**
+     * Offset cubemaps of the near field only, depth-composited over one mono cubemap of everything beyond
+     * StereoFarFieldDistance. Faces are captured scene-linear and graded after stitching.
+     */
+    MonoFarField UMETA(DisplayName = "Mono Far Field")
+};
+
+/** How the rig renders its cube face captures. */
+UENUM(BlueprintType)
+enum class EPanoramaCaptureBackend : uint8
+{
+    /** Every face capture is its own scene render, with its own scene update, visibility, shadow and Lumen setup. */
+    SceneCapture2D UMETA(DisplayName = "Scene Capture 2D"),
+    /**
+     * The faces rendered in one tick become the views of as few scene view families as their show flags allow, so they share
+     * one scene update, view-independent shadow maps and the Lumen scene. Each family renders into an atlas whose view
+     * rectangles are copied into the face targets.
+     */
+    MultiViewFamily UMETA(DisplayName = "Multi-View Family")
+};
+
 UENUM(BlueprintType)
 enum class ECaptureOutputPath : uint8
 {
@@ -24,7 +55,33 @@ enum class EEquiLayout : uint8
 {
     Full360,
     UpperHemisphere,
-    LowerHemisphere
+    LowerHemisphere,
+    /** Forward 180 degrees per eye. Equirect keeps the middle half of the columns; domemaster points the image circle forward. */
+    VR180 UMETA(DisplayName = "VR180")
+};
+
+UENUM(BlueprintType)
+enum class EPanoramaProjection : uint8
+{
+    Equirectangular,
+    /** Equi-angular cubemap, 3x2 faces per eye. Spreads pixels evenly over the sphere instead of oversampling the poles. */
+    EquiAngularCubemap UMETA(DisplayName = "Equi-Angular Cubemap (EAC 3x2)"),
+    /** Square angular fisheye centred on the zenith for planetarium domes. Faces the dome never sees are not rendered. */
+    Domemaster UMETA(DisplayName = "Domemaster Fisheye")
+};
+
+/** Face resampling in the equirect pass, in increasing cost. Each maps to a shader permutation. */
+UENUM(BlueprintType)
+enum class EPanoramaResampleFilter : uint8
+{
+    /** One hardware bilinear fetch per pixel. */
+    Bilinear,
+    /** Catmull-Rom on the face, folded into 9 bilinear fetches. Sharper at the horizon; does not address minification. */
+    Bicubic,
+    /** 1 to 16 bilinear fetches spread over the pixel's projected footprint, so only minifying pixels pay for extra taps. */
+    Footprint UMETA(DisplayName = "Footprint-Aware"),
+    /** SupersampleGrid squared projected sub-pixel fetches for every pixel. */
+    Supersampled
 };
 
 UENUM(BlueprintType)
@@ -34,6 +91,16 @@ enum class EPanoramaGammaSpace : uint8
     Linear
 };
 
+/** Tone curve of the single grading pass applied after stitching. */
+UENUM(BlueprintType)
+enum class EPanoramaTonemapper : uint8
+{
+    /** Exposure only; values above one clip. */
+    None,
+    /** Fitted ACES filmic curve. */
+    ACESFilmic UMETA(DisplayName = "ACES Filmic")
+};
+
 UENUM(BlueprintType)
 enum class ERingBufferOverflowPolicy : uint8
 {
@@ -42,6 +109,17 @@ enum class ERingBufferOverflowPolicy : uint8
     BlockUntilAvailable
 };
 
+UENUM(BlueprintType)
+enum class EPanoramaStillFormat : uint8
+{
+    /** 8 or 16 bits per channel following bUse16BitPNG, encoded in GammaSpace. */
+    PNG,
+    /** Half-float scene-linear RGBA, uncompressed scanlines. */
+    EXR UMETA(DisplayName = "OpenEXR"),
+    /** Uncompressed RGBA, 8 or 16 bits per channel like PNG. Limited to 4 GB of pixel data. */
+    TIFF
+};
+
 UENUM(BlueprintType)
 enum class ENVENCCodec : uint8
 {
@@ -57,6 +135,14 @@ enum class ENVENCRateControlMode : uint8
     CQP
 };
 
+/** Y'CbCr matrix of the 4:2:0 planes handed to encoders that take planar input. Both use limited (video) range codes. */
+UENUM(BlueprintType)
+enum class EPanoramaYUVMatrix : uint8
+{
+    BT709 UMETA(DisplayName = "BT.709"),
+    BT2020 UMETA(DisplayName = "BT.2020 (non-constant luminance)")
+};
+
 USTRUCT(BlueprintType)
 struct FNVENCRateControl
 {
@@ -71,6 +157,8 @@ struct FNVENCRateControl
         , bEnableBFrames(true)
         , BFrameCount(2)
         , bUseP010(false)
+        , bPlanarYUVInput(true)
+        , YUVMatrix(EPanoramaYUVMatrix::BT709)
         , bZeroLatency(false)
         , bAsyncTransfer(true)
         , AsyncDepth(4)
@@ -102,6 +190,12 @@ struct FNVENCRateControl
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NVENC", meta = (ToolTip = "Encode using 10-bit P010 surfaces"))
     bool bUseP010;
 
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NVENC", meta = (ToolTip = "Convert to NV12, or P010 with bUseP010, on the GPU when the encoder accepts planar input. Cuts encoder input from 4 to 1.5 bytes per pixel"))
+    bool bPlanarYUVInput;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NVENC", meta = (EditCondition = "bPlanarYUVInput"))
+    EPanoramaYUVMatrix YUVMatrix;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NVENC", meta = (ToolTip = "Disables lookahead for lowest latency"))
     bool bZeroLatency;
 
@@ -115,6 +209,95 @@ struct FNVENCRateControl
     float VBVMultiplier;
 };
 
+/** UPanoramaCaptureController::CaptureTiledStill options. Resolution, stereo, layout and filter come from the output settings. */
+USTRUCT(BlueprintType)
+struct FPanoramaTiledStillSettings
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Still", meta = (ClampMin = "256", ClampMax = "8192", ToolTip = "Edge of the square output tile converted and read back at a time; bounds the still's VRAM and staging memory. Reduced when a tile's face regions would exceed the largest 2D texture"))
+    int32 TileSize = 2048;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Still", meta = (ClampMin = "1", ClampMax = "16", ToolTip = "Jittered samples averaged per tile for antialiasing. Above one, the face regions each tile needs are re-rendered with a sub-texel camera offset per sample"))
+    int32 SamplesPerTile = 1;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Still")
+    EPanoramaStillFormat Format = EPanoramaStillFormat::PNG;
+};
+
+/**
+ * Grades the stitched panorama once instead of running the post-process chain on every face. Faces then capture
+ * scene-linear colour, so bloom, vignette and other screen-space effects can no longer seam at face borders.
+ */
+USTRUCT(BlueprintType)
+struct FPanoramaColorGradingSettings
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Color", meta = (ToolTip = "Capture faces as scene-linear colour without post-processing and apply exposure, tonemapping and the LUT once after stitching. Capture materials are not applied in this mode"))
+    bool bGradeAfterStitch = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Color", meta = (EditCondition = "bGradeAfterStitch", ClampMin = "-10", ClampMax = "10", ToolTip = "Exposure in stops applied to the scene-linear panorama"))
+    float ExposureCompensation = 0.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Color", meta = (EditCondition = "bGradeAfterStitch"))
+    EPanoramaTonemapper Tonemapper = EPanoramaTonemapper::ACESFilmic;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Color", meta = (EditCondition = "bGradeAfterStitch", ToolTip = "Unwrapped 256x16 colour grading LUT in the post-process volume format, applied to the tonemapped, gamma-encoded colour"))
+    TSoftObjectPtr<UTexture> ColorGradingLUT;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Color", meta = (EditCondition = "bGradeAfterStitch", ClampMin = "0", ClampMax = "1"))
+    float ColorGradingIntensity = 1.f;
+};
+
+/**
+ * Spreads the face captures of a cube-face capture over consecutive engine frames for monitoring, so the capture tick no
+ * longer renders every face at once. Faces of one output frame may then come from different engine frames.
+ */
+USTRUCT(BlueprintType)
+struct FPanoramaTimeSlicingSettings
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Time Slicing", meta = (ToolTip = "Render a few faces per engine frame and stitch the latest render of each. Ignored by ODS slices"))
+    bool bEnabled = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Time Slicing", meta = (EditCondition = "bEnabled", ClampMin = "1", ClampMax = "12", ToolTip = "Face captures rendered per engine frame, counting each eye's faces separately"))
+    int32 FacesPerFrame = 2;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Time Slicing", meta = (EditCondition = "bEnabled", ClampMin = "0", ClampMax = "60", ToolTip = "Engine frames a face may go without rendering. Faces past the bound render on top of FacesPerFrame"))
+    int32 MaxStaleFrames = 6;
+};
+
+/**
+ * Steps the face resolution between MinScale and MaxScale while recording so the capture keeps up with FrameRate. Face
+ * targets for every one of ScaleLevels scales are allocated before the take, so a step only rebinds targets. The output
+ * resolution never changes; the projection resamples the smaller faces. ODS slices are not governed.
+ */
+USTRUCT(BlueprintType)
+struct FPanoramaResolutionGovernorSettings
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Governor", meta = (ToolTip = "Lower the face resolution when the GPU frame exceeds the capture budget or frames back up downstream, and raise it again once there is headroom"))
+    bool bEnabled = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Governor", meta = (EditCondition = "bEnabled", ClampMin = "0.25", ClampMax = "1"))
+    float MinScale = 0.5f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Governor", meta = (EditCondition = "bEnabled", ClampMin = "0.25", ClampMax = "1", ToolTip = "Face edge scale the capture starts at and never exceeds"))
+    float MaxScale = 1.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Governor", meta = (EditCondition = "bEnabled", ClampMin = "0.25", ClampMax = "1", ToolTip = "Share of the capture interval, 1 / FrameRate, that a GPU frame may take"))
+    float GPUBudgetFraction = 0.9f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Governor", meta = (EditCondition = "bEnabled", ClampMin = "2", ClampMax = "6", ToolTip = "Evenly spaced face scales from MaxScale down to MinScale. Each level keeps its own face targets for the whole take, so more levels give finer steps for more VRAM"))
+    int32 ScaleLevels = 3;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Governor", meta = (EditCondition = "bEnabled", ClampMin = "1", ClampMax = "120", ToolTip = "Capture frames measured between adjustments"))
+    int32 AdjustIntervalFrames = 15;
+};
+
 USTRUCT(BlueprintType)
 struct FPanoramaCaptureResolution
 {
@@ -142,12 +325,15 @@ struct FCaptureOutputSettings
         : OutputPath(ECaptureOutputPath::PNGSequence)
         , StereoMode(EPanoramaStereoMode::Mono)
         , OutputLayout(EEquiLayout::Full360)
+        , Projection(EPanoramaProjection::Equirectangular)
         , GammaSpace(EPanoramaGammaSpace::sRGB)
         , FrameRate(30)
         , bEmbedTimecode(true)
         , bRecordAudio(true)
         , bEnablePreview(true)
         , PreviewScale(0.25f)
+        , PreviewRefreshRate(10.f)
+        , bGPUPreview(true)
         , bUseRingBuffer(true)
         , RingBufferPolicy(ERingBufferOverflowPolicy::DropOldest)
         , RingBufferDurationSeconds(4.f)
@@ -169,15 +355,42 @@ struct FCaptureOutputSettings
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture")
     EPanoramaStereoMode StereoMode;
 
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture|Stereo", meta = (EditCondition = "StereoMode != EPanoramaStereoMode::Mono"))
+    EPanoramaStereoCapture StereoCapture = EPanoramaStereoCapture::OffsetCubemaps;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture|Stereo", meta = (EditCondition = "StereoMode != EPanoramaStereoMode::Mono", ClampMin = "0", ClampMax = "20", ToolTip = "Distance between the eyes in centimetres; also the diameter of the ODS viewing circle"))
+    float InterpupillaryDistance = 6.4f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture|Stereo", meta = (EditCondition = "StereoCapture == EPanoramaStereoCapture::ODSSlices", ClampMin = "8", ClampMax = "360", ToolTip = "Slices per eye around the viewing circle. More slices shorten the blend between neighbouring viewpoints at a proportional render cost"))
+    int32 ODSSliceCount = 36;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture|Stereo", meta = (EditCondition = "StereoCapture == EPanoramaStereoCapture::ODSSlices", ClampMin = "1", ClampMax = "64", ToolTip = "Slices rendered and stitched per batch. Slice targets exist for one batch only and are reused by the next"))
+    int32 ODSSliceBatchSize = 8;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture|Stereo", meta = (EditCondition = "StereoCapture == EPanoramaStereoCapture::MonoFarField", ClampMin = "100", ClampMax = "60000", ToolTip = "Scene depth in centimetres beyond which both eyes show the shared mono far field"))
+    float StereoFarFieldDistance = 5000.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture|Stereo", meta = (EditCondition = "StereoCapture != EPanoramaStereoCapture::ODSSlices", ToolTip = "Render the up and down faces once from the rig centre and show them to both eyes, saving a sixth of the stereo face renders"))
+    bool bSharePolarFaces = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture|Stereo", meta = (EditCondition = "bSharePolarFaces", ClampMin = "0", ClampMax = "35", ToolTip = "Latitude band, in degrees, over which the equirect blends the eyes together below the shared polar faces, hiding the disparity step at their seams. Zero keeps full stereo up to the seam"))
+    float PolarStereoFadeDegrees = 15.f;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture")
     EEquiLayout OutputLayout;
 
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture")
+    EPanoramaProjection Projection;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture")
     EPanoramaGammaSpace GammaSpace;
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture")
     FPanoramaCaptureResolution Resolution;
 
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture", meta = (ClampMin = "0.5", ClampMax = "4.0", ToolTip = "Multiplier on the cube face resolution derived from the output resolution. 1 matches the projection's texel density at the horizon"))
+    float FaceSupersampling = 1.f;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture")
     int32 FrameRate;
 
@@ -193,6 +406,42 @@ struct FCaptureOutputSettings
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture", meta = (EditCondition = "bEnablePreview", ClampMin = "0.1", ClampMax = "1.0"))
     float PreviewScale;
 
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture", meta = (EditCondition = "bEnablePreview", ClampMin = "1", ClampMax = "60", ToolTip = "Maximum preview refreshes per second, independent of the capture frame rate"))
+    float PreviewRefreshRate;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture", meta = (EditCondition = "bEnablePreview", ToolTip = "Downsample the panorama into a persistent render target on the GPU instead of reading frames back for the preview"))
+    bool bGPUPreview;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture|Color")
+    FPanoramaColorGradingSettings ColorGrading;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture|Performance")
+    FPanoramaTimeSlicingSettings TimeSlicing;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture|Performance", meta = (ToolTip = "How the cube faces are rendered. Compare both on the target scene with BenchmarkCaptureBackends and stat gpu; ODS slices, the mono far field's far captures and tiled stills always use scene captures"))
+    EPanoramaCaptureBackend CaptureBackend = EPanoramaCaptureBackend::SceneCapture2D;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture|Performance")
+    FPanoramaResolutionGovernorSettings ResolutionGovernor;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture|Performance", meta = (ClampMin = "0", ClampMax = "30", ToolTip = "Frames PrepareCapture renders through the whole pipeline and discards, so shader compilation and first-use allocations happen before recording starts"))
+    int32 WarmupFrames = 3;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture|Projection", meta = (EditCondition = "Projection == EPanoramaProjection::Domemaster", ClampMin = "180", ClampMax = "220", ToolTip = "Full angle covered by the fisheye image circle, in degrees"))
+    float FisheyeFOV = 180.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture|Projection", meta = (ToolTip = "Face resampling filter of the equirect pass. Footprint-aware and supersampled evaluate the projection per tap and bypass the projection LUT"))
+    EPanoramaResampleFilter ResampleFilter = EPanoramaResampleFilter::Bilinear;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture|Projection", meta = (EditCondition = "ResampleFilter == EPanoramaResampleFilter::Supersampled", ClampMin = "2", ClampMax = "4", ToolTip = "Sub-pixel grid edge; taps per pixel are its square"))
+    int32 SupersampleGrid = 2;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture|Projection", meta = (ToolTip = "Look up each output pixel's cube face and UV from a precomputed table instead of evaluating the projection per frame. The table is built on the game thread when the capture is prepared, so enable it only where the projection pass measurably gains"))
+    bool bUseProjectionLUT = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture|Projection", meta = (EditCondition = "bUseProjectionLUT", ToolTip = "Store generated lookup tables under Saved/PanoramaCapture/LUT so later sessions skip generation"))
+    bool bPersistProjectionLUT = false;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture")
     bool bUseRingBuffer;
 
@@ -220,6 +469,15 @@ struct FCaptureOutputSettings
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture|PNG", meta = (EditCondition = "OutputPath == ECaptureOutputPath::PNGSequence"))
     bool bUse16BitPNG = true;
 
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture|PNG", meta = (EditCondition = "OutputPath == ECaptureOutputPath::PNGSequence", ToolTip = "Skip compression and I/O for frames identical to the previous written frame and extend its duration in the ffconcat manifest"))
+    bool bElideDuplicateFrames = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture|PNG", meta = (EditCondition = "OutputPath == ECaptureOutputPath::PNGSequence && bElideDuplicateFrames", ClampMin = "0", ClampMax = "0.1", ToolTip = "Mean luma difference (0-1) below which a frame counts as a repeat. Zero elides exact duplicates only"))
+    float NearDuplicateThreshold = 0.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture|Still")
+    FPanoramaTiledStillSettings Still;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture|NVENC", meta = (EditCondition = "OutputPath == ECaptureOutputPath::NVENCVideo"))
     bool bAutoMuxNVENC;
 
@@ -261,4 +519,7 @@ public:
 
     UPROPERTY(EditAnywhere, Config, Category = "Capture")
     FString FFmpegExecutable;
+
+    UPROPERTY(EditAnywhere, Config, Category = "Editor", meta = (ClampMin = "1", ClampMax = "120", ToolTip = "Upper bound on how often the editor preview grid reacts to published preview frames"))
+    float EditorPreviewMaxRefreshRate;
 };
@@ -2,6 +2,7 @@
 
 #include "CoreMinimal.h"
 #include "Components/SceneComponent.h"
+#include "Components/SceneCaptureComponent.h"
 #include "Engine/SceneCapture2D.h"
 #include "CaptureOutputSettings.h"
 #include "CubemapCaptureRigComponent.generated.h"
@@ -9,6 +10,37 @@
 class UTextureRenderTarget2D;
 class UMaterialInterface;
 
+/**
+ * Render cost of one cube face, so low-value faces such as the floor and sky can render cheaper than the horizon.
+ * Applies to the per-face captures only; ODS slices render every direction alike.
+ */
+USTRUCT(BlueprintType)
+struct FPanoramaFaceQualityProfile
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quality", meta = (ClampMin = "0.25", ClampMax = "1", ToolTip = "Face target edge relative to the density-matched face size. The projection samples the smaller face directly"))
+    float ResolutionScale = 1.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quality", meta = (ClampMin = "0.1", ClampMax = "10", ToolTip = "Scales the distance used for LOD selection; above one switches to lower LODs sooner"))
+    float LODDistanceFactor = 1.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quality|Post Process")
+    bool bSkipBloom = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quality|Post Process")
+    bool bSkipAmbientOcclusion = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quality|Post Process")
+    bool bSkipScreenSpaceReflections = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quality|Post Process")
+    bool bSkipLensFlares = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quality", meta = (ToolTip = "Further show flag overrides for this face, e.g. turning off Particles or Decals on the sky"))
+    TArray<FEngineShowFlagsSetting> ShowFlagSettings;
+};
+
 USTRUCT(BlueprintType)
 struct FPanoramaCaptureFace
 {
@@ -28,6 +60,9 @@ struct FPanoramaCaptureFace
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture")
     FColor DebugColor;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture")
+    FPanoramaFaceQualityProfile Quality;
 };
 
 UCLASS(ClassGroup = (Rendering), meta = (BlueprintSpawnableComponent))
@@ -62,22 +97,245 @@ public:
     void InitializeRig();
     void ReleaseRig();
 
+    /** Renders the active faces, or the next time slice of them while IsTimeSlicingActive; at most one slice per engine frame. */
     void TickRig(float DeltaTime);
 
+    /** Moves the captures to the rig and renders the faces in FaceMask that the layout keeps, for both eyes. */
+    void CaptureFaces(uint8 FaceMask);
+
+    /**
+     * Offsets every face projection by a sub-texel amount, in face texels, for accumulating antialiased stills.
+     * A zero jitter restores the captures' own projection.
+     */
+    void SetProjectionJitter(const FVector2f& JitterTexels);
+
+    /**
+     * Keeps the face captures but gives them no face targets, for stills whose faces would not fit in VRAM; CaptureFaceRegion
+     * then renders only the part of a face each tile needs, and face sizes are no longer clamped to the largest texture.
+     * Takes effect at the next InitializeRig.
+     */
+    void SetRegionCapture(bool bInRegionCapture) { bRegionCapture = bInRegionCapture; }
+
+    bool IsRegionCaptureActive() const { return bRegionCapture; }
+
+    /**
+     * Renders TexelRect of face capture CaptureIndex (eye * 6 + slice) into that capture's region target, resized to the
+     * rectangle, through an off-axis projection, so only that part of the frustum is culled and shaded. TexelRect is in the
+     * face's GetFaceTargetSize texels, where 0 to the edge spans the 90 degree interior. JitterTexels offsets the projection
+     * by target texels. Returns the target, or null outside region capture and for faces the layout drops.
+     */
+    UTextureRenderTarget2D* CaptureFaceRegion(int32 CaptureIndex, const FIntRect& TexelRect, const FVector2f& JitterTexels);
+
     UTextureRenderTarget2D* GetFaceRenderTarget(int32 FaceIndex, bool bLeftEye) const;
 
+    /** Whether OutputSettings.TimeSlicing spreads the face captures over engine frames; ODS and far-field captures render whole. */
+    bool IsTimeSlicingActive() const;
+
+    /**
+     * Renders the next TimeSlicing.FacesPerFrame face captures round-robin, plus every active face that has not rendered
+     * within TimeSlicing.MaxStaleFrames engine frames. The face targets keep each face's most recent render.
+     */
+    void CaptureTimeSlicedFaces();
+
+    /**
+     * Whether OutputSettings.CaptureBackend renders the face captures as views of shared view families. Region capture and
+     * ODS slices always render scene captures, as do the mono far field's far captures.
+     */
+    bool UsesViewFamilies() const;
+
+    /** Engine frames since the least recently rendered active face capture, or INDEX_NONE while one has never rendered. */
+    int32 GetOldestFaceAge() const;
+
+    /**
+     * Whether the right eye reuses the left eye's up and down faces, which then render from the rig centre. The right eye's
+     * GetFaceRenderTarget is null for them, and the projection passes fall back to the left face.
+     */
+    bool SharesPolarFaces() const;
+
+    /** Whether Settings split a stereo face capture into per-eye near fields and one mono far field (EPanoramaStereoCapture::MonoFarField). */
+    static bool UsesMonoFarField(const FCaptureOutputSettings& Settings);
+
+    bool IsMonoFarFieldActive() const { return bStereo && UsesMonoFarField(OutputSettings); }
+
+    /** Whether Settings capture scene-linear faces for a single grading pass after the stitch; the far-field composite needs them too. */
+    static bool CapturesSceneLinear(const FCaptureOutputSettings& Settings);
+
+    /** Mono face FaceIndex beyond the far-field distance while IsMonoFarFieldActive; the eye faces then hold scene depth in alpha. */
+    UTextureRenderTarget2D* GetFarFieldRenderTarget(int32 FaceIndex) const;
+
+    /** Scene depth, in centimetres, that splits the near and far fields. */
+    float GetFarFieldDistance() const { return FMath::Clamp(OutputSettings.StereoFarFieldDistance, 100.f, 60000.f); }
+
+    /** Repositions the captures before the next capture even if the rig has not moved, e.g. after editing Faces. */
+    void MarkCaptureTransformsDirty() { bCaptureTransformsDirty = true; }
+
+    /**
+     * Square face edge needed to match the projection's texel density, scaled by FaceSupersampling. bFitTexture clamps it to
+     * the largest texture the RHI allows, which region captures never allocate.
+     */
+    static int32 ComputeCubeFaceSize(const FCaptureOutputSettings& Settings, bool bFitTexture = true);
+
+    /** ComputeCubeFaceSize scaled by the resolution governor's current scale. */
+    UFUNCTION(BlueprintCallable, Category = "Capture")
+    int32 GetFaceSize() const;
+
+    /**
+     * Face edge scales to keep targets allocated for, largest first, for FPanoramaResolutionGovernorSettings. Takes effect
+     * at the next InitializeRig and selects the first level; ODS slices ignore it.
+     */
+    void SetResolutionScaleLevels(TConstArrayView<float> InLevels);
+
+    /**
+     * Switches every face edge to the allocated level nearest InScale. Nothing is reallocated: each capture moves to that
+     * level's target the next time it renders, so a time-sliced face keeps its last render until then. Returns true when
+     * the face size changed.
+     */
+    bool SetResolutionScale(float InScale);
+
+    float GetResolutionScale() const { return ResolutionScaleLevels[ResolutionLevel]; }
+
+    /** Edge of cube slice FaceIndex's render target: GetFaceSize scaled by the face's quality profile. */
+    UFUNCTION(BlueprintCallable, Category = "Capture")
+    int32 GetFaceTargetSize(int32 FaceIndex) const;
+
+    /**
+     * Allocated edge of cube slice FaceIndex's 2D render target: GetFaceTargetSize plus a FaceBorderTexels gutter on each
+     * side, which the capture's slightly wider field of view fills with the neighbouring faces' scene.
+     */
+    int32 GetFaceTargetExtent(int32 FaceIndex) const;
+
+    /**
+     * Render target memory held by all face captures of the current configuration, every resolution level included, plus
+     * the view family atlases as last sized while UsesViewFamilies. Under region capture, the region targets as last sized.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Capture")
+    int64 GetFaceMemoryBytes() const;
+
+    /** Bit N set when cube slice N contributes to the configured output; other faces are not captured. */
+    uint8 GetActiveFaceMask() const { return ActiveFaceMask; }
+
+    bool IsFaceActive(int32 FaceIndex) const { return (ActiveFaceMask & (1u << FaceIndex)) != 0; }
+
+    UFUNCTION(BlueprintCallable, Category = "Capture")
+    int32 GetActiveFaceCount() const { return FMath::CountBits(ActiveFaceMask); }
+
+    /** Pixels shaded by the face captures for one panorama frame. */
+    UFUNCTION(BlueprintCallable, Category = "Capture")
+    int64 GetRenderedPixelsPerFrame() const;
+
     void SetCaptureMaterial(UMaterialInterface* OverrideMaterial);
 
+    /** Whether Settings render omni-directional stereo slices instead of cube faces: ODS slices, a stereo mode and equirect. */
+    static bool UsesODSSlices(const FCaptureOutputSettings& Settings);
+
+    bool IsODSActive() const { return bStereo && UsesODSSlices(OutputSettings); }
+
+    int32 GetODSSliceCount() const;
+
+    /** Slices rendered per CaptureODSBatch; the slice targets of one batch are all that exist. */
+    int32 GetODSBatchSize() const;
+
+    int32 GetODSBatchCount() const { return FMath::DivideAndRoundUp(GetODSSliceCount(), GetODSBatchSize()); }
+
+    /**
+     * Moves the slice captures to the slices of batch BatchIndex and renders them into the reused batch targets. Their
+     * contents must be consumed before the next batch is captured. Returns the number of slices rendered.
+     */
+    int32 CaptureODSBatch(int32 BatchIndex);
+
+    /** Target of pitch row Row for eye EyeIndex of the BatchSlot-th slice in the current batch. */
+    UTextureRenderTarget2D* GetODSSliceRenderTarget(int32 BatchSlot, int32 EyeIndex, int32 Row) const;
+
+    /** Slice target size matching the equirect's pixels per radian at the slice centre, scaled by FaceSupersampling. */
+    static FIntPoint ComputeODSSliceSize(const FCaptureOutputSettings& Settings);
+
+    /** Tangents of the slice cameras' horizontal and vertical half angles for ComputeODSSliceSize targets. */
+    static FVector2f ComputeODSSliceTanHalfFov(const FCaptureOutputSettings& Settings);
+
 protected:
+    virtual void OnUpdateTransform(EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport = ETeleportType::None) override;
+
     void EnsureFaceCaptures(int32 EyeIndex);
+    void EnsureFarFieldCaptures();
+    void EnsureODSSliceCaptures();
     void UpdateCaptureTransforms();
 
 private:
     void ConfigureCaptureComponent(USceneCaptureComponent2D* Capture) const;
+    void ApplyFaceQuality(USceneCaptureComponent2D* Capture, int32 FaceIndex) const;
+    void RenderFaceCapture(int32 CaptureIndex);
+    /** Renders the faces RenderFaceCapture queued while UsesViewFamilies, one view family per group of compatible captures. */
+    void RenderQueuedFaceViews();
+    int32 GetFaceSizeAtScale(float Scale) const;
+    int32 GetFaceTargetSizeAtScale(int32 FaceIndex, float Scale) const;
+    int64 GetRenderedPixelsAtScale(float Scale) const;
+    /** Points Capture at RenderTarget, widening its field of view to the target's border. */
+    static void BindCaptureTarget(USceneCaptureComponent2D* Capture, UTextureRenderTarget2D* RenderTarget);
+    /** Resizes RenderTarget, creating it if needed, to Size in PixelFormat. */
+    UTextureRenderTarget2D* EnsureFaceTarget(TObjectPtr<UTextureRenderTarget2D>& RenderTarget, const FIntPoint& Size, EPixelFormat PixelFormat, float TargetGamma);
+    /** Whether FaceCaptures[CaptureIndex] exists and renders a face the layout keeps. */
+    bool IsFaceCaptureUsed(int32 CaptureIndex) const;
+    USceneCaptureComponent2D* CreateCaptureComponent();
+    EPixelFormat GetCapturePixelFormat() const;
+    static void DestroyCaptures(TArray<TObjectPtr<USceneCaptureComponent2D>>& Captures, int32 FirstIndex = 0);
 
     UPROPERTY(Transient)
     TObjectPtr<UMaterialInterface> CaptureMaterial;
 
+    /** The target each face capture last rendered into, which holds its latest image. */
     UPROPERTY(Transient)
     TArray<TWeakObjectPtr<UTextureRenderTarget2D>> EyeRenderTargets;
+
+    /** Face targets of every resolution level, indexed Level * 2 * FacesPerEye + CaptureIndex. */
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<UTextureRenderTarget2D>> FaceLevelRenderTargets;
+
+    /** Each face capture's target for CaptureFaceRegion, indexed like FaceCaptures and resized to every region. */
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<UTextureRenderTarget2D>> RegionRenderTargets;
+
+    /** One batch of ODS slice captures and targets, indexed (BatchSlot * 2 + Eye) * PanoramaODS::PitchRows + Row. */
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<USceneCaptureComponent2D>> ODSSliceCaptures;
+
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<UTextureRenderTarget2D>> ODSSliceRenderTargets;
+
+    /** Six mono captures from the rig centre, clipped to the far field, for EPanoramaStereoCapture::MonoFarField. */
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<USceneCaptureComponent2D>> FarFieldCaptures;
+
+    /** Far-field targets of every resolution level, indexed Level * FacesPerEye + FaceIndex. */
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<UTextureRenderTarget2D>> FarFieldRenderTargets;
+
+    /** One atlas per view family rendered in a tick while UsesViewFamilies; each only grows. */
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<UTextureRenderTarget2D>> ViewFamilyAtlases;
+
+    /** FaceCaptures indices RenderFaceCapture queued for RenderQueuedFaceViews, in render order. */
+    TArray<int32> QueuedFaceViews;
+
+    uint8 ActiveFaceMask = 0x3F;
+
+    /** See SetRegionCapture. */
+    bool bRegionCapture = false;
+
+    /** Face edge scales with allocated targets, largest first. */
+    TArray<float> ResolutionScaleLevels = { 1.f };
+
+    /** Index into ResolutionScaleLevels that the captures render at; the controller's resolution governor moves it. */
+    int32 ResolutionLevel = 0;
+
+    /** Set when the rig moves or is reconfigured; the captures are only repositioned then. */
+    bool bCaptureTransformsDirty = true;
+
+    /** GFrameCounter of each face capture's last render, parallel to FaceCaptures; MAX_uint64 until the first. */
+    TArray<uint64> FaceCaptureFrames;
+
+    /** FaceCaptures index the time-sliced round-robin resumes from. */
+    int32 TimeSliceCursor = 0;
+
+    /** GFrameCounter of the last time slice, so the capture timer and the engine tick share one slice per frame. */
+    uint64 LastTimeSliceFrame = MAX_uint64;
 };
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CubemapEquirectPass.h"
+
+/**
+ * Converts mono or stereo cubemaps into a 3x2 equi-angular cubemap per eye (CubemapToEAC.usf). Takes the same dispatch
+ * parameters as FCubemapEquirectPass, with DestinationEquirect receiving the EAC frame; LatitudeRange is ignored because
+ * the layout always covers the full sphere.
+ */
+class PANORAMACAPTURE_API FCubemapEACPass
+{
+public:
+    static void AddComputePass(FRDGBuilder& GraphBuilder, const FCubemapEquirectDispatchParams& Params);
+};
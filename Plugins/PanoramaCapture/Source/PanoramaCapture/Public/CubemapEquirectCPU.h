@@ -0,0 +1,66 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CaptureOutputSettings.h"
+#include "PanoramaProjectionMath.h"
+
+class FPanoramaProjectionLUT;
+
+/** One cube face in float RGBA, row-major. */
+struct FCubemapFaceImage
+{
+    FIntPoint Size = FIntPoint::ZeroValue;
+    TArrayView<const FLinearColor> Pixels;
+    /** Gutter of neighbouring texels around the 90 degree interior, PanoramaProjection::FaceBorderTexels for the rig's face targets. */
+    int32 BorderTexels = 0;
+
+    bool IsValid() const { return Size.X > 0 && Size.Y > 0 && Pixels.Num() >= Size.X * Size.Y; }
+};
+
+/** CPU counterpart of FCubemapEquirectDispatchParams. Faces are ordered +X,-X,+Y,-Y,+Z,-Z like the cube slices. */
+struct FCubemapEquirectCPUParams
+{
+    FCubemapFaceImage FacesLeft[PanoramaProjection::FacesPerEye];
+    FCubemapFaceImage FacesRight[PanoramaProjection::FacesPerEye];
+    FIntPoint OutputResolution = FIntPoint(3840, 2160);
+    /** Equirect uses the latitude and longitude ranges, fisheye uses FieldOfView; EAC always emits the full 3x2 layout. */
+    EPanoramaProjection Projection = EPanoramaProjection::Equirectangular;
+    /** Fisheye image circle in degrees. */
+    float FieldOfView = 180.f;
+    bool bFisheyeForward = false;
+    FVector2f LatitudeRange = FVector2f(0.f, 1.f);
+    FVector2f LongitudeRange = FVector2f(0.f, 1.f);
+    bool bStereo = false;
+    bool bLinearGamma = false;
+    bool bStereoOverUnder = true;
+    /**
+     * Optional table; Convert then skips the projection math entirely. It is only used when its whole key (resolution,
+     * projection, layout, stereo mode and field of view) matches these params, otherwise Convert ignores it.
+     */
+    const FPanoramaProjectionLUT* ProjectionLUT = nullptr;
+};
+
+/**
+ * Cubemap to equirect, EAC or domemaster conversion without an RHI, for -nullrhi farm conversion, restitching face dumps and
+ * checking shader changes against a known-good result.
+ */
+class PANORAMACAPTURE_API FCubemapEquirectCPU
+{
+public:
+    static constexpr int32 TileSize = 64;
+
+    /**
+     * Vectorized conversion; tiles are walked in Morton order and distributed across the task graph. Projections other
+     * than equirect have no separable angle tables and go through a projection LUT, built on the fly when none is supplied.
+     */
+    static bool Convert(const FCubemapEquirectCPUParams& Params, TArray<FLinearColor>& OutPixels);
+
+    /** Single-threaded scalar conversion evaluated pixel by pixel with the shared projection math. */
+    static bool ConvertReference(const FCubemapEquirectCPUParams& Params, TArray<FLinearColor>& OutPixels);
+
+    /** Largest absolute per-channel difference between two images of equal size, or a negative value on size mismatch. */
+    static float ComputeMaxError(TArrayView<const FLinearColor> A, TArrayView<const FLinearColor> B);
+
+    /** Quantizes with the same rounding as the readback resolve so results compare byte for byte with captured payloads. */
+    static void QuantizeToPayload(TArrayView<const FLinearColor> Pixels, bool bIs16Bit, TArray<uint8>& OutPayload);
+};
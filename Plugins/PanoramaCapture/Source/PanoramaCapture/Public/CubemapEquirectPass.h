@@ -3,13 +3,34 @@
 #include "CoreMinimal.h"
 #include "RenderGraphDefinitions.h"
 #include "RHIResources.h"
+#include "CaptureOutputSettings.h"
+#include "PanoramaCubeFaces.h"
 
 struct FCubemapEquirectDispatchParams
 {
-    FRDGTextureRef SourceCubemapLeft = nullptr;
-    FRDGTextureRef SourceCubemapRight = nullptr;
+    FPanoramaCubeFaces Faces;
     FRDGTextureRef DestinationEquirect = nullptr;
+    /** Optional R32_UINT FPanoramaProjectionLUT texture matching OutputResolution; replaces the per-pixel projection math. */
+    FRDGTextureRef ProjectionLUT = nullptr;
     FIntPoint OutputResolution = FIntPoint(3840, 2160);
+    /** Start and extent of the emitted band in full-sphere equirect V; see FPanoramaOutputLayout::GetLatitudeRange. */
+    FVector2f LatitudeRange = FVector2f(0.f, 1.f);
+    /** Start and extent of the emitted columns in full-sphere equirect U; see FPanoramaOutputLayout::GetLongitudeRange. */
+    FVector2f LongitudeRange = FVector2f(0.f, 1.f);
+    /** Image circle of the fisheye projections, in radians. */
+    float FieldOfViewRadians = UE_PI;
+    /** Centre the fisheye on the front (VR180) instead of the zenith (domemaster). */
+    bool bFisheyeForward = false;
+    /** Equirect only; the other projection passes always sample bilinearly. */
+    EPanoramaResampleFilter Filter = EPanoramaResampleFilter::Bilinear;
+    int32 SupersampleGrid = 2;
+    /** Equirect only: DestinationEquirect receives the TileSize pixels starting at TileOffset. A zero TileSize converts the whole frame. */
+    FIntPoint TileOffset = FIntPoint::ZeroValue;
+    FIntPoint TileSize = FIntPoint::ZeroValue;
+    /** Equirect only: blend factor into the existing contents for running means over jittered samples; one overwrites. */
+    float AccumulationWeight = 1.f;
+    /** Equirect stereo only: latitude band below the shared polar faces over which each eye blends into the mean of both. Zero disables. */
+    float PolarStereoFadeRadians = 0.f;
     bool bStereo = false;
     bool bLinearGamma = false;
     bool bStereoOverUnder = true;
@@ -18,5 +39,15 @@ struct FCubemapEquirectDispatchParams
 class PANORAMACAPTURE_API FCubemapEquirectPass
 {
 public:
+    /** Whether Filter can take per-pixel directions from a projection LUT; the multi-tap filters project sub-pixel positions instead. */
+    static bool FilterUsesProjectionLUT(EPanoramaResampleFilter Filter);
+
     static void AddComputePass(FRDGBuilder& GraphBuilder, const FCubemapEquirectDispatchParams& Params);
+
+    /**
+     * Looks up, in ShaderPlatform's global shader map, the permutation AddComputePass binds for every value of every
+     * dimension after RemapPermutation, so a remap onto a permutation that ShouldCompilePermutation skips is caught before
+     * it fails at dispatch. Logs each missing one and returns how many there are.
+     */
+    static int32 VerifyShaderPermutations(EShaderPlatform ShaderPlatform);
 };
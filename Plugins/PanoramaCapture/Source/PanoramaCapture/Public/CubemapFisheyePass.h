@@ -0,0 +1,14 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CubemapEquirectPass.h"
+
+/**
+ * Converts mono or stereo cubemaps into a square angular fisheye per eye (CubemapToFisheye.usf), covering
+ * FieldOfViewRadians around the zenith (domemaster) or, with bFisheyeForward, around the front (VR180). Pixels outside the image circle are cleared to transparent black, as the CPU converter does.
+ */
+class PANORAMACAPTURE_API FCubemapFisheyePass
+{
+public:
+    static void AddComputePass(FRDGBuilder& GraphBuilder, const FCubemapEquirectDispatchParams& Params);
+};
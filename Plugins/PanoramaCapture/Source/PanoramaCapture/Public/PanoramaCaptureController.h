@@ -2,8 +2,10 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "CaptureFrameFingerprint.h"
 #include "CaptureFrameQueue.h"
 #include "CaptureOutputSettings.h"
+#include "PanoramaResolutionGovernor.h"
 
 #include "Async/Future.h"
 #include "VideoEncoder.h"
@@ -14,15 +16,22 @@
 #include "PanoramaCaptureController.generated.h"
 
 class UCubemapCaptureRigComponent;
+class FRHIGPUTextureReadback;
 class UAudioComponent;
 class USoundSubmix;
 class USoundSubmixBase;
+class UTexture;
 class UTexture2D;
+class UTextureRenderTarget2D;
 class UTextRenderComponent;
-class FRHIGPUTextureReadback;
 class IPanoramaVideoEncoder;
+class FPanoramaProjectionLUT;
+class FPanoramaTiledStill;
+struct FPanoramaODSAccumulation;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FPanoramaCaptureStatusChanged, FName, NewStatus);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnPanoramaPreviewUpdated, class UPanoramaCaptureController*);
+DECLARE_MULTICAST_DELEGATE(FOnPanoramaControllersChanged);
 
 UCLASS(ClassGroup = (Rendering), meta = (BlueprintSpawnableComponent))
 class PANORAMACAPTURE_API UPanoramaCaptureController : public UActorComponent
@@ -44,9 +53,41 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Capture")
     void StopCapture();
 
+    /**
+     * Allocates the rig targets, ring buffer slots, lookup tables and readback staging for OutputSettings, then renders
+     * OutputSettings.WarmupFrames frames through the whole pipeline and discards them. Reports the "Ready" status when
+     * done. StartCapture runs it whenever the settings changed since the last call; the resources then stay alive
+     * between takes until ReleaseCaptureResources.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Capture")
+    bool PrepareCapture();
+
+    /**
+     * Whether PrepareCapture has run for the current OutputSettings, so StartCapture can begin recording at once. Edits to
+     * the rig's own clip planes and Faces are re-applied by StartCapture either way.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Capture")
+    bool IsCapturePrepared() const;
+
+    /** Frees what PrepareCapture keeps alive between takes. Not available while recording. */
+    UFUNCTION(BlueprintCallable, Category = "Capture")
+    void ReleaseCaptureResources();
+
     UFUNCTION(BlueprintCallable, Category = "Capture")
     bool IsCapturing() const { return bIsCapturing; }
 
+    /**
+     * Starts one equirect still of the configured resolution in OutputSettings.Still tiles, streamed to disk without holding
+     * the full image (see FPanoramaTiledStill). Tiles are rendered and read back over the following ticks; the status
+     * returns to Idle once the file is written. An empty OutputFile writes into a new capture directory. Not available while
+     * a sequence is recording or another still is in progress.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Capture")
+    bool CaptureTiledStill(const FString& OutputFile);
+
+    UFUNCTION(BlueprintCallable, Category = "Capture")
+    bool IsCapturingStill() const { return ActiveStill.IsValid(); }
+
     UFUNCTION(BlueprintCallable, Category = "Capture")
     int32 GetDroppedFrameCount() const { return FrameBuffer.GetDroppedFrames(); }
 
@@ -57,12 +98,44 @@ public:
     int32 GetBlockedFrameCount() const { return FrameBuffer.GetBlockedFrames(); }
 
     UFUNCTION(BlueprintCallable, Category = "Capture")
-    UTexture2D* GetPreviewTexture() const { return PreviewTexture; }
+    int32 GetElidedFrameCount() const { return ElidedFrameCount; }
+
+    /** Face edge scale the resolution governor currently renders at; 1 when the governor is off. */
+    UFUNCTION(BlueprintCallable, Category = "Capture")
+    float GetResolutionScale() const { return bGovernResolution ? ResolutionGovernor.GetScale() : 1.f; }
+
+    /**
+     * Measures EPanoramaCaptureBackend on the running capture: the rig alternates between the two backends every
+     * FramesPerBackend engine frames, Rounds times each, and the log reports each backend's mean render-thread and GPU
+     * frame time and the difference. The first frames after each switch are not sampled, since those timings still include
+     * the previous backend. Needs a cube-face capture with the resolution governor off. The rig's backend is restored
+     * afterwards or when the capture stops.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Capture")
+    bool BenchmarkCaptureBackends(int32 FramesPerBackend = 300, int32 Rounds = 2);
+
+    /** Returns the GPU preview render target when available, otherwise the CPU-updated preview texture. */
+    UFUNCTION(BlueprintCallable, Category = "Capture")
+    UTexture* GetPreviewTexture() const;
 
     UFUNCTION(BlueprintCallable, Category = "Capture")
     FString GetActiveCaptureDirectory() const { return ActiveCaptureDirectory; }
 
+    UFUNCTION(BlueprintCallable, Category = "Capture")
+    FName GetCurrentStatus() const { return CurrentStatus; }
+
+    /** Controllers registered in non-preview worlds, maintained on register/unregister so tools never need to iterate objects. */
+    static const TArray<TWeakObjectPtr<UPanoramaCaptureController>>& GetActiveControllers();
+
+    /** Broadcast on the game thread whenever a controller publishes a new preview frame. */
+    static FOnPanoramaPreviewUpdated& OnPreviewUpdated();
+
+    /** Broadcast when a controller is registered, unregistered, or starts/stops capturing. */
+    static FOnPanoramaControllersChanged& OnControllersChanged();
+
 protected:
+    virtual void OnRegister() override;
+    virtual void OnUnregister() override;
     virtual void BeginPlay() override;
     virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
@@ -70,6 +143,15 @@ protected:
 private:
     void EnsureRig();
     void CaptureFrame();
+    /** Feeds the governor this capture frame's measurements and resizes the faces when its scale moves. */
+    void UpdateResolutionGovernor();
+    /** Samples this engine frame for BenchmarkCaptureBackends and switches the backend at the end of each phase. */
+    void TickBackendBenchmark();
+    /** Logs what BenchmarkCaptureBackends sampled and restores the rig's backend. */
+    void FinishBackendBenchmark();
+    /** A readback for an OutputResolution frame: pooled staging when available, otherwise a new one. */
+    TSharedPtr<FRHIGPUTextureReadback, ESPMode::ThreadSafe> AcquireReadback(const FIntPoint& OutputResolution);
+    bool SubmitODSSlices(const FIntPoint& OutputResolution, const FVector2f& LatitudeRange, const FVector2f& LongitudeRange, bool bOverUnder);
     void ConsumeFrameQueue();
     void UpdateStatus(FName NewStatus);
     void InitializeRingBuffer();
@@ -80,7 +162,14 @@ private:
     void ShutdownAudioCapture();
     void ProcessPendingReadbacks();
     void WritePNGFrame(FPanoramaCaptureFrame&& Frame);
-    void UpdatePreviewFromFrame(const FPanoramaCaptureFrame& Frame);
+    /** Decides elision for fingerprinted frames in capture order, stopping at the first hash still running unless bWait is set. */
+    void ResolveFingerprintedFrames(bool bWait);
+    void SubmitPNGWrite(FPanoramaCaptureFrame&& Frame);
+    bool IsPreviewRefreshDue() const;
+    bool UsesGPUPreview() const;
+    void EnsurePreviewRenderTarget(const FIntPoint& OutputResolution);
+    void UpdatePreviewFromFrame(const FPanoramaCaptureFrame& Frame, bool bPreviewOnly);
+    void ApplyPreviewPixels(const FIntPoint& PreviewSize, TArray<uint8>&& PreviewPixels);
     void FinalizeCaptureOutputs();
     void FinalizeNVENCOutput();
     bool AssembleWithFFmpeg(const FString& InputVideo, const FString& AudioFile, const FString& Container, bool bCopyVideoStream, double AudioOffsetSeconds);
@@ -98,6 +187,9 @@ private:
 
     TArray<TSharedPtr<class FPendingCapturePayload, ESPMode::ThreadSafe>> PendingReadbacks;
     TSharedPtr<IPanoramaVideoEncoder> ActiveEncoder;
+    TSharedPtr<const FPanoramaProjectionLUT, ESPMode::ThreadSafe> ActiveProjectionLUT;
+    TSharedPtr<FPanoramaODSAccumulation, ESPMode::ThreadSafe> ODSAccumulation;
+    TSharedPtr<FPanoramaTiledStill> ActiveStill;
     FString ActiveCaptureDirectory;
     FString ActiveBaseFileName;
     FString ActiveElementaryStream;
@@ -105,6 +197,45 @@ private:
     TArray<FString> CapturedFrameFiles;
     TArray<TFuture<void>> PendingWriteTasks;
     TArray<double> CapturedFrameTimes;
+    /** A frame waiting on its worker-side fingerprint before it is written or elided. */
+    struct FFingerprintedFrame
+    {
+        FPanoramaCaptureFrame Frame;
+        TFuture<FCaptureFrameFingerprint> Fingerprint;
+    };
+    /** Oldest first, so elision and the ffconcat bookkeeping follow capture order however the hashes finish. */
+    TArray<FFingerprintedFrame> FingerprintedFrames;
+    FCaptureFrameFingerprint LastWrittenFingerprint;
+    TOptional<double> LastElidedFrameTime;
+    int32 ElidedFrameCount;
+
+    FPanoramaResolutionGovernor ResolutionGovernor;
+    bool bGovernResolution;
+    /** Longest GPU frame seen since the previous capture frame. */
+    float GovernorPeakGPUMilliseconds;
+    /** Dropped and blocked frames, in the ring and the encoder, at the previous governor sample. */
+    int32 GovernorLostFrames;
+
+    /** A BenchmarkCaptureBackends run, with its sums indexed by EPanoramaCaptureBackend. */
+    struct FBackendBenchmark
+    {
+        int32 FramesPerPhase = 0;
+        int32 PhasesLeft = 0;
+        int32 PhaseFrame = 0;
+        EPanoramaCaptureBackend RestoreBackend = EPanoramaCaptureBackend::SceneCapture2D;
+        double RenderThreadMilliseconds[2] = {};
+        double GPUMilliseconds[2] = {};
+        int32 SampledFrames[2] = {};
+    };
+    TOptional<FBackendBenchmark> BackendBenchmark;
+
+    /** Set while PrepareCapture renders frames that are discarded instead of written or encoded. */
+    bool bWarmingUp;
+    /** The OutputSettings PrepareCapture last ran for. */
+    TOptional<FCaptureOutputSettings> PreparedSettings;
+    /** Idle readbacks whose staging textures match ReadbackPoolResolution; a readback never resizes its staging. */
+    TArray<TSharedPtr<FRHIGPUTextureReadback, ESPMode::ThreadSafe>> ReadbackPool;
+    FIntPoint ReadbackPoolResolution;
     TOptional<double> FirstVideoTimestamp;
     TOptional<double> LastVideoTimestamp;
     double AudioCaptureStartSeconds;
@@ -115,6 +246,18 @@ private:
     UPROPERTY(Transient)
     TObjectPtr<UTexture2D> PreviewTexture;
 
+    UPROPERTY(Transient)
+    TObjectPtr<UTextureRenderTarget2D> PreviewRenderTarget;
+
+    /** OutputSettings.ColorGrading.ColorGradingLUT, loaded for the duration of a capture. */
+    UPROPERTY(Transient)
+    TObjectPtr<UTexture> ActiveColorGradingLUT;
+
+    double LastPreviewRefreshSeconds;
+    bool bPreviewTaskInFlight;
+    /** Payload buffers for resolved readbacks, sized to the ring so a recording reuses them instead of allocating per frame. */
+    TSharedPtr<FCapturePayloadPool, ESPMode::ThreadSafe> PayloadPool;
+
     TWeakObjectPtr<USoundSubmixBase> RecordedSubmix;
     UPROPERTY()
     TObjectPtr<UTextRenderComponent> StatusBillboard;
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RenderGraphDefinitions.h"
+#include "CaptureOutputSettings.h"
+
+struct FPanoramaColorGradeParams
+{
+    /** Projection output written scene-linear; graded and encoded in place. */
+    FRDGTextureRef Target = nullptr;
+    FIntPoint Resolution = FIntPoint::ZeroValue;
+    /** Linear multiplier, 2 raised to ExposureCompensation. */
+    float Exposure = 1.f;
+    EPanoramaTonemapper Tonemapper = EPanoramaTonemapper::ACESFilmic;
+    /** Optional unwrapped 256x16 LUT; null skips the lookup. */
+    FRDGTextureRef ColorGradingLUT = nullptr;
+    float ColorGradingIntensity = 1.f;
+    /** Leave the graded colour linear, as EPanoramaGammaSpace::Linear output and the still writers expect. */
+    bool bLinearOutput = false;
+
+    static FPanoramaColorGradeParams FromSettings(const FPanoramaColorGradingSettings& Settings, FRDGTextureRef Target, const FIntPoint& Resolution, bool bLinearOutput);
+};
+
+/** The single grading pass of FPanoramaColorGradingSettings::bGradeAfterStitch, run right after the projection pass. */
+class PANORAMACAPTURE_API FPanoramaColorGradePass
+{
+public:
+    static void AddComputePass(FRDGBuilder& GraphBuilder, const FPanoramaColorGradeParams& Params);
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RenderGraphDefinitions.h"
+#include "ShaderParameterMacros.h"
+#include "PanoramaProjectionMath.h"
+
+/**
+ * The rig's face render targets, sampled in place by the projection passes (PanoramaCubeFaces.ush) instead of being
+ * copied into a cube texture every frame. Faces are ordered +X,-X,+Y,-Y,+Z,-Z like the cube slices.
+ */
+struct PANORAMACAPTURE_API FPanoramaCubeFaces
+{
+    FPanoramaCubeFaces()
+    {
+        for (FBox2f& Region : Regions)
+        {
+            Region.Init();
+        }
+    }
+
+    /** Null faces, such as those culled by the layout, read as black. */
+    FRDGTextureRef Left[PanoramaProjection::FacesPerEye] = {};
+    /** Falls back to the left eye face when null, so mono captures only fill Left. */
+    FRDGTextureRef Right[PanoramaProjection::FacesPerEye] = {};
+    /** Stereo sets must fill Right wherever Left is set, except for the faces in SharedFaceMask. */
+    bool bStereo = false;
+    /** Bit per slice whose left face also serves the right eye, such as polar faces shared between the eyes. */
+    uint8 SharedFaceMask = 0;
+    /**
+     * Nominal face edge; faces that are bound report their own extent, so shrunken faces need nothing extra. Faces carry a
+     * PanoramaProjection::FaceBorderTexels gutter around that edge.
+     */
+    int32 FaceSize = 0;
+    /**
+     * Face UV rectangle (0-1 spans the 90 degree interior) held by each face texture that is only a region of its face, as
+     * FPanoramaTiledStill renders per tile; Left faces first, then Right. Invalid boxes mean the whole face and its gutter.
+     */
+    FBox2f Regions[PanoramaProjection::FacesPerEye * 2];
+    /** Interior edge, in texels, each slice was rendered at where its textures are regions, whose extent does not tell. */
+    int32 RegionFaceSizes[PanoramaProjection::FacesPerEye] = {};
+
+    bool IsValid() const;
+};
+
+BEGIN_SHADER_PARAMETER_STRUCT(FPanoramaCubeFaceParameters, PANORAMACAPTURE_API)
+    SHADER_PARAMETER_ARRAY(FVector4f, FaceSizes, [2])
+    SHADER_PARAMETER_ARRAY(FVector4f, FaceUVRects, [PanoramaProjection::FacesPerEye * 2])
+    SHADER_PARAMETER_RDG_TEXTURE(Texture2D, FaceTexture0)
+    SHADER_PARAMETER_RDG_TEXTURE(Texture2D, FaceTexture1)
+    SHADER_PARAMETER_RDG_TEXTURE(Texture2D, FaceTexture2)
+    SHADER_PARAMETER_RDG_TEXTURE(Texture2D, FaceTexture3)
+    SHADER_PARAMETER_RDG_TEXTURE(Texture2D, FaceTexture4)
+    SHADER_PARAMETER_RDG_TEXTURE(Texture2D, FaceTexture5)
+    SHADER_PARAMETER_RDG_TEXTURE(Texture2D, FaceTexture6)
+    SHADER_PARAMETER_RDG_TEXTURE(Texture2D, FaceTexture7)
+    SHADER_PARAMETER_RDG_TEXTURE(Texture2D, FaceTexture8)
+    SHADER_PARAMETER_RDG_TEXTURE(Texture2D, FaceTexture9)
+    SHADER_PARAMETER_RDG_TEXTURE(Texture2D, FaceTexture10)
+    SHADER_PARAMETER_RDG_TEXTURE(Texture2D, FaceTexture11)
+    SHADER_PARAMETER_SAMPLER(SamplerState, FaceSampler)
+END_SHADER_PARAMETER_STRUCT()
+
+namespace PanoramaCubeFaces
+{
+    /** Binds the faces for PanoramaCubeFaces.ush, substituting a 1x1 black texture for missing faces. */
+    PANORAMACAPTURE_API void SetupParameters(FRDGBuilder& GraphBuilder, const FPanoramaCubeFaces& Faces, FPanoramaCubeFaceParameters& OutParameters);
+}
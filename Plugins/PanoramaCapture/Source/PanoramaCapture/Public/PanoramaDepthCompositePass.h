@@ -0,0 +1,26 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RenderGraphDefinitions.h"
+#include "PanoramaCubeFaces.h"
+
+struct FPanoramaDepthCompositeParams
+{
+    /** Eye face captured as SCS_SceneColorSceneDepth: scene-linear colour with scene depth in alpha. */
+    FRDGTextureRef NearField = nullptr;
+    /** Mono face of the same slice from the rig centre, clipped to start at FarFieldDistance. */
+    FRDGTextureRef FarField = nullptr;
+    /** Scene depth, in centimetres, from which the far field is shown. */
+    float FarFieldDistance = 5000.f;
+};
+
+/** Per-eye depth composite of EPanoramaStereoCapture::MonoFarField, run before the projection passes. */
+class PANORAMACAPTURE_API FPanoramaDepthCompositePass
+{
+public:
+    /** Returns a new face of NearField's size holding the composite, or null without both inputs. */
+    static FRDGTextureRef AddComputePass(FRDGBuilder& GraphBuilder, const FPanoramaDepthCompositeParams& Params);
+
+    /** Replaces every bound eye face of Faces with its composite over the matching far-field face. */
+    static void CompositeFaces(FRDGBuilder& GraphBuilder, FPanoramaCubeFaces& Faces, const FRDGTextureRef (&FarFieldFaces)[PanoramaProjection::FacesPerEye], float FarFieldDistance);
+};
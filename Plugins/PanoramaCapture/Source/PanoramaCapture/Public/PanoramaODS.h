@@ -0,0 +1,119 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CubemapEquirectCPU.h"
+
+/**
+ * Omni-directional stereo geometry shared by the rig, the stitch pass (ODSStitch.usf) and the CPU reference. Angles are in
+ * rig-local Unreal axes: yaw turns right from +X, pitch looks up. The equirect mapping matches the cubemap passes, with the
+ * front at U = 0.75 and the zenith at V = 0.
+ */
+namespace PanoramaODS
+{
+    /** Captures stacked in pitch per slice and eye. They share a camera centre, so rows join without parallax. */
+    constexpr int32 PitchRows = 3;
+
+    /** Vertical half angle every row must cover: 30 degrees to the neighbouring row plus blending slack. */
+    constexpr float RowHalfFovRadians = UE_PI * 35.f / 180.f;
+
+    /** Row 0 looks 60 degrees up, row 1 at the horizon and row 2 60 degrees down. */
+    FORCEINLINE float GetRowPitch(int32 Row)
+    {
+        return (1 - Row) * (UE_PI / 3.f);
+    }
+
+    FORCEINLINE int32 GetRowForPitch(float Pitch)
+    {
+        return Pitch > UE_PI / 6.f ? 0 : (Pitch < -UE_PI / 6.f ? 2 : 1);
+    }
+
+    FORCEINLINE float GetSliceSpacing(int32 SliceCount)
+    {
+        return 2.f * UE_PI / FMath::Max(SliceCount, 1);
+    }
+
+    FORCEINLINE float GetSliceYaw(int32 SliceIndex, int32 SliceCount)
+    {
+        return SliceIndex * GetSliceSpacing(SliceCount);
+    }
+
+    /** A slice blends out over one full spacing towards each neighbour; the margin keeps bilinear taps inside the image. */
+    FORCEINLINE float GetSliceHalfFov(int32 SliceCount)
+    {
+        return GetSliceSpacing(SliceCount) * 1.1f;
+    }
+
+    FORCEINLINE float GetYawFromEquirectU(float U)
+    {
+        return (0.75f - U) * (2.f * UE_PI);
+    }
+
+    FORCEINLINE float GetPitchFromEquirectV(float V)
+    {
+        return (0.5f - V) * UE_PI;
+    }
+
+    /** Where eye EyeIndex (0 left, 1 right) sits when looking along Yaw: on the viewing circle, perpendicular to the view. */
+    FORCEINLINE FVector3f GetEyeOffset(float Yaw, int32 EyeIndex, float InterpupillaryDistance)
+    {
+        float SinYaw, CosYaw;
+        FMath::SinCos(&SinYaw, &CosYaw, Yaw);
+        const float Radius = (EyeIndex == 0 ? -0.5f : 0.5f) * InterpupillaryDistance;
+        return FVector3f(-SinYaw * Radius, CosYaw * Radius, 0.f);
+    }
+
+    /** Tent weight of the slice at SliceYaw for a column at Yaw. The weights of all slices sum to one at every yaw. */
+    FORCEINLINE float GetSliceWeight(float Yaw, float SliceYaw, float SliceSpacing)
+    {
+        return FMath::Max(0.f, 1.f - FMath::Abs(FMath::UnwindRadians(Yaw - SliceYaw)) / SliceSpacing);
+    }
+
+    /**
+     * Image UV of the ray at (Yaw, Pitch) in row Row of the slice camera looking along SliceYaw, with image u to the right
+     * and v down like a scene capture. Returns false behind the camera.
+     */
+    FORCEINLINE bool ProjectToSlice(float Yaw, float Pitch, float SliceYaw, int32 Row, const FVector2f& TanHalfFov, FVector2f& OutUV)
+    {
+        float SinDelta, CosDelta, SinPitch, CosPitch, SinRow, CosRow;
+        FMath::SinCos(&SinDelta, &CosDelta, Yaw - SliceYaw);
+        FMath::SinCos(&SinPitch, &CosPitch, Pitch);
+        FMath::SinCos(&SinRow, &CosRow, GetRowPitch(Row));
+
+        const float X = CosPitch * CosDelta;
+        const float Forward = X * CosRow + SinPitch * SinRow;
+        const float Up = SinPitch * CosRow - X * SinRow;
+        const float Right = CosPitch * SinDelta;
+        if (Forward <= UE_KINDA_SMALL_NUMBER)
+        {
+            return false;
+        }
+
+        OutUV = FVector2f(0.5f + 0.5f * Right / (Forward * TanHalfFov.X), 0.5f - 0.5f * Up / (Forward * TanHalfFov.Y));
+        return true;
+    }
+}
+
+/** CPU counterpart of the ODS stitch pass. */
+struct FPanoramaODSStitchCPUParams
+{
+    /** Slice captures indexed (Slice * 2 + Eye) * PanoramaODS::PitchRows + Row. */
+    TArrayView<const FCubemapFaceImage> Slices;
+    int32 SliceCount = 36;
+    /** Tangents of the slice cameras' horizontal and vertical half angles. */
+    FVector2f SliceTanHalfFov = FVector2f(1.f, 1.f);
+    FIntPoint OutputResolution = FIntPoint(3840, 3840);
+    FVector2f LatitudeRange = FVector2f(0.f, 1.f);
+    FVector2f LongitudeRange = FVector2f(0.f, 1.f);
+    bool bStereoOverUnder = true;
+    bool bLinearGamma = false;
+};
+
+class PANORAMACAPTURE_API FPanoramaODSStitchCPU
+{
+public:
+    /**
+     * Single-threaded stitch evaluated pixel by pixel with PanoramaODS, for checking ODSStitch.usf and restitching slice
+     * dumps. Output is always stereo.
+     */
+    static bool StitchReference(const FPanoramaODSStitchCPUParams& Params, TArray<FLinearColor>& OutPixels);
+};
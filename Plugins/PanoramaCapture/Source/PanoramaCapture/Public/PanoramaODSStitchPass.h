@@ -0,0 +1,52 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RenderGraphDefinitions.h"
+#include "RenderGraphResources.h"
+#include "PanoramaODS.h"
+
+/** One ODS slice: PanoramaODS::PitchRows captures per eye, each eye's rows taken from its point on the viewing circle. */
+struct FPanoramaODSSliceTextures
+{
+    FRDGTextureRef Rows[2][PanoramaODS::PitchRows] = {};
+    int32 SliceIndex = 0;
+
+    bool IsValid() const;
+};
+
+/** Render thread only: the slice sums of the frame in progress, carried across the render commands of its batches. */
+struct FPanoramaODSAccumulation
+{
+    TRefCountPtr<IPooledRenderTarget> Target;
+};
+
+struct FPanoramaODSStitchParams
+{
+    /** CreateAccumulationDesc texture holding the weighted sum of every slice stitched so far; cleared before the first slice. */
+    FRDGTextureRef Accumulation = nullptr;
+    FIntPoint OutputResolution = FIntPoint(3840, 3840);
+    /** Start and extent of the emitted band in full-sphere equirect V; see FPanoramaOutputLayout::GetLatitudeRange. */
+    FVector2f LatitudeRange = FVector2f(0.f, 1.f);
+    /** Start and extent of the emitted columns in full-sphere equirect U; see FPanoramaOutputLayout::GetLongitudeRange. */
+    FVector2f LongitudeRange = FVector2f(0.f, 1.f);
+    int32 SliceCount = 36;
+    /** Tangents of the slice cameras' horizontal and vertical half angles. */
+    FVector2f SliceTanHalfFov = FVector2f(1.f, 1.f);
+    bool bStereoOverUnder = true;
+};
+
+/**
+ * GPU stitch of omni-directional stereo slices into a stereo equirect. Slices arrive in batches whose targets the rig reuses,
+ * so each slice is added to a persistent accumulation as soon as it is rendered and the frame is resolved after the last.
+ */
+class PANORAMACAPTURE_API FPanoramaODSStitchPass
+{
+public:
+    static FRDGTextureDesc CreateAccumulationDesc(const FIntPoint& OutputResolution);
+
+    /** Adds Slice's tent-weighted contribution to the output columns within one slice spacing of its yaw, for both eyes. */
+    static void AddSlicePass(FRDGBuilder& GraphBuilder, const FPanoramaODSStitchParams& Params, const FPanoramaODSSliceTextures& Slice);
+
+    /** Encodes the finished accumulation into Destination the way the projection passes encode their output. */
+    static void AddResolvePass(FRDGBuilder& GraphBuilder, FRDGTextureRef Accumulation, FRDGTextureRef Destination, const FIntPoint& OutputResolution, bool bLinearGamma);
+};
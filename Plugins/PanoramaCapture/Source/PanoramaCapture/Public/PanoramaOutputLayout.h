@@ -0,0 +1,60 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CaptureOutputSettings.h"
+
+struct FPanoramaProjectionLUTKey;
+
+/**
+ * Resolves what a capture configuration actually emits: the cropped output size, the latitude and longitude band it covers,
+ * and which cube faces contribute pixels to it.
+ */
+struct PANORAMACAPTURE_API FPanoramaOutputLayout
+{
+    static constexpr uint8 AllFacesMask = 0x3F;
+    /** +Y and -Y, which stereo rigs may share between the eyes. */
+    static constexpr uint8 PolarFacesMask = 0x0C;
+
+    /**
+     * Size of the emitted frame. Settings.Resolution describes the full sphere; equirect hemisphere layouts keep half of its
+     * rows, equirect VR180 keeps half of its columns and domemaster keeps the largest square per eye.
+     */
+    static FIntPoint GetOutputResolution(const FCaptureOutputSettings& Settings);
+
+    /** The layout the projection actually honours: EAC ignores it, domemaster only distinguishes VR180. */
+    static EEquiLayout GetEffectiveLayout(const FCaptureOutputSettings& Settings);
+
+    /** Per-eye share of GetOutputResolution. */
+    static FIntPoint GetEyeResolution(const FCaptureOutputSettings& Settings);
+
+    /** Settings.FisheyeFOV clamped to the supported 180-220 degree range. */
+    static float GetFisheyeFieldOfView(const FCaptureOutputSettings& Settings);
+
+    /** Start and extent of the emitted band in full-sphere equirect V (0 = up, 1 = down). */
+    static FVector2f GetLatitudeRange(EEquiLayout Layout);
+
+    /** Start and extent of the emitted columns in full-sphere equirect U. */
+    static FVector2f GetLongitudeRange(EEquiLayout Layout);
+
+    /**
+     * Bit N set when cube slice N contributes to at least one output pixel. Evaluated on a grid of output pixel
+     * centres that always includes the border rows and columns, so it works for any projection the LUT can evaluate.
+     */
+    static uint8 ComputeFaceCoverageMask(const FPanoramaProjectionLUTKey& Key);
+
+    /** Faces contributing to the output pixels inside PixelRect (clamped to Key.Resolution), sampled the same way. */
+    static uint8 ComputeFaceCoverageMask(const FPanoramaProjectionLUTKey& Key, const FIntRect& PixelRect);
+
+    /**
+     * Face UV bounds of the output pixels inside PixelRect (clamped to Key.Resolution), per eye * 6 + slice in OutRects;
+     * slots no pixel maps to are left invalid. Pixel centres are sampled on a grid of up to SamplesPerAxis per axis that
+     * includes the border rows and columns, so callers pad the bounds by what one grid step can hide.
+     */
+    static void ComputeFaceCoverageRects(const FPanoramaProjectionLUTKey& Key, const FIntRect& PixelRect, int32 SamplesPerAxis, TArrayView<FBox2f> OutRects);
+
+    /**
+     * JSON description of the projection, stereo packing and latitude crop in Spherical Video V2 terms. FFmpeg cannot
+     * write the sv3d/st3d boxes from the command line, so this is written next to assembled videos for metadata injectors.
+     */
+    static FString BuildSpatialMetadata(const FCaptureOutputSettings& Settings);
+};
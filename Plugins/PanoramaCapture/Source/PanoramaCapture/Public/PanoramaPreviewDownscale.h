@@ -0,0 +1,15 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Box-filtered downscale of a resolved RGBA8/RGBA16 payload into a BGRA8 preview image.
+ * Safe to call from any thread; rows are distributed across the task graph.
+ */
+class PANORAMACAPTURE_API FPanoramaPreviewDownscaler
+{
+public:
+    static FIntPoint ComputePreviewSize(const FIntPoint& SourceSize, float PreviewScale);
+
+    static bool DownscaleToBGRA8(const uint8* Payload, const FIntPoint& SourceSize, bool bIs16Bit, const FIntPoint& PreviewSize, TArray<uint8>& OutPixels);
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RenderGraphDefinitions.h"
+#include "RHIResources.h"
+
+struct FPanoramaPreviewDispatchParams
+{
+    FRDGTextureRef SourceTexture = nullptr;
+    FRDGTextureRef DestinationPreview = nullptr;
+    FIntPoint SourceResolution = FIntPoint::ZeroValue;
+    FIntPoint PreviewResolution = FIntPoint::ZeroValue;
+    bool bApplySRGB = false;
+};
+
+/** Box-filters the projected panorama into a small persistent preview target without leaving the GPU. */
+class PANORAMACAPTURE_API FPanoramaPreviewPass
+{
+public:
+    static void AddDownsamplePass(FRDGBuilder& GraphBuilder, const FPanoramaPreviewDispatchParams& Params);
+};
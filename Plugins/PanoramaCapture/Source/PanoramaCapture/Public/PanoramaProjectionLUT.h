@@ -0,0 +1,91 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CaptureOutputSettings.h"
+#include "HAL/CriticalSection.h"
+#include "RHIResources.h"
+
+class FRHICommandListImmediate;
+
+/** Everything that determines where an output pixel samples the cube. */
+struct PANORAMACAPTURE_API FPanoramaProjectionLUTKey
+{
+    FIntPoint Resolution = FIntPoint::ZeroValue;
+    EPanoramaProjection Projection = EPanoramaProjection::Equirectangular;
+    EEquiLayout Layout = EEquiLayout::Full360;
+    EPanoramaStereoMode StereoMode = EPanoramaStereoMode::Mono;
+    /** Fisheye image circle in degrees; zero for projections without one so they share tables across settings. */
+    float FieldOfView = 0.f;
+
+    static FPanoramaProjectionLUTKey FromSettings(const FCaptureOutputSettings& Settings);
+
+    bool IsValid() const { return Resolution.X > 0 && Resolution.Y > 0; }
+    FString ToString() const;
+
+    bool operator==(const FPanoramaProjectionLUTKey& Other) const
+    {
+        return Resolution == Other.Resolution && Projection == Other.Projection && Layout == Other.Layout && StereoMode == Other.StereoMode && FieldOfView == Other.FieldOfView;
+    }
+
+    friend uint32 GetTypeHash(const FPanoramaProjectionLUTKey& Key)
+    {
+        const uint32 ModeHash = GetTypeHash((static_cast<uint32>(Key.Projection) << 16) | (static_cast<uint32>(Key.Layout) << 8) | static_cast<uint32>(Key.StereoMode));
+        return HashCombine(HashCombine(GetTypeHash(Key.Resolution), ModeHash), GetTypeHash(Key.FieldOfView));
+    }
+};
+
+/**
+ * Per-pixel cube face, face UV and eye for one projection, packed into 32 bits:
+ * bits 0-13 U, 14-27 V (1/16383 of a face), 28-30 face slice (7 = not covered), 31 eye.
+ */
+class PANORAMACAPTURE_API FPanoramaProjectionLUT
+{
+public:
+    static constexpr uint32 FormatVersion = 2;
+    static constexpr uint32 UVMax = (1u << 14) - 1u;
+    static constexpr int32 UncoveredFace = 7;
+
+    static uint32 PackEntry(int32 Face, const FVector2f& FaceUV, int32 EyeIndex);
+    static int32 UnpackEntry(uint32 Entry, FVector2f& OutFaceUV, int32& OutEyeIndex);
+
+    /** Evaluates the projection analytically for one output pixel; false when the projection leaves the pixel empty. */
+    static bool EvaluatePixel(const FPanoramaProjectionLUTKey& Key, const FIntPoint& Pixel, int32& OutEyeIndex, FVector3f& OutDirection);
+
+    static TSharedPtr<FPanoramaProjectionLUT, ESPMode::ThreadSafe> Build(const FPanoramaProjectionLUTKey& Key);
+    static TSharedPtr<FPanoramaProjectionLUT, ESPMode::ThreadSafe> LoadFromFile(const FString& FilePath, const FPanoramaProjectionLUTKey& Key);
+    bool SaveToFile(const FString& FilePath) const;
+
+    const FPanoramaProjectionLUTKey& GetKey() const { return Key; }
+    const TArray<uint32>& GetEntries() const { return Entries; }
+    SIZE_T GetAllocatedSize() const { return Entries.GetAllocatedSize(); }
+
+    /** Render thread only. Uploads the table on first use and returns the persistent R32_UINT texture. */
+    FTextureRHIRef GetOrCreateRHITexture(FRHICommandListImmediate& RHICmdList) const;
+
+    /** Render thread only. Drops the uploaded texture; the next GetOrCreateRHITexture uploads again. */
+    void ReleaseRHITexture() const;
+
+private:
+    FPanoramaProjectionLUTKey Key;
+    TArray<uint32> Entries;
+    mutable FTextureRHIRef RHITexture;
+};
+
+/** Process-wide cache so controllers sharing a configuration share one table and one GPU upload. */
+class PANORAMACAPTURE_API FPanoramaProjectionLUTCache
+{
+public:
+    static FPanoramaProjectionLUTCache& Get();
+
+    /** Returns the cached table, loading it from Saved or generating (and optionally persisting) it on a miss. */
+    TSharedPtr<const FPanoramaProjectionLUT, ESPMode::ThreadSafe> FindOrBuild(const FPanoramaProjectionLUTKey& Key, bool bPersist);
+
+    /** Drops every table and releases their GPU copies on the render thread. Called at module shutdown, before the RHI exits. */
+    void Empty();
+
+    static FString GetPersistentDirectory();
+
+private:
+    FCriticalSection CacheLock;
+    TMap<FPanoramaProjectionLUTKey, TSharedPtr<const FPanoramaProjectionLUT, ESPMode::ThreadSafe>> CachedTables;
+};
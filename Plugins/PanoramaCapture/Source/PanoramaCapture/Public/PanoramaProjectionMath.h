@@ -0,0 +1,170 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Projection helpers shared by the CPU stitchers. They mirror PanoramaProjectionCommon.ush and the projection
+ * shaders so CPU output can be compared directly against GPU readbacks.
+ */
+namespace PanoramaProjection
+{
+    constexpr int32 FacesPerEye = 6;
+
+    /**
+     * Texels of neighbouring scene rendered around each face target's 90 degree interior, so bilinear taps at a face
+     * edge blend into the next face instead of clamping. PanoramaCubeFaces::SetupParameters passes it to the shader in FaceUVRects.
+     */
+    constexpr int32 FaceBorderTexels = 1;
+
+    /** Half field of view, in radians, of a face capture whose InteriorSize texels span 90 degrees plus the border. */
+    FORCEINLINE float GetBorderedFaceHalfFov(int32 InteriorSize)
+    {
+        const float Interior = static_cast<float>(FMath::Max(InteriorSize, 1));
+        return FMath::Atan((Interior + 2.f * FaceBorderTexels) / Interior);
+    }
+
+    /** Equirect UV (0-1) to unit direction, matching DirectionFromEquirect in the shader. */
+    FORCEINLINE FVector3f DirectionFromEquirect(float U, float V)
+    {
+        float SinPhi, CosPhi, SinTheta, CosTheta;
+        FMath::SinCos(&SinPhi, &CosPhi, U * (2.f * UE_PI) - UE_PI);
+        FMath::SinCos(&SinTheta, &CosTheta, V * UE_PI - UE_HALF_PI);
+        return FVector3f(CosPhi * CosTheta, SinTheta, SinPhi * CosTheta);
+    }
+
+    /**
+     * Per-eye UV (0-1) of a 3x2 equi-angular cubemap to unit-cube direction, matching DirectionFromEAC in CubemapToEAC.usf.
+     * The top row holds the left, front (+Z) and right faces upright; the bottom row holds the down, back and up faces as
+     * one continuous band rotated 90 degrees clockwise. Horizontal orientation follows the equirect output.
+     */
+    FORCEINLINE FVector3f DirectionFromEAC(const FVector2f& EyeUV)
+    {
+        const int32 Column = FMath::Min(static_cast<int32>(EyeUV.X * 3.f), 2);
+        const int32 Row = EyeUV.Y >= 0.5f ? 1 : 0;
+
+        // Tile-local coordinates in [-1, 1] are equal angle steps across the 90 degree face.
+        const float A = FMath::Tan(((EyeUV.X * 3.f - Column) * 2.f - 1.f) * (UE_PI * 0.25f));
+        const float B = FMath::Tan(((EyeUV.Y * 2.f - Row) * 2.f - 1.f) * (UE_PI * 0.25f));
+
+        if (Row == 0)
+        {
+            switch (Column)
+            {
+            case 0: return FVector3f(1.f, B, A);
+            case 1: return FVector3f(-A, B, 1.f);
+            default: return FVector3f(-1.f, B, -A);
+            }
+        }
+
+        switch (Column)
+        {
+        case 0: return FVector3f(B, 1.f, -A);
+        case 1: return FVector3f(B, -A, -1.f);
+        default: return FVector3f(B, -1.f, A);
+        }
+    }
+
+    /**
+     * Per-eye UV (0-1) of an angular fisheye to unit direction, matching DirectionFromFisheye in CubemapToFisheye.usf.
+     * A domemaster looks at the zenith with the front (+Z) at the bottom edge; a forward (VR180) fisheye looks at +Z with
+     * the zenith at the top edge. The radius is linear in angle up to half of FieldOfViewRadians. Returns false outside the
+     * image circle.
+     */
+    FORCEINLINE bool DirectionFromFisheye(const FVector2f& EyeUV, float FieldOfViewRadians, bool bForward, FVector3f& OutDirection)
+    {
+        const FVector2f Centered = EyeUV * 2.f - FVector2f(1.f, 1.f);
+        const float Radius = Centered.Size();
+        if (Radius > 1.f)
+        {
+            return false;
+        }
+
+        float SinPolar, CosPolar;
+        FMath::SinCos(&SinPolar, &CosPolar, Radius * FieldOfViewRadians * 0.5f);
+        const FVector2f Azimuth = Radius > UE_SMALL_NUMBER ? Centered / Radius : FVector2f::ZeroVector;
+        OutDirection = bForward
+            ? FVector3f(-Azimuth.X * SinPolar, Azimuth.Y * SinPolar, CosPolar)
+            : FVector3f(-Azimuth.X * SinPolar, -CosPolar, Azimuth.Y * SinPolar);
+        return true;
+    }
+
+    /**
+     * Selects the cube slice (+X,-X,+Y,-Y,+Z,-Z) for a direction using the TextureCube convention and returns the face UV (0-1).
+     * Scale is 0.5 / max(|X|,|Y|,|Z|), supplied by callers that already computed it for several directions at once.
+     */
+    FORCEINLINE int32 CubeFaceFromDirection(const FVector3f& Direction, float Scale, FVector2f& OutFaceUV)
+    {
+        const float AbsX = FMath::Abs(Direction.X);
+        const float AbsY = FMath::Abs(Direction.Y);
+        const float AbsZ = FMath::Abs(Direction.Z);
+
+        int32 Face;
+        float S;
+        float T;
+        if (AbsX >= AbsY && AbsX >= AbsZ)
+        {
+            Face = Direction.X >= 0.f ? 0 : 1;
+            S = Direction.X >= 0.f ? -Direction.Z : Direction.Z;
+            T = -Direction.Y;
+        }
+        else if (AbsY >= AbsZ)
+        {
+            Face = Direction.Y >= 0.f ? 2 : 3;
+            S = Direction.X;
+            T = Direction.Y >= 0.f ? Direction.Z : -Direction.Z;
+        }
+        else
+        {
+            Face = Direction.Z >= 0.f ? 4 : 5;
+            S = Direction.Z >= 0.f ? Direction.X : -Direction.X;
+            T = -Direction.Y;
+        }
+
+        OutFaceUV = FVector2f(S * Scale + 0.5f, T * Scale + 0.5f);
+        return Face;
+    }
+
+    FORCEINLINE int32 CubeFaceFromDirection(const FVector3f& Direction, FVector2f& OutFaceUV)
+    {
+        const float MajorAxis = FMath::Max3(FMath::Abs(Direction.X), FMath::Abs(Direction.Y), FMath::Abs(Direction.Z));
+        return CubeFaceFromDirection(Direction, 0.5f / FMath::Max(MajorAxis, UE_SMALL_NUMBER), OutFaceUV);
+    }
+
+    /** Inverse of CubeFaceFromDirection: face slice and UV back to an (unnormalized) direction. */
+    FORCEINLINE FVector3f DirectionFromCubeFace(int32 Face, const FVector2f& FaceUV)
+    {
+        const float S = FaceUV.X * 2.f - 1.f;
+        const float T = FaceUV.Y * 2.f - 1.f;
+        switch (Face)
+        {
+        case 0: return FVector3f(1.f, -T, -S);
+        case 1: return FVector3f(-1.f, -T, S);
+        case 2: return FVector3f(S, 1.f, T);
+        case 3: return FVector3f(S, -1.f, -T);
+        case 4: return FVector3f(S, -T, 1.f);
+        default: return FVector3f(-S, -T, -1.f);
+        }
+    }
+
+    /** Splits an output UV into the eye index and the per-eye UV for the over-under and side-by-side layouts. */
+    FORCEINLINE int32 ResolveStereoUV(const FVector2f& OutputUV, bool bStereo, bool bOverUnder, FVector2f& OutSampleUV)
+    {
+        OutSampleUV = OutputUV;
+        int32 EyeIndex = 0;
+
+        if (bStereo)
+        {
+            float& Coordinate = bOverUnder ? OutSampleUV.Y : OutSampleUV.X;
+            if (Coordinate >= 0.5f)
+            {
+                EyeIndex = 1;
+                Coordinate -= 0.5f;
+            }
+            Coordinate *= 2.f;
+        }
+
+        OutSampleUV.X = FMath::Clamp(OutSampleUV.X, 0.f, 1.f);
+        OutSampleUV.Y = FMath::Clamp(OutSampleUV.Y, 0.f, 1.f);
+        return EyeIndex;
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CaptureOutputSettings.h"
+
+/** What the controller measured since the previous capture frame. */
+struct FPanoramaGovernorSample
+{
+    /** Longest GPU frame since the previous capture frame, in milliseconds. */
+    float GPUFrameMilliseconds = 0.f;
+    /** Frames waiting in the ring buffer, in readback and in the encoder, relative to the ring capacity. */
+    float QueueFill = 0.f;
+    /** Frames dropped or blocked downstream since the previous sample. */
+    int32 NewlyLostFrames = 0;
+};
+
+/**
+ * Face resolution controller for FPanoramaResolutionGovernorSettings. The scale moves between fixed levels whose face
+ * targets the rig allocates up front. Render cost follows the face area, so the square root of the GPU time ratio says
+ * how far to go: down as many levels as the budget needs under pressure, up one level at a time once it would fit.
+ */
+class PANORAMACAPTURE_API FPanoramaResolutionGovernor
+{
+public:
+    void Reset(const FPanoramaResolutionGovernorSettings& InSettings, int32 FrameRate);
+
+    /** Feeds one capture frame's measurements. Returns true when the scale changed. */
+    bool Update(const FPanoramaGovernorSample& Sample);
+
+    float GetScale() const { return ScaleLevels.IsValidIndex(Level) ? ScaleLevels[Level] : 1.f; }
+
+    /** Scales the rig must allocate face targets for, largest first; GetScale is always one of them. */
+    const TArray<float>& GetScaleLevels() const { return ScaleLevels; }
+
+    /** Smoothed GPU frame time the last decision was based on, in milliseconds. */
+    float GetGPUFrameMilliseconds() const { return SmoothedGPUMilliseconds; }
+
+    float GetBudgetMilliseconds() const { return BudgetMilliseconds; }
+
+private:
+    FPanoramaResolutionGovernorSettings Settings;
+    float BudgetMilliseconds = 0.f;
+    TArray<float> ScaleLevels;
+    int32 Level = 0;
+    float SmoothedGPUMilliseconds = 0.f;
+    float PeakQueueFill = 0.f;
+    int32 LostFrames = 0;
+    int32 FramesSinceAdjust = 0;
+    bool bHasGPUSample = false;
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CaptureOutputSettings.h"
+
+/** Pixel layout of a still written through IPanoramaStillWriter. */
+struct PANORAMACAPTURE_API FPanoramaStillDesc
+{
+    FIntPoint Size = FIntPoint::ZeroValue;
+    /** PNG and TIFF only: 16 instead of 8 bits per channel. EXR is always half float. */
+    bool b16Bit = true;
+    /** PNG and TIFF only: apply the 1/2.2 output curve of the projection shaders before quantizing. EXR stays scene-linear. */
+    bool bEncodeGamma = true;
+};
+
+/**
+ * Streams an image to disk in full-width row bands, top to bottom, so stills larger than any texture or staging buffer
+ * never have to be resident at once. Rows arrive as scene-linear half-float RGBA.
+ */
+class PANORAMACAPTURE_API IPanoramaStillWriter
+{
+public:
+    virtual ~IPanoramaStillWriter() = default;
+
+    /** Appends RowCount rows of Desc.Size.X pixels each. Returns false once any write has failed. */
+    virtual bool WriteRows(TArrayView<const FFloat16Color> Pixels, int32 RowCount) = 0;
+
+    /** Writes the trailing structures and closes the file; fails when fewer rows than Desc.Size.Y were written. */
+    virtual bool Finish() = 0;
+
+    /** Opens OutputFile for Format, or returns null when the file cannot be created or the format cannot hold Desc. */
+    static TUniquePtr<IPanoramaStillWriter> Create(EPanoramaStillFormat Format, const FString& OutputFile, const FPanoramaStillDesc& Desc);
+
+    static const TCHAR* GetFileExtension(EPanoramaStillFormat Format);
+};
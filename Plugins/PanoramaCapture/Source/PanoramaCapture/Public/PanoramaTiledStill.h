@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CaptureOutputSettings.h"
+
+class UCubemapCaptureRigComponent;
+class IPanoramaStillWriter;
+struct FTiledStillRenderState;
+
+/**
+ * Equirect stills beyond texture, staging and encoder limits. The output is converted one Still.TileSize tile at a time into
+ * a single reused tile target, read back, and each finished row of tiles is streamed to an IPanoramaStillWriter, so neither
+ * VRAM nor system memory ever holds the output image. Faces keep the still's full texel density, but each tile renders only
+ * the region of each face it samples, through an off-axis projection into a region-sized target, so VRAM follows the tile
+ * rather than the face (UCubemapCaptureRigComponent::CaptureFaceRegion). Begin shrinks the tile when a region could
+ * otherwise exceed the RHI's largest 2D texture.
+ *
+ * Tiles run one at a time from Tick, which never waits on the GPU: a tile is submitted, then polled on later ticks until its
+ * readback lands.
+ */
+class PANORAMACAPTURE_API FPanoramaTiledStill
+{
+public:
+    enum class EState : uint8
+    {
+        Rendering,
+        Succeeded,
+        Failed
+    };
+
+    /**
+     * Opens the writer and sets up a still of Rig, which must already be initialized for Settings with region capture and stay
+     * so until Tick stops returning Rendering. Returns null when the projection is not equirect or the file cannot be created.
+     */
+    static TSharedPtr<FPanoramaTiledStill> Begin(UCubemapCaptureRigComponent& Rig, const FCaptureOutputSettings& Settings, const FString& OutputFile);
+
+    ~FPanoramaTiledStill();
+
+    /**
+     * Submits the next tile, or collects the one in flight once its readback is ready. Fails when a readback times out, the
+     * rig goes away or the file cannot be written. Once finished it keeps returning the outcome.
+     */
+    EState Tick();
+
+    int32 GetTileCount() const { return Tiles.Num(); }
+    int32 GetCompletedTileCount() const { return NextTile - (bTileInFlight ? 1 : 0); }
+    const FString& GetOutputFile() const { return OutputFile; }
+
+    /** Output pixel rectangles of every tile, row by row from the top-left. */
+    static TArray<FIntRect> BuildTileGrid(const FIntPoint& OutputResolution, int32 TileSize);
+
+    /** Sub-texel camera offset of accumulation sample SampleIndex in [-0.5, 0.5); sample 0 is the texel centre. */
+    static FVector2f GetSampleJitter(int32 SampleIndex);
+
+private:
+    FPanoramaTiledStill() = default;
+
+    void SubmitTile(const FIntRect& Tile);
+    bool ResolveTile(const FIntRect& Tile);
+    EState Finish(bool bSucceeded);
+
+    TWeakObjectPtr<UCubemapCaptureRigComponent> Rig;
+    TUniquePtr<IPanoramaStillWriter> Writer;
+    TSharedPtr<FTiledStillRenderState, ESPMode::ThreadSafe> RenderState;
+    FCaptureOutputSettings Settings;
+    FString OutputFile;
+    FIntPoint OutputResolution = FIntPoint::ZeroValue;
+    int32 TileSize = 0;
+    /** Face texels added around each tile's measured face regions, covering what the coverage grid can miss. */
+    int32 RegionMarginTexels = 0;
+    int32 SampleCount = 1;
+    TArray<FIntRect> Tiles;
+    int32 NextTile = 0;
+    bool bTileInFlight = false;
+    EState State = EState::Rendering;
+    double TileSubmitSeconds = 0.0;
+    /** One full-width band of tile rows is the only part of the image held in system memory. */
+    TArray<FFloat16Color> Band;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UTextureRenderTarget2D;
+class USceneCaptureComponent2D;
+class UWorld;
+
+/**
+ * Renders scene capture components as the views of one scene view family, for EPanoramaCaptureBackend::MultiViewFamily.
+ * Each view takes its capture's transform, field of view or custom projection, near and far clip, LOD distance factor,
+ * hidden primitives, post-process settings and view state, so the capture components stay the single place a face is
+ * configured. The family renders into an atlas and every view rectangle is then copied into its capture's TextureTarget,
+ * which therefore ends up holding what CaptureScene would have rendered there.
+ */
+class PANORAMACAPTURE_API FPanoramaViewFamilyCapture
+{
+public:
+    struct FFaceView
+    {
+        USceneCaptureComponent2D* Capture = nullptr;
+        /** Where the view lands in the family's atlas; set by LayoutViews. */
+        FIntRect AtlasRect;
+    };
+
+    /**
+     * Whether two captures can be views of one family: the family holds the show flags and capture source, and the atlas
+     * the target format, so those must match.
+     */
+    static bool CanShareFamily(const USceneCaptureComponent2D& A, const USceneCaptureComponent2D& B);
+
+    /**
+     * Places the leading views of Views in a grid of equal cells no larger than the largest 2D texture and sets their
+     * AtlasRect. Returns how many views fit, at least one, and the atlas size they need.
+     */
+    static int32 LayoutViews(TArrayView<FFaceView> Views, FIntPoint& OutAtlasSize);
+
+    /**
+     * Renders Views, laid out by LayoutViews, as one view family into Atlas and enqueues the copies of their rectangles
+     * into their captures' targets. Atlas must be at least the laid out size, in their targets' format.
+     */
+    static void Render(UWorld& World, UTextureRenderTarget2D& Atlas, TConstArrayView<FFaceView> Views);
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CaptureOutputSettings.h"
+
+/**
+ * Y'CbCr 4:2:0 conversion shared by the GPU pass (RGBToYUV.usf) and the CPU converter. Input is display-encoded R'G'B';
+ * codes are limited range, 16-235 luma and 16-240 chroma at 8 bits, scaled by 4 at 10 bits. Chroma is the box average of
+ * each 2x2 block.
+ */
+namespace PanoramaYUV
+{
+    /** Rows of the R'G'B' to Y'CbCr matrix. */
+    struct FCoefficients
+    {
+        FVector3f Luma;
+        FVector3f Cb;
+        FVector3f Cr;
+    };
+
+    FORCEINLINE FCoefficients GetCoefficients(EPanoramaYUVMatrix Matrix)
+    {
+        const float Kr = Matrix == EPanoramaYUVMatrix::BT2020 ? 0.2627f : 0.2126f;
+        const float Kb = Matrix == EPanoramaYUVMatrix::BT2020 ? 0.0593f : 0.0722f;
+        const float Kg = 1.f - Kr - Kb;
+
+        FCoefficients Result;
+        Result.Luma = FVector3f(Kr, Kg, Kb);
+        Result.Cb = FVector3f(-Kr, -Kg, 1.f - Kb) / (2.f * (1.f - Kb));
+        Result.Cr = FVector3f(1.f - Kr, -Kg, -Kb) / (2.f * (1.f - Kr));
+        return Result;
+    }
+
+    /** Code scale relative to 8 bits: 1 for NV12, 4 for the 10-bit codes of P010. */
+    FORCEINLINE float GetCodeScale(bool bP010)
+    {
+        return bP010 ? 4.f : 1.f;
+    }
+
+    /** P010 stores the 10-bit code in the high bits of each 16-bit sample. */
+    constexpr int32 P010Shift = 6;
+
+    FORCEINLINE FIntPoint GetChromaSize(const FIntPoint& Size)
+    {
+        return FIntPoint(FMath::DivideAndRoundUp(Size.X, 2), FMath::DivideAndRoundUp(Size.Y, 2));
+    }
+}
+
+/** NV12 or P010 planes in system memory: full-size luma, then interleaved CbCr at half size in both axes, tightly packed. */
+struct FPanoramaYUVPlanes
+{
+    FIntPoint Size = FIntPoint::ZeroValue;
+    bool bIsP010 = false;
+    /** One byte per sample for NV12, one little-endian uint16 per sample for P010. */
+    TArray<uint8> Luma;
+    TArray<uint8> Chroma;
+
+    int32 GetBytesPerSample() const { return bIsP010 ? 2 : 1; }
+    int32 GetLumaPitch() const { return Size.X * GetBytesPerSample(); }
+    int32 GetChromaPitch() const { return PanoramaYUV::GetChromaSize(Size).X * 2 * GetBytesPerSample(); }
+};
+
+struct FPanoramaYUVConvertCPUParams
+{
+    /** RGBA payload as the readback resolve produces it: 8 bits per channel, or uint16 per channel with bIs16Bit. */
+    TArrayView<const uint8> Payload;
+    FIntPoint Size = FIntPoint::ZeroValue;
+    bool bIs16Bit = false;
+    /** Applies the 1/2.2 output curve first, for linear payloads, as the GPU pass does for EPanoramaGammaSpace::Linear. */
+    bool bEncodeGamma = false;
+    bool bP010 = false;
+    EPanoramaYUVMatrix Matrix = EPanoramaYUVMatrix::BT709;
+};
+
+/** CPU counterpart of FPanoramaYUVConvertPass, for software encoders fed from readback payloads and for checking the shader. */
+class PANORAMACAPTURE_API FPanoramaYUVConvertCPU
+{
+public:
+    /** Vectorized conversion; each task converts a band of 2x2 block rows. */
+    static bool Convert(const FPanoramaYUVConvertCPUParams& Params, FPanoramaYUVPlanes& OutPlanes);
+
+    /** Single-threaded scalar conversion written directly from the PanoramaYUV definitions. */
+    static bool ConvertReference(const FPanoramaYUVConvertCPUParams& Params, FPanoramaYUVPlanes& OutPlanes);
+};
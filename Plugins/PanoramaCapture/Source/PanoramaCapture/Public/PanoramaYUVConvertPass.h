@@ -0,0 +1,32 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RenderGraphDefinitions.h"
+#include "PanoramaYUV.h"
+
+struct FPanoramaYUVConvertParams
+{
+    FRDGTextureRef SourceTexture = nullptr;
+    FIntPoint Resolution = FIntPoint::ZeroValue;
+    EPanoramaYUVMatrix Matrix = EPanoramaYUVMatrix::BT709;
+    /** 10-bit P010 planes instead of 8-bit NV12. */
+    bool bP010 = false;
+    /** Source is linear and needs the 1/2.2 output curve, as for the RGBA encode surface. */
+    bool bApplySRGB = false;
+};
+
+/** Luma at full resolution (G8 or G16) and interleaved CbCr at half resolution (R8G8 or G16R16). */
+struct FPanoramaYUVPlaneTextures
+{
+    FRDGTextureRef Luma = nullptr;
+    FRDGTextureRef Chroma = nullptr;
+
+    bool IsValid() const { return Luma && Chroma; }
+};
+
+/** Converts the projected panorama to NV12 or P010 planes for encoders that report IPanoramaVideoEncoder::SupportsPlanarInput. */
+class PANORAMACAPTURE_API FPanoramaYUVConvertPass
+{
+public:
+    static FPanoramaYUVPlaneTextures AddConvertPass(FRDGBuilder& GraphBuilder, const FPanoramaYUVConvertParams& Params);
+};
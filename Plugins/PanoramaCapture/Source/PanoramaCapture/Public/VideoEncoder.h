@@ -25,6 +25,7 @@ struct PANORAMACAPTURE_API FPanoramaVideoEncoderStats
     int32 DroppedFrames = 0;
 };
 
+/** Either RgbaTexture, or 4:2:0 planes from FPanoramaYUVConvertPass with bIsNV12 or bIsP010 set. */
 struct PANORAMACAPTURE_API FPanoramaVideoEncoderFrame
 {
     FRHITexture* RgbaTexture = nullptr;
@@ -49,6 +50,12 @@ public:
     virtual bool FinalizeEncoding(FString& OutElementaryStream) = 0;
     virtual FPanoramaVideoEncoderStats GetStats() const = 0;
 
+    /** True when EncodeFrame accepts LumaTexture and ChromaTexture planes; the controller then skips the RGBA surface. */
+    virtual bool SupportsPlanarInput() const
+    {
+        return false;
+    }
+
     virtual void EncodeTexture(FRHITexture* Texture, double TimeSeconds)
     {
         FPanoramaVideoEncoderFrame Frame;
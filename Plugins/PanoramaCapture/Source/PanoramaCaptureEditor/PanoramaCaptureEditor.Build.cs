@@ -11,12 +11,16 @@ public class PanoramaCaptureEditor : ModuleRules
             "Core",
             "CoreUObject",
             "Engine",
+            "RenderCore",
+            "RHI",
+            "TargetPlatform",
             "Slate",
             "SlateCore",
             "EditorSubsystem",
             "UnrealEd",
             "LevelEditor",
             "Projects",
+            "ImageCore",
             "PanoramaCapture"
         });
     }
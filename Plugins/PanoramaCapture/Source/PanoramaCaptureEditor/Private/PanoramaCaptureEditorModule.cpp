@@ -11,7 +11,6 @@
 #include "Framework/MultiBox/MultiBoxBuilder.h"
 #include "Framework/Application/SlateApplication.h"
 #include "Styling/AppStyle.h"
-#include "UObject/UObjectIterator.h"
 #include "Widgets/Images/SImage.h"
 #include "Widgets/Input/SButton.h"
 #include "Widgets/Input/SCheckBox.h"
@@ -21,88 +20,218 @@
 #include "Widgets/Layout/SSeparator.h"
 #include "Widgets/Layout/SBorder.h"
 #include "Widgets/Layout/SOverlay.h"
+#include "Widgets/Layout/SUniformGridPanel.h"
 #include "Widgets/SBoxPanel.h"
 #include "Widgets/Text/STextBlock.h"
 #include "Widgets/SWindow.h"
 #include "Engine/Texture2D.h"
+#include "GameFramework/Actor.h"
 #include "Slate/SlateBrushAsset.h"
 
 class SPanoramaPreviewWidget : public SCompoundWidget
 {
 public:
-    SLATE_BEGIN_ARGS(SPanoramaPreviewWidget) {}
-        SLATE_ARGUMENT(TFunction<UTexture2D*()>, TextureProvider)
+    SLATE_BEGIN_ARGS(SPanoramaPreviewWidget)
+        : _MaxRefreshRate(15.f)
+    {}
+        SLATE_ARGUMENT(float, MaxRefreshRate)
         SLATE_ARGUMENT(TFunction<FText()>, StatusProvider)
     SLATE_END_ARGS()
 
+    virtual ~SPanoramaPreviewWidget() override
+    {
+        UPanoramaCaptureController::OnPreviewUpdated().Remove(PreviewUpdatedHandle);
+        UPanoramaCaptureController::OnControllersChanged().Remove(ControllersChangedHandle);
+    }
+
     void Construct(const FArguments& InArgs)
     {
-        TextureProvider = InArgs._TextureProvider;
         StatusProvider = InArgs._StatusProvider;
-
-        PreviewBrush = MakeShared<FSlateDynamicImageBrush>(FName(), FVector2D(512.f, 256.f));
+        MinRefreshInterval = 1.0 / FMath::Clamp(InArgs._MaxRefreshRate, 1.f, 120.f);
 
         ChildSlot
         [
-            SNew(SOverlay)
-            + SOverlay::Slot()
+            SNew(SBorder)
+            .BorderBackgroundColor(FLinearColor::Black)
             [
-                SNew(SBorder)
-                .BorderBackgroundColor(FLinearColor::Black)
+                SNew(SVerticalBox)
+                + SVerticalBox::Slot()
+                .AutoHeight()
                 [
-                    SNew(SBox)
-                    .WidthOverride(512.f)
-                    .HeightOverride(256.f)
-                    [
-                        SAssignNew(ImageWidget, SImage)
-                        .Image(PreviewBrush.Get())
-                    ]
+                    SAssignNew(GridPanel, SUniformGridPanel)
+                    .SlotPadding(FMargin(2.f))
+                ]
+                + SVerticalBox::Slot()
+                .AutoHeight()
+                .Padding(FMargin(8.f))
+                [
+                    SAssignNew(StatusText, STextBlock)
+                    .Text(StatusProvider ? StatusProvider() : FText::GetEmpty())
+                    .ColorAndOpacity(FLinearColor::White)
+                    .ShadowColorAndOpacity(FLinearColor::Black)
+                    .ShadowOffset(FVector2D(1.f, 1.f))
                 ]
-            ]
-            + SOverlay::Slot()
-            .HAlign(HAlign_Left)
-            .VAlign(VAlign_Bottom)
-            .Padding(FMargin(8.f))
-            [
-                SAssignNew(StatusText, STextBlock)
-                .Text(StatusProvider ? StatusProvider() : FText::GetEmpty())
-                .ColorAndOpacity(FLinearColor::White)
-                .ShadowColorAndOpacity(FLinearColor::Black)
-                .ShadowOffset(FVector2D(1.f, 1.f))
             ]
         ];
 
-        RegisterActiveTimer(0.0f, FWidgetActiveTimerDelegate::CreateSP(this, &SPanoramaPreviewWidget::HandleActiveTimer));
+        RebuildTiles();
+
+        PreviewUpdatedHandle = UPanoramaCaptureController::OnPreviewUpdated().AddSP(this, &SPanoramaPreviewWidget::HandlePreviewUpdated);
+        ControllersChangedHandle = UPanoramaCaptureController::OnControllersChanged().AddSP(this, &SPanoramaPreviewWidget::HandleControllersChanged);
     }
 
 private:
-    EActiveTimerReturnType HandleActiveTimer(double InCurrentTime, float InDeltaTime)
+    struct FPreviewTile
     {
-        UpdateTexture();
-        UpdateStatus();
-        return EActiveTimerReturnType::Continue;
+        TWeakObjectPtr<UPanoramaCaptureController> Controller;
+        TSharedPtr<FSlateDynamicImageBrush> Brush;
+        TSharedPtr<STextBlock> Label;
+    };
+
+    void HandlePreviewUpdated(UPanoramaCaptureController* Controller)
+    {
+        DirtyControllers.Add(Controller);
+        ScheduleRefresh();
+    }
+
+    void HandleControllersChanged()
+    {
+        bRebuildPending = true;
+        ScheduleRefresh();
     }
 
-    void UpdateTexture()
+    /** Coalesces preview events into at most one refresh per MinRefreshInterval; nothing runs while no controller publishes. */
+    void ScheduleRefresh()
     {
-        if (!TextureProvider)
+        if (bRefreshScheduled)
         {
             return;
         }
 
-        if (UTexture2D* Texture = TextureProvider())
+        bRefreshScheduled = true;
+        const double Elapsed = FPlatformTime::Seconds() - LastRefreshSeconds;
+        const float Delay = static_cast<float>(FMath::Max(0.0, MinRefreshInterval - Elapsed));
+        RegisterActiveTimer(Delay, FWidgetActiveTimerDelegate::CreateSP(this, &SPanoramaPreviewWidget::HandleRefreshTimer));
+    }
+
+    EActiveTimerReturnType HandleRefreshTimer(double InCurrentTime, float InDeltaTime)
+    {
+        bRefreshScheduled = false;
+        LastRefreshSeconds = FPlatformTime::Seconds();
+
+        if (bRebuildPending)
         {
-            if (PreviewBrush->GetResourceObject() != Texture)
+            bRebuildPending = false;
+            RebuildTiles();
+        }
+        else
+        {
+            for (FPreviewTile& Tile : Tiles)
             {
-                PreviewBrush->SetResourceObject(Texture);
-                PreviewBrush->ImageSize = FVector2D(Texture->GetSizeX(), Texture->GetSizeY());
+                if (DirtyControllers.Contains(Tile.Controller))
+                {
+                    UpdateTile(Tile);
+                }
             }
+        }
+
+        DirtyControllers.Reset();
+        UpdateStatus();
+        return EActiveTimerReturnType::Stop;
+    }
+
+    void RebuildTiles()
+    {
+        Tiles.Reset();
+        GridPanel->ClearChildren();
 
-            if (ImageWidget.IsValid())
+        for (const TWeakObjectPtr<UPanoramaCaptureController>& Controller : UPanoramaCaptureController::GetActiveControllers())
+        {
+            if (Controller.IsValid())
             {
-                ImageWidget->SetImage(PreviewBrush.Get());
+                FPreviewTile& Tile = Tiles.AddDefaulted_GetRef();
+                Tile.Controller = Controller;
+                Tile.Brush = MakeShared<FSlateDynamicImageBrush>(FName(), FVector2D(512.f, 256.f));
             }
         }
+
+        if (Tiles.Num() == 0)
+        {
+            GridPanel->AddSlot(0, 0)
+            [
+                SNew(SBox)
+                .WidthOverride(512.f)
+                .HeightOverride(256.f)
+                .HAlign(HAlign_Center)
+                .VAlign(VAlign_Center)
+                [
+                    SNew(STextBlock)
+                    .Text(NSLOCTEXT("PanoramaCaptureEditor", "NoControllers", "No panorama capture controllers"))
+                ]
+            ];
+            return;
+        }
+
+        const int32 Columns = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(Tiles.Num())));
+        const float TileWidth = FMath::Clamp(1024.f / Columns, 256.f, 512.f);
+
+        for (int32 Index = 0; Index < Tiles.Num(); ++Index)
+        {
+            FPreviewTile& Tile = Tiles[Index];
+            GridPanel->AddSlot(Index % Columns, Index / Columns)
+            [
+                SNew(SOverlay)
+                + SOverlay::Slot()
+                [
+                    SNew(SBox)
+                    .WidthOverride(TileWidth)
+                    .HeightOverride(TileWidth * 0.5f)
+                    [
+                        SNew(SImage)
+                        .Image(Tile.Brush.Get())
+                    ]
+                ]
+                + SOverlay::Slot()
+                .HAlign(HAlign_Left)
+                .VAlign(VAlign_Top)
+                .Padding(FMargin(4.f))
+                [
+                    SAssignNew(Tile.Label, STextBlock)
+                    .ColorAndOpacity(FLinearColor::White)
+                    .ShadowColorAndOpacity(FLinearColor::Black)
+                    .ShadowOffset(FVector2D(1.f, 1.f))
+                ]
+            ];
+            UpdateTile(Tile);
+        }
+    }
+
+    void UpdateTile(FPreviewTile& Tile)
+    {
+        UPanoramaCaptureController* Controller = Tile.Controller.Get();
+        if (!Controller)
+        {
+            return;
+        }
+
+        // Preview textures are persistent, so the brush only needs rebinding when the controller swaps targets.
+        if (UTexture* Texture = Controller->GetPreviewTexture())
+        {
+            if (Tile.Brush->GetResourceObject() != Texture)
+            {
+                Tile.Brush->SetResourceObject(Texture);
+                Tile.Brush->ImageSize = FVector2D(Texture->GetSurfaceWidth(), Texture->GetSurfaceHeight());
+            }
+        }
+
+        if (Tile.Label.IsValid())
+        {
+            const AActor* Owner = Controller->GetOwner();
+            const FString OwnerName = Owner ? Owner->GetActorNameOrLabel() : Controller->GetName();
+            FString Status = Controller->GetCurrentStatus().ToString();
+            Status.ReplaceInline(TEXT("|"), TEXT(" | "));
+            Tile.Label->SetText(FText::FromString(FString::Printf(TEXT("%s  %s"), *OwnerName, *Status)));
+        }
     }
 
     void UpdateStatus()
@@ -114,11 +243,17 @@ private:
     }
 
 private:
-    TFunction<UTexture2D*()> TextureProvider;
     TFunction<FText()> StatusProvider;
-    TSharedPtr<FSlateDynamicImageBrush> PreviewBrush;
-    TSharedPtr<SImage> ImageWidget;
+    TSharedPtr<SUniformGridPanel> GridPanel;
     TSharedPtr<STextBlock> StatusText;
+    TArray<FPreviewTile> Tiles;
+    TSet<TWeakObjectPtr<UPanoramaCaptureController>> DirtyControllers;
+    FDelegateHandle PreviewUpdatedHandle;
+    FDelegateHandle ControllersChangedHandle;
+    double MinRefreshInterval = 1.0 / 15.0;
+    double LastRefreshSeconds = 0.0;
+    bool bRefreshScheduled = false;
+    bool bRebuildPending = false;
 };
 
 class FPanoramaCaptureEditorCommands : public TCommands<FPanoramaCaptureEditorCommands>
@@ -578,9 +713,11 @@ void FPanoramaCaptureEditorModule::HandleTogglePreviewWindow()
         .SupportsMinimize(true)
         .SizingRule(ESizingRule::Autosized);
 
+    const UPanoramaCaptureSettings* Settings = GetDefault<UPanoramaCaptureSettings>();
+
     Window->SetContent(
         SAssignNew(PreviewWidget, SPanoramaPreviewWidget)
-        .TextureProvider([this]() { return ResolvePreviewTexture(); })
+        .MaxRefreshRate(Settings ? Settings->EditorPreviewMaxRefreshRate : 15.f)
         .StatusProvider([this]() { return BuildPreviewStatusText(); })
     );
 
@@ -598,24 +735,6 @@ bool FPanoramaCaptureEditorModule::IsPreviewWindowOpen() const
     return PreviewWindow.IsValid();
 }
 
-UTexture2D* FPanoramaCaptureEditorModule::ResolvePreviewTexture() const
-{
-    UTexture2D* Result = nullptr;
-    ForEachController([&Result](UPanoramaCaptureController* Controller)
-    {
-        if (Result || !Controller)
-        {
-            return;
-        }
-
-        if (UTexture2D* Preview = Controller->GetPreviewTexture())
-        {
-            Result = Preview;
-        }
-    });
-    return Result;
-}
-
 FText FPanoramaCaptureEditorModule::BuildPreviewStatusText() const
 {
     return BuildStatusText();
@@ -636,19 +755,13 @@ void FPanoramaCaptureEditorModule::ApplySettingsToControllers()
 
 void FPanoramaCaptureEditorModule::ForEachController(TFunctionRef<void(UPanoramaCaptureController*)> InFunc)
 {
-    for (TObjectIterator<UPanoramaCaptureController> It; It; ++It)
+    // Copy the registry first: start/stop callbacks may register or unregister controllers.
+    const TArray<TWeakObjectPtr<UPanoramaCaptureController>> Controllers = UPanoramaCaptureController::GetActiveControllers();
+    for (const TWeakObjectPtr<UPanoramaCaptureController>& WeakController : Controllers)
     {
-        if (It->IsTemplate())
+        if (UPanoramaCaptureController* Controller = WeakController.Get())
         {
-            continue;
-        }
-
-        if (UPanoramaCaptureController* Controller = *It)
-        {
-            if (Controller->GetWorld() && !Controller->GetWorld()->IsPreviewWorld())
-            {
-                InFunc(Controller);
-            }
+            InFunc(Controller);
         }
     }
 }
@@ -673,6 +786,8 @@ FText FPanoramaCaptureEditorModule::BuildStatusText() const
     int32 BufferedFrames = 0;
     int32 DroppedFrames = 0;
     int32 BlockedFrames = 0;
+    int32 ElidedFrames = 0;
+    float MinResolutionScale = 1.f;
 
     ForEachController([&](UPanoramaCaptureController* Controller)
     {
@@ -690,6 +805,8 @@ FText FPanoramaCaptureEditorModule::BuildStatusText() const
         BufferedFrames += Controller->GetBufferedFrameCount();
         DroppedFrames += Controller->GetDroppedFrameCount();
         BlockedFrames += Controller->GetBlockedFrameCount();
+        ElidedFrames += Controller->GetElidedFrameCount();
+        MinResolutionScale = FMath::Min(MinResolutionScale, Controller->GetResolutionScale());
     });
 
     FString Label;
@@ -707,6 +824,14 @@ FText FPanoramaCaptureEditorModule::BuildStatusText() const
     {
         Label += FString::Printf(TEXT(" | Blocked:%d"), BlockedFrames);
     }
+    if (ElidedFrames > 0)
+    {
+        Label += FString::Printf(TEXT(" | Elided:%d"), ElidedFrames);
+    }
+    if (MinResolutionScale < 1.f)
+    {
+        Label += FString::Printf(TEXT(" | Res:%d%%"), FMath::RoundToInt(MinResolutionScale * 100.f));
+    }
 
     if (const UPanoramaCaptureSettings* Settings = GetDefault<UPanoramaCaptureSettings>())
     {
@@ -0,0 +1,188 @@
+#include "PanoramaRestitchCommandlet.h"
+
+#include "CubemapEquirectCPU.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "ImageCore.h"
+#include "ImageUtils.h"
+#include "Misc/Paths.h"
+#include "PanoramaOutputLayout.h"
+#include "PanoramaProjectionLUT.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogPanoramaRestitch, Log, All);
+
+namespace
+{
+    const TCHAR* FaceExtensions[] = { TEXT("exr"), TEXT("png"), TEXT("tga"), TEXT("bmp") };
+
+    bool LoadFace(const FString& Directory, const TCHAR* EyePrefix, int32 Slice, int32 BorderTexels, FImage& OutImage, FCubemapFaceImage& OutFace)
+    {
+        for (const TCHAR* Extension : FaceExtensions)
+        {
+            const FString FacePath = FPaths::Combine(Directory, FString::Printf(TEXT("%s_%d.%s"), EyePrefix, Slice, Extension));
+            if (!IFileManager::Get().FileExists(*FacePath))
+            {
+                continue;
+            }
+
+            if (!FImageUtils::LoadImage(*FacePath, OutImage))
+            {
+                UE_LOG(LogPanoramaRestitch, Error, TEXT("Failed to decode %s"), *FacePath);
+                return false;
+            }
+
+            // Face dumps hold the values the capture wrote into the render target; read them back unmodified, as the GPU pass does.
+            OutImage.GammaSpace = EGammaSpace::Linear;
+            OutImage.ChangeFormat(ERawImageFormat::RGBA32F, EGammaSpace::Linear);
+
+            const TArrayView64<FLinearColor> Pixels = OutImage.AsRGBA32F();
+            OutFace.Size = FIntPoint(OutImage.SizeX, OutImage.SizeY);
+            OutFace.Pixels = TArrayView<const FLinearColor>(Pixels.GetData(), static_cast<int32>(Pixels.Num()));
+            OutFace.BorderTexels = FMath::Clamp(BorderTexels, 0, (FMath::Min(OutImage.SizeX, OutImage.SizeY) - 1) / 2);
+            return true;
+        }
+
+        UE_LOG(LogPanoramaRestitch, Error, TEXT("Missing face %s_%d in %s"), EyePrefix, Slice, *Directory);
+        return false;
+    }
+}
+
+UPanoramaRestitchCommandlet::UPanoramaRestitchCommandlet()
+{
+    IsClient = false;
+    IsEditor = false;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+int32 UPanoramaRestitchCommandlet::Main(const FString& Params)
+{
+    FString InputDirectory;
+    FString OutputFile;
+    if (!FParse::Value(*Params, TEXT("Input="), InputDirectory) || !FParse::Value(*Params, TEXT("Output="), OutputFile))
+    {
+        UE_LOG(LogPanoramaRestitch, Error, TEXT("Usage: -run=PanoramaRestitch -Input=<Dir> -Output=<File> [-Width= -Height= -Stereo=OverUnder|SideBySide -Projection=EAC|Domemaster -FOV=180 -Layout=VR180|UpperHemisphere|LowerHemisphere -FaceBorder=1 -Linear -LUT -Reference -Verify]"));
+        return 1;
+    }
+
+    FCubemapEquirectCPUParams ConvertParams;
+    FParse::Value(*Params, TEXT("Width="), ConvertParams.OutputResolution.X);
+    FParse::Value(*Params, TEXT("Height="), ConvertParams.OutputResolution.Y);
+    ConvertParams.bLinearGamma = FParse::Param(*Params, TEXT("Linear"));
+
+    FString StereoMode;
+    if (FParse::Value(*Params, TEXT("Stereo="), StereoMode))
+    {
+        ConvertParams.bStereo = true;
+        ConvertParams.bStereoOverUnder = !StereoMode.Equals(TEXT("SideBySide"), ESearchCase::IgnoreCase);
+    }
+
+    FString Projection;
+    if (FParse::Value(*Params, TEXT("Projection="), Projection))
+    {
+        if (Projection.Equals(TEXT("EAC"), ESearchCase::IgnoreCase))
+        {
+            ConvertParams.Projection = EPanoramaProjection::EquiAngularCubemap;
+        }
+        else if (Projection.Equals(TEXT("Domemaster"), ESearchCase::IgnoreCase))
+        {
+            ConvertParams.Projection = EPanoramaProjection::Domemaster;
+        }
+    }
+    FParse::Value(*Params, TEXT("FOV="), ConvertParams.FieldOfView);
+    ConvertParams.FieldOfView = FMath::Clamp(ConvertParams.FieldOfView, 180.f, 220.f);
+
+    EEquiLayout Layout = EEquiLayout::Full360;
+    FString LayoutName;
+    if (FParse::Value(*Params, TEXT("Layout="), LayoutName))
+    {
+        const int64 LayoutValue = StaticEnum<EEquiLayout>()->GetValueByNameString(LayoutName);
+        if (LayoutValue != INDEX_NONE)
+        {
+            Layout = static_cast<EEquiLayout>(LayoutValue);
+        }
+    }
+
+    if (ConvertParams.Projection == EPanoramaProjection::Equirectangular)
+    {
+        ConvertParams.LatitudeRange = FPanoramaOutputLayout::GetLatitudeRange(Layout);
+        ConvertParams.LongitudeRange = FPanoramaOutputLayout::GetLongitudeRange(Layout);
+    }
+    else if (ConvertParams.Projection == EPanoramaProjection::Domemaster)
+    {
+        ConvertParams.bFisheyeForward = Layout == EEquiLayout::VR180;
+        Layout = ConvertParams.bFisheyeForward ? EEquiLayout::VR180 : EEquiLayout::Full360;
+    }
+    else
+    {
+        Layout = EEquiLayout::Full360;
+    }
+
+    // Dumps of the rig's face targets carry its gutter; faces from elsewhere usually have none.
+    int32 FaceBorder = PanoramaProjection::FaceBorderTexels;
+    FParse::Value(*Params, TEXT("FaceBorder="), FaceBorder);
+
+    const int32 EyeCount = ConvertParams.bStereo ? 2 : 1;
+    TArray<FImage> FaceImages;
+    FaceImages.SetNum(EyeCount * PanoramaProjection::FacesPerEye);
+
+    for (int32 Slice = 0; Slice < PanoramaProjection::FacesPerEye; ++Slice)
+    {
+        if (!LoadFace(InputDirectory, TEXT("Left"), Slice, FaceBorder, FaceImages[Slice], ConvertParams.FacesLeft[Slice]))
+        {
+            return 1;
+        }
+
+        if (ConvertParams.bStereo && !LoadFace(InputDirectory, TEXT("Right"), Slice, FaceBorder, FaceImages[PanoramaProjection::FacesPerEye + Slice], ConvertParams.FacesRight[Slice]))
+        {
+            return 1;
+        }
+    }
+
+    TSharedPtr<const FPanoramaProjectionLUT, ESPMode::ThreadSafe> ProjectionLUT;
+    if (FParse::Param(*Params, TEXT("LUT")))
+    {
+        FPanoramaProjectionLUTKey Key;
+        Key.Resolution = ConvertParams.OutputResolution;
+        Key.Projection = ConvertParams.Projection;
+        Key.Layout = Layout;
+        Key.FieldOfView = ConvertParams.Projection == EPanoramaProjection::Domemaster ? ConvertParams.FieldOfView : 0.f;
+        Key.StereoMode = !ConvertParams.bStereo ? EPanoramaStereoMode::Mono : (ConvertParams.bStereoOverUnder ? EPanoramaStereoMode::StereoOverUnder : EPanoramaStereoMode::StereoSideBySide);
+        ProjectionLUT = FPanoramaProjectionLUTCache::Get().FindOrBuild(Key, true);
+        ConvertParams.ProjectionLUT = ProjectionLUT.Get();
+    }
+
+    const bool bReference = FParse::Param(*Params, TEXT("Reference"));
+    TArray<FLinearColor> Pixels;
+
+    const double ConvertStart = FPlatformTime::Seconds();
+    const bool bConverted = bReference ? FCubemapEquirectCPU::ConvertReference(ConvertParams, Pixels) : FCubemapEquirectCPU::Convert(ConvertParams, Pixels);
+    const double ConvertSeconds = FPlatformTime::Seconds() - ConvertStart;
+
+    if (!bConverted)
+    {
+        UE_LOG(LogPanoramaRestitch, Error, TEXT("Conversion failed; check the face sizes and output resolution."));
+        return 1;
+    }
+
+    UE_LOG(LogPanoramaRestitch, Display, TEXT("Converted %dx%d (%s) in %.1f ms"), ConvertParams.OutputResolution.X, ConvertParams.OutputResolution.Y, bReference ? TEXT("reference") : TEXT("vectorized"), ConvertSeconds * 1000.0);
+
+    if (FParse::Param(*Params, TEXT("Verify")) && !bReference)
+    {
+        TArray<FLinearColor> ReferencePixels;
+        FCubemapEquirectCPU::ConvertReference(ConvertParams, ReferencePixels);
+        UE_LOG(LogPanoramaRestitch, Display, TEXT("Max channel error against reference: %f"), FCubemapEquirectCPU::ComputeMaxError(Pixels, ReferencePixels));
+    }
+
+    FImage OutputImage(ConvertParams.OutputResolution.X, ConvertParams.OutputResolution.Y, ERawImageFormat::RGBA32F, EGammaSpace::Linear);
+    FMemory::Memcpy(OutputImage.RawData.GetData(), Pixels.GetData(), Pixels.Num() * sizeof(FLinearColor));
+
+    if (!FImageUtils::SaveImageByExtension(*OutputFile, OutputImage))
+    {
+        UE_LOG(LogPanoramaRestitch, Error, TEXT("Failed to write %s"), *OutputFile);
+        return 1;
+    }
+
+    UE_LOG(LogPanoramaRestitch, Display, TEXT("Wrote %s"), *OutputFile);
+    return 0;
+}
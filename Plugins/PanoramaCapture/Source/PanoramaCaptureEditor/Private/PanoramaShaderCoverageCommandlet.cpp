@@ -0,0 +1,155 @@
+#include "PanoramaShaderCoverageCommandlet.h"
+
+#include "CubemapEquirectPass.h"
+#include "DataDrivenShaderPlatformInfo.h"
+#include "GlobalShader.h"
+#include "Interfaces/ITargetPlatform.h"
+#include "Interfaces/ITargetPlatformManagerModule.h"
+#include "Misc/OutputDevice.h"
+#include "RHIShaderFormatDefinitions.inl"
+#include "ShaderCompiler.h"
+
+#include <atomic>
+
+DEFINE_LOG_CATEGORY_STATIC(LogPanoramaShaderCoverage, Log, All);
+
+namespace
+{
+    const TCHAR* DefaultShaderFormats = TEXT("SF_VULKAN_SM5+SF_VULKAN_SM6");
+
+    /** Counts shader compiler errors logged while attached, including those from worker threads. */
+    class FShaderCompileErrorCounter : public FOutputDevice
+    {
+    public:
+        FShaderCompileErrorCounter()
+        {
+            GLog->AddOutputDevice(this);
+        }
+
+        virtual ~FShaderCompileErrorCounter() override
+        {
+            GLog->RemoveOutputDevice(this);
+        }
+
+        virtual void Serialize(const TCHAR* Message, ELogVerbosity::Type Verbosity, const FName& Category) override
+        {
+            if (Verbosity <= ELogVerbosity::Error && Category == ShaderCompilersCategory)
+            {
+                ++ErrorCount;
+            }
+        }
+
+        virtual bool CanBeUsedOnAnyThread() const override
+        {
+            return true;
+        }
+
+        int32 GetErrorCount() const
+        {
+            return ErrorCount.load();
+        }
+
+    private:
+        const FName ShaderCompilersCategory = TEXT("LogShaderCompilers");
+        std::atomic<int32> ErrorCount{ 0 };
+    };
+
+    /** The first target platform able to compile ShaderFormat, so the check does not depend on what the project targets. */
+    const ITargetPlatform* FindTargetPlatformForFormat(ITargetPlatformManagerModule& TargetPlatformManager, FName ShaderFormat)
+    {
+        for (const ITargetPlatform* TargetPlatform : TargetPlatformManager.GetTargetPlatforms())
+        {
+            TArray<FName> PossibleFormats;
+            TargetPlatform->GetAllPossibleShaderFormats(PossibleFormats);
+            if (PossibleFormats.Contains(ShaderFormat))
+            {
+                return TargetPlatform;
+            }
+        }
+        return nullptr;
+    }
+}
+
+UPanoramaShaderCoverageCommandlet::UPanoramaShaderCoverageCommandlet()
+{
+    IsClient = false;
+    IsEditor = true;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+int32 UPanoramaShaderCoverageCommandlet::Main(const FString& Params)
+{
+    if (!GShaderCompilingManager)
+    {
+        UE_LOG(LogPanoramaShaderCoverage, Error, TEXT("The shader compiling manager is not available."));
+        return 1;
+    }
+
+    FString FormatList = DefaultShaderFormats;
+    FParse::Value(*Params, TEXT("Platforms="), FormatList, false);
+
+    TArray<FString> FormatNames;
+    FormatList.ParseIntoArray(FormatNames, TEXT("+"));
+    if (FormatNames.Num() == 0)
+    {
+        UE_LOG(LogPanoramaShaderCoverage, Error, TEXT("Usage: -run=PanoramaShaderCoverage [-Platforms=SF_VULKAN_SM5+SF_VULKAN_SM6]"));
+        return 1;
+    }
+
+    ITargetPlatformManagerModule& TargetPlatformManager = GetTargetPlatformManagerRef();
+
+    // Finish whatever started compiling at startup, so its errors are not counted against the first platform.
+    GShaderCompilingManager->FinishAllCompilation();
+
+    int32 FailedPlatforms = 0;
+    for (const FString& FormatName : FormatNames)
+    {
+        const FName ShaderFormat(*FormatName.TrimStartAndEnd());
+        const EShaderPlatform ShaderPlatform = ShaderFormatToLegacyShaderPlatform(ShaderFormat);
+        if (ShaderPlatform == SP_NumPlatforms || !FDataDrivenShaderPlatformInfo::IsValid(ShaderPlatform))
+        {
+            UE_LOG(LogPanoramaShaderCoverage, Error, TEXT("%s is not a known shader format."), *ShaderFormat.ToString());
+            ++FailedPlatforms;
+            continue;
+        }
+
+        const ITargetPlatform* TargetPlatform = FindTargetPlatformForFormat(TargetPlatformManager, ShaderFormat);
+        if (!TargetPlatform || !TargetPlatformManager.FindShaderFormat(ShaderFormat))
+        {
+            UE_LOG(LogPanoramaShaderCoverage, Error, TEXT("No target platform or shader format module can compile %s in this editor."), *ShaderFormat.ToString());
+            ++FailedPlatforms;
+            continue;
+        }
+
+        // Compiles, or fetches from the DDC, the global shader map for the platform itself rather than the running RHI's,
+        // so this needs no GPU and runs under -nullrhi.
+        int32 CompileErrors = 0;
+        {
+            FShaderCompileErrorCounter ErrorCounter;
+            CompileGlobalShaderMap(ShaderPlatform, TargetPlatform, false);
+            GShaderCompilingManager->FinishAllCompilation();
+            CompileErrors = ErrorCounter.GetErrorCount();
+        }
+
+        const FString PlatformName = FDataDrivenShaderPlatformInfo::GetName(ShaderPlatform).ToString();
+        if (CompileErrors > 0)
+        {
+            UE_LOG(LogPanoramaShaderCoverage, Error, TEXT("%d shader compile error(s) for %s (%s)."), CompileErrors, *PlatformName, *TargetPlatform->PlatformName());
+            ++FailedPlatforms;
+            continue;
+        }
+
+        const int32 MissingCount = FCubemapEquirectPass::VerifyShaderPermutations(ShaderPlatform);
+        if (MissingCount > 0)
+        {
+            UE_LOG(LogPanoramaShaderCoverage, Error, TEXT("%d equirect shader permutation(s) missing for %s."), MissingCount, *PlatformName);
+            ++FailedPlatforms;
+            continue;
+        }
+
+        UE_LOG(LogPanoramaShaderCoverage, Display, TEXT("Every equirect shader permutation compiled for %s (%s)."), *PlatformName, *TargetPlatform->PlatformName());
+    }
+
+    return FailedPlatforms > 0 ? 1 : 0;
+}
@@ -0,0 +1,223 @@
+#include "PanoramaYUVReferenceCommandlet.h"
+
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "PanoramaYUV.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogPanoramaYUVReference, Log, All);
+
+namespace
+{
+    /** Reads sample Index of a plane as a code in the plane's bit depth. */
+    int32 ReadCode(const TArray<uint8>& Plane, int64 Index, bool bP010)
+    {
+        if (bP010)
+        {
+            uint16 Value = 0;
+            FMemory::Memcpy(&Value, Plane.GetData() + Index * sizeof(uint16), sizeof(Value));
+            return Value >> PanoramaYUV::P010Shift;
+        }
+        return Plane[Index];
+    }
+
+    int32 ComputeMaxCodeError(const TArray<uint8>& Plane, const TArray<uint8>& ReferencePlane, bool bP010)
+    {
+        if (Plane.Num() != ReferencePlane.Num())
+        {
+            return MAX_int32;
+        }
+
+        int32 MaxError = 0;
+        const int64 SampleCount = Plane.Num() / (bP010 ? 2 : 1);
+        for (int64 Index = 0; Index < SampleCount; ++Index)
+        {
+            MaxError = FMath::Max(MaxError, FMath::Abs(ReadCode(Plane, Index, bP010) - ReadCode(ReferencePlane, Index, bP010)));
+        }
+        return MaxError;
+    }
+
+    /** Largest distance of any sample from Expected, in codes. */
+    int32 ComputeMaxDistance(const TArray<uint8>& Plane, int32 Expected, bool bP010)
+    {
+        int32 MaxError = 0;
+        const int64 SampleCount = Plane.Num() / (bP010 ? 2 : 1);
+        for (int64 Index = 0; Index < SampleCount; ++Index)
+        {
+            MaxError = FMath::Max(MaxError, FMath::Abs(ReadCode(Plane, Index, bP010) - Expected));
+        }
+        return MaxError;
+    }
+
+    /** A gradient with noise on top, so every block mixes colours and both the vector lanes and the edges see varied input. */
+    TArray<uint8> MakePayload(const FIntPoint& Size, bool bIs16Bit, int32 Seed)
+    {
+        FRandomStream Random(Seed);
+        const int64 PixelCount = static_cast<int64>(Size.X) * Size.Y;
+        TArray<uint8> Payload;
+        Payload.SetNumUninitialized(PixelCount * 4 * (bIs16Bit ? 2 : 1));
+        for (int64 Pixel = 0; Pixel < PixelCount; ++Pixel)
+        {
+            const float U = static_cast<float>(Pixel % Size.X) / FMath::Max(1, Size.X - 1);
+            const float V = static_cast<float>(Pixel / Size.X) / FMath::Max(1, Size.Y - 1);
+            const float Channels[4] = { U, V, 1.f - 0.5f * (U + V), 1.f };
+            for (int32 Channel = 0; Channel < 4; ++Channel)
+            {
+                const float Value = FMath::Clamp(Channels[Channel] + Random.FRandRange(-0.25f, 0.25f), 0.f, 1.f);
+                if (bIs16Bit)
+                {
+                    const uint16 Sample = static_cast<uint16>(FMath::RoundToInt(Value * 65535.f));
+                    FMemory::Memcpy(Payload.GetData() + (Pixel * 4 + Channel) * sizeof(uint16), &Sample, sizeof(Sample));
+                }
+                else
+                {
+                    Payload[Pixel * 4 + Channel] = static_cast<uint8>(FMath::RoundToInt(Value * 255.f));
+                }
+            }
+        }
+        return Payload;
+    }
+
+    TArray<uint8> MakeUniformPayload(const FIntPoint& Size, bool bIs16Bit, float Value)
+    {
+        const int64 PixelCount = static_cast<int64>(Size.X) * Size.Y;
+        TArray<uint8> Payload;
+        if (bIs16Bit)
+        {
+            const uint16 Sample = static_cast<uint16>(FMath::RoundToInt(Value * 65535.f));
+            Payload.SetNumUninitialized(PixelCount * 4 * sizeof(uint16));
+            for (int64 Index = 0; Index < PixelCount * 4; ++Index)
+            {
+                FMemory::Memcpy(Payload.GetData() + Index * sizeof(uint16), &Sample, sizeof(Sample));
+            }
+        }
+        else
+        {
+            Payload.Init(static_cast<uint8>(FMath::RoundToInt(Value * 255.f)), PixelCount * 4);
+        }
+        return Payload;
+    }
+
+    FString DescribeParams(const FPanoramaYUVConvertCPUParams& Params)
+    {
+        return FString::Printf(TEXT("%dx%d %s%s -> %s %s"), Params.Size.X, Params.Size.Y, Params.bIs16Bit ? TEXT("RGBA16") : TEXT("RGBA8"), Params.bEncodeGamma ? TEXT(" linear") : TEXT(""),
+            Params.bP010 ? TEXT("P010") : TEXT("NV12"), Params.Matrix == EPanoramaYUVMatrix::BT2020 ? TEXT("BT.2020") : TEXT("BT.709"));
+    }
+}
+
+UPanoramaYUVReferenceCommandlet::UPanoramaYUVReferenceCommandlet()
+{
+    IsClient = false;
+    IsEditor = false;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+int32 UPanoramaYUVReferenceCommandlet::Main(const FString& Params)
+{
+    int32 Tolerance = 1;
+    FParse::Value(*Params, TEXT("Tolerance="), Tolerance);
+
+    // Odd sizes exercise the repeated last column and row; widths that are not a multiple of the vector width exercise the tails.
+    TArray<FIntPoint> Sizes = { FIntPoint(1, 1), FIntPoint(3, 5), FIntPoint(17, 9), FIntPoint(64, 32), FIntPoint(1023, 511) };
+    FIntPoint TimedSize = FIntPoint::ZeroValue;
+    if (FParse::Value(*Params, TEXT("Width="), TimedSize.X) && FParse::Value(*Params, TEXT("Height="), TimedSize.Y) && TimedSize.X > 0 && TimedSize.Y > 0)
+    {
+        Sizes.Add(TimedSize);
+    }
+
+    int32 Failures = 0;
+    int32 CaseCount = 0;
+    for (const FIntPoint& Size : Sizes)
+    {
+        for (int32 Variant = 0; Variant < 16; ++Variant)
+        {
+            FPanoramaYUVConvertCPUParams ConvertParams;
+            ConvertParams.Size = Size;
+            ConvertParams.bIs16Bit = (Variant & 1) != 0;
+            ConvertParams.bEncodeGamma = (Variant & 2) != 0;
+            ConvertParams.bP010 = (Variant & 4) != 0;
+            ConvertParams.Matrix = (Variant & 8) != 0 ? EPanoramaYUVMatrix::BT2020 : EPanoramaYUVMatrix::BT709;
+
+            const TArray<uint8> Payload = MakePayload(Size, ConvertParams.bIs16Bit, Size.X * 31 + Size.Y + Variant);
+            ConvertParams.Payload = Payload;
+
+            FPanoramaYUVPlanes Planes;
+            FPanoramaYUVPlanes ReferencePlanes;
+            const double ConvertStart = FPlatformTime::Seconds();
+            const bool bConverted = FPanoramaYUVConvertCPU::Convert(ConvertParams, Planes);
+            const double ConvertSeconds = FPlatformTime::Seconds() - ConvertStart;
+            const double ReferenceStart = FPlatformTime::Seconds();
+            const bool bReferenceConverted = FPanoramaYUVConvertCPU::ConvertReference(ConvertParams, ReferencePlanes);
+            const double ReferenceSeconds = FPlatformTime::Seconds() - ReferenceStart;
+            ++CaseCount;
+
+            if (!bConverted || !bReferenceConverted)
+            {
+                UE_LOG(LogPanoramaYUVReference, Error, TEXT("%s: conversion failed."), *DescribeParams(ConvertParams));
+                ++Failures;
+                continue;
+            }
+
+            const int32 LumaError = ComputeMaxCodeError(Planes.Luma, ReferencePlanes.Luma, ConvertParams.bP010);
+            const int32 ChromaError = ComputeMaxCodeError(Planes.Chroma, ReferencePlanes.Chroma, ConvertParams.bP010);
+            if (LumaError > Tolerance || ChromaError > Tolerance)
+            {
+                UE_LOG(LogPanoramaYUVReference, Error, TEXT("%s: vectorized differs from reference by %d luma and %d chroma codes."), *DescribeParams(ConvertParams), LumaError, ChromaError);
+                ++Failures;
+            }
+
+            if (Size == TimedSize)
+            {
+                UE_LOG(LogPanoramaYUVReference, Display, TEXT("%s: vectorized %.2f ms, reference %.2f ms."), *DescribeParams(ConvertParams), ConvertSeconds * 1000.0, ReferenceSeconds * 1000.0);
+            }
+        }
+    }
+
+    // Anchors both paths to the definitions rather than to each other: black, white and grey have no chroma, and luma lands on
+    // the limited-range end points for black and white.
+    const float Anchors[] = { 0.f, 1.f, 0.5f };
+    for (const float Anchor : Anchors)
+    {
+        for (int32 Variant = 0; Variant < 4; ++Variant)
+        {
+            FPanoramaYUVConvertCPUParams ConvertParams;
+            ConvertParams.Size = FIntPoint(9, 7);
+            ConvertParams.bIs16Bit = (Variant & 1) != 0;
+            ConvertParams.bP010 = (Variant & 2) != 0;
+
+            const TArray<uint8> Payload = MakeUniformPayload(ConvertParams.Size, ConvertParams.bIs16Bit, Anchor);
+            ConvertParams.Payload = Payload;
+
+            // The payload holds the anchor quantized to its depth, which P010's finer codes can tell apart from the anchor itself.
+            const float MaxSample = ConvertParams.bIs16Bit ? 65535.f : 255.f;
+            const float Sample = FMath::RoundToFloat(Anchor * MaxSample) / MaxSample;
+            const float CodeScale = PanoramaYUV::GetCodeScale(ConvertParams.bP010);
+            const int32 ExpectedLuma = FMath::RoundToInt((16.f + 219.f * Sample) * CodeScale);
+            const int32 ExpectedChroma = FMath::RoundToInt(128.f * CodeScale);
+            for (int32 Path = 0; Path < 2; ++Path)
+            {
+                FPanoramaYUVPlanes Planes;
+                const bool bConverted = Path == 0 ? FPanoramaYUVConvertCPU::Convert(ConvertParams, Planes) : FPanoramaYUVConvertCPU::ConvertReference(ConvertParams, Planes);
+                ++CaseCount;
+
+                const int32 LumaError = bConverted ? ComputeMaxDistance(Planes.Luma, ExpectedLuma, ConvertParams.bP010) : MAX_int32;
+                const int32 ChromaError = bConverted ? ComputeMaxDistance(Planes.Chroma, ExpectedChroma, ConvertParams.bP010) : MAX_int32;
+                if (LumaError > Tolerance || ChromaError > Tolerance)
+                {
+                    UE_LOG(LogPanoramaYUVReference, Error, TEXT("%s of %.2f grey: expected luma %d and chroma %d, off by %d and %d codes."), Path == 0 ? TEXT("Vectorized") : TEXT("Reference"),
+                        Anchor, ExpectedLuma, ExpectedChroma, LumaError, ChromaError);
+                    ++Failures;
+                }
+            }
+        }
+    }
+
+    if (Failures > 0)
+    {
+        UE_LOG(LogPanoramaYUVReference, Error, TEXT("%d of %d YUV conversion checks failed."), Failures, CaseCount);
+        return 1;
+    }
+
+    UE_LOG(LogPanoramaYUVReference, Display, TEXT("All %d YUV conversion checks passed within %d code(s)."), CaseCount, Tolerance);
+    return 0;
+}
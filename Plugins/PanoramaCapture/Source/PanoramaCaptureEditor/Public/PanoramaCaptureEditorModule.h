@@ -20,7 +20,6 @@ private:
     void ApplySettingsToControllers();
     void HandleTogglePreviewWindow();
     bool IsPreviewWindowOpen() const;
-    class UTexture2D* ResolvePreviewTexture() const;
     FText BuildPreviewStatusText() const;
     static void ForEachController(TFunctionRef<void(class UPanoramaCaptureController*)> InFunc);
     bool IsAnyControllerCapturing() const;
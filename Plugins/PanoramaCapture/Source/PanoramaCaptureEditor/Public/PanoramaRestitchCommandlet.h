@@ -0,0 +1,23 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "PanoramaRestitchCommandlet.generated.h"
+
+/**
+ * Restitches dumped cube faces into an equirect, EAC 3x2 or domemaster image on the CPU, so conversion works on farm machines started with -nullrhi.
+ *
+ * Usage: -run=PanoramaRestitch -Input=<Dir> -Output=<File> [-Width=3840 -Height=2160 -Stereo=OverUnder|SideBySide -Projection=EAC|Domemaster -FOV=180 -Layout=VR180 -FaceBorder=1 -Linear -LUT -Reference -Verify]
+ * Faces are read from <Dir>/Left_<Slice>.<ext> (and Right_<Slice>.<ext> for stereo), slices 0-5 ordered +X,-X,+Y,-Y,+Z,-Z.
+ * -FaceBorder is the gutter around each dump's 90 degree interior; dumps of the rig's face targets carry one texel.
+ */
+UCLASS()
+class UPanoramaRestitchCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UPanoramaRestitchCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "PanoramaShaderCoverageCommandlet.generated.h"
+
+/**
+ * Compiles the global shader map, which holds every FCubemapToEquirectCS permutation the pass keeps, for each listed shader
+ * format through the target platform's shader compiler (or the DDC), then checks that every permutation the capture can
+ * request is present after the pass remaps the ones it never compiles (FCubemapEquirectPass::VerifyShaderPermutations).
+ * Returns non-zero on any compile error or missing permutation. The running RHI is not involved, so it runs without a GPU.
+ *
+ * Usage: -run=PanoramaShaderCoverage [-Platforms=SF_VULKAN_SM5+SF_VULKAN_SM6] -nullrhi
+ */
+UCLASS()
+class UPanoramaShaderCoverageCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UPanoramaShaderCoverageCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
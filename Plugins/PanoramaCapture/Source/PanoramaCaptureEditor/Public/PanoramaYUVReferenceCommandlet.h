@@ -0,0 +1,24 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "PanoramaYUVReferenceCommandlet.generated.h"
+
+/**
+ * Checks FPanoramaYUVConvertCPU::Convert against the scalar ConvertReference for every payload depth, gamma, NV12/P010 and
+ * matrix combination, on odd and even sizes, and checks both against the limited-range codes of black, white and grey.
+ * Returns non-zero when any sample differs by more than -Tolerance codes (default 1). Needs no RHI.
+ *
+ * Usage: -run=PanoramaYUVReference [-Width=3840 -Height=1920 -Tolerance=1]
+ * -Width and -Height add a payload of that size, whose conversion is also timed.
+ */
+UCLASS()
+class UPanoramaYUVReferenceCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UPanoramaYUVReferenceCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
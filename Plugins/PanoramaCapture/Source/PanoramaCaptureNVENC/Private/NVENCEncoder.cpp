@@ -7,8 +7,11 @@
 #include "HAL/PlatformProcess.h"
 #include "Async/TaskGraphInterfaces.h"
 #include "Misc/Paths.h"
+#include "Misc/ScopeExit.h"
 #include "Misc/ScopeLock.h"
+#include "RHICommandList.h"
 #include "RHIResources.h"
+#include "RenderingThread.h"
 
 #if PLATFORM_WINDOWS && WITH_PANORAMA_NVENC
 #include "Windows/AllowWindowsPlatformTypes.h"
@@ -19,6 +22,7 @@
 #include "D3D11RHI.h"
 #include "D3D12RHIPrivate.h"
 #include "D3D12RHI.h"
+#include "ID3D12DynamicRHI.h"
 #endif
 
 FPanoramaNVENCEncoder::FPanoramaNVENCEncoder()
@@ -28,6 +32,8 @@ FPanoramaNVENCEncoder::FPanoramaNVENCEncoder()
     , DeviceHandle(nullptr)
     , FunctionList(nullptr)
     , NvEncLibraryHandle(nullptr)
+    , PlanarFence(nullptr)
+    , PlanarFenceValue(0)
     , TotalEncodeLatencySeconds(0.0)
 {
 }
@@ -62,11 +68,12 @@ bool FPanoramaNVENCEncoder::Initialize(const FPanoramaVideoEncoderConfig& InConf
     }
 
     bInitialized = true;
-    UE_LOG(LogPanoramaNVENC, Log, TEXT("NVENC initialized: %dx%d @ %d FPS (%s)."),
+    UE_LOG(LogPanoramaNVENC, Log, TEXT("NVENC initialized: %dx%d @ %d FPS (%s, %s)."),
         Config.OutputResolution.X,
         Config.OutputResolution.Y,
         Config.FrameRate,
-        (Config.OutputSettings.NVENC.Codec == ENVENCCodec::HEVC) ? TEXT("HEVC") : TEXT("H.264"));
+        (Config.OutputSettings.NVENC.Codec == ENVENCCodec::HEVC) ? TEXT("HEVC") : TEXT("H.264"),
+        (Config.OutputSettings.Projection == EPanoramaProjection::EquiAngularCubemap) ? TEXT("EAC 3x2") : (Config.OutputSettings.Projection == EPanoramaProjection::Domemaster ? TEXT("domemaster") : TEXT("equirect")));
     return true;
 #else
     UE_LOG(LogPanoramaNVENC, Warning, TEXT("NVENC initialization attempted on unsupported platform."));
@@ -86,6 +93,12 @@ void FPanoramaNVENCEncoder::EncodeFrame(const FPanoramaVideoEncoderFrame& Frame)
 
     FEncodeSubmission Submission;
     Submission.Frame = Frame;
+    if (Frame.LumaTexture)
+    {
+        // The planes are pooled render targets the next frame may overwrite, so they are copied out in this frame's command
+        // stream. A frame with no free surface goes to the task anyway, which counts it as dropped.
+        Submission.PlanarSurface = CopyPlanesToSurface(Frame, Submission.PlanarFenceValue);
+    }
 
     FGraphEventRef PrevTask = LastEncodeTask;
     LastEncodeTask = FFunctionGraphTask::CreateAndDispatchWhenReady([this, Submission]()
@@ -137,6 +150,15 @@ bool FPanoramaNVENCEncoder::FinalizeEncoding(FString& OutElementaryStream)
 #endif
 }
 
+bool FPanoramaNVENCEncoder::SupportsPlanarInput() const
+{
+#if PLATFORM_WINDOWS && WITH_PANORAMA_NVENC
+    return bInitialized && PlanarSurfaces.Num() > 0;
+#else
+    return false;
+#endif
+}
+
 FPanoramaVideoEncoderStats FPanoramaNVENCEncoder::GetStats() const
 {
 #if PLATFORM_WINDOWS && WITH_PANORAMA_NVENC
@@ -167,6 +189,31 @@ namespace
         return Config.bUse10Bit ? NV_ENC_BUFFER_FORMAT_ABGR10 : NV_ENC_BUFFER_FORMAT_ABGR;
     }
 
+    NV_ENC_BUFFER_FORMAT GetPlanarBufferFormat(const FPanoramaVideoEncoderConfig& Config)
+    {
+        return Config.bUse10Bit ? NV_ENC_BUFFER_FORMAT_YUV420_10BIT : NV_ENC_BUFFER_FORMAT_NV12;
+    }
+
+    /** Planes go to D3D12 sessions only, and NV12/P010 textures need even sizes. */
+    bool WantsPlanarInput(const FPanoramaVideoEncoderConfig& Config, bool bUsingD3D12)
+    {
+        return bUsingD3D12 && Config.OutputSettings.NVENC.bPlanarYUVInput && Config.OutputResolution.X % 2 == 0 && Config.OutputResolution.Y % 2 == 0;
+    }
+
+    /** Tags the stream with the planes' matrix and limited range (H.273 codes) so players decode with the same coefficients. */
+    template <typename VUIParametersType>
+    void DescribePlanarColour(VUIParametersType& VUI, EPanoramaYUVMatrix Matrix)
+    {
+        const uint32 ColourCode = Matrix == EPanoramaYUVMatrix::BT2020 ? 9 : 1;
+        VUI.videoSignalTypePresentFlag = 1;
+        VUI.videoFormat = static_cast<decltype(VUI.videoFormat)>(5);
+        VUI.videoFullRangeFlag = 0;
+        VUI.colourDescriptionPresentFlag = 1;
+        VUI.colourPrimaries = static_cast<decltype(VUI.colourPrimaries)>(ColourCode);
+        VUI.transferCharacteristics = static_cast<decltype(VUI.transferCharacteristics)>(Matrix == EPanoramaYUVMatrix::BT2020 ? 14 : 1);
+        VUI.colourMatrix = static_cast<decltype(VUI.colourMatrix)>(ColourCode);
+    }
+
     NV_ENC_PARAMS_RC_MODE GetRateControlMode(const FNVENCRateControl& RateControl)
     {
         switch (RateControl.RateControlMode)
@@ -249,6 +296,18 @@ bool FPanoramaNVENCEncoder::InitializeSession()
     RC.zeroReorderDelay = Config.OutputSettings.NVENC.bZeroLatency ? 1 : 0;
     RC.enableAQ = Config.OutputSettings.NVENC.bZeroLatency ? 0 : 1;
 
+    if (WantsPlanarInput(Config, bUsingD3D12))
+    {
+        if (Config.OutputSettings.NVENC.Codec == ENVENCCodec::HEVC)
+        {
+            DescribePlanarColour(EncodeConfig.encodeCodecConfig.hevcConfig.hevcVUIParameters, Config.OutputSettings.NVENC.YUVMatrix);
+        }
+        else
+        {
+            DescribePlanarColour(EncodeConfig.encodeCodecConfig.h264Config.h264VUIParameters, Config.OutputSettings.NVENC.YUVMatrix);
+        }
+    }
+
     NV_ENC_INITIALIZE_PARAMS InitParams = {};
     InitParams.version = NV_ENC_INITIALIZE_PARAMS_VER;
     InitParams.encodeGUID = GetCodecGuid(Config);
@@ -283,13 +342,198 @@ bool FPanoramaNVENCEncoder::InitializeSession()
         AvailableBitstreams.Add(BitstreamParams.bitstreamBuffer);
     }
 
+    // Frames keep arriving as RGBA when the surfaces cannot be created; the controller asks SupportsPlanarInput per frame.
+    if (WantsPlanarInput(Config, bUsingD3D12) && !CreatePlanarSurfaces())
+    {
+        UE_LOG(LogPanoramaNVENC, Warning, TEXT("NVENC planar surfaces unavailable; encoding RGBA frames instead."));
+        DestroyPlanarSurfaces();
+    }
+
+    return true;
+}
+
+bool FPanoramaNVENCEncoder::CreatePlanarSurfaces()
+{
+    ID3D12Device* Device = static_cast<ID3D12Device*>(DeviceHandle);
+
+    ID3D12Fence* Fence = nullptr;
+    if (FAILED(Device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&Fence))))
+    {
+        UE_LOG(LogPanoramaNVENC, Error, TEXT("Failed to create the NVENC plane copy fence."));
+        return false;
+    }
+    PlanarFence = Fence;
+    PlanarFenceValue = 0;
+
+    D3D12_HEAP_PROPERTIES HeapProperties = {};
+    HeapProperties.Type = D3D12_HEAP_TYPE_DEFAULT;
+
+    D3D12_RESOURCE_DESC SurfaceDesc = {};
+    SurfaceDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+    SurfaceDesc.Width = Config.OutputResolution.X;
+    SurfaceDesc.Height = Config.OutputResolution.Y;
+    SurfaceDesc.DepthOrArraySize = 1;
+    SurfaceDesc.MipLevels = 1;
+    SurfaceDesc.Format = Config.bUse10Bit ? DXGI_FORMAT_P010 : DXGI_FORMAT_NV12;
+    SurfaceDesc.SampleDesc.Count = 1;
+    SurfaceDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+
+    // Encodes run one at a time and each holds a bitstream, so no more surfaces than bitstreams are ever in use.
+    for (int32 Index = 0; Index < AvailableBitstreams.Num(); ++Index)
+    {
+        ID3D12Resource* Resource = nullptr;
+        if (FAILED(Device->CreateCommittedResource(&HeapProperties, D3D12_HEAP_FLAG_NONE, &SurfaceDesc, D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&Resource))))
+        {
+            UE_LOG(LogPanoramaNVENC, Error, TEXT("Failed to create a %dx%d %s surface."), Config.OutputResolution.X, Config.OutputResolution.Y, Config.bUse10Bit ? TEXT("P010") : TEXT("NV12"));
+            return false;
+        }
+
+        FPlanarSurface& Surface = PlanarSurfaces.AddDefaulted_GetRef();
+        Surface.Resource = Resource;
+
+        NV_ENC_REGISTER_RESOURCE RegisterParams = {};
+        RegisterParams.version = NV_ENC_REGISTER_RESOURCE_VER;
+        RegisterParams.resourceType = NV_ENC_INPUT_RESOURCE_TYPE_DIRECTX12;
+        RegisterParams.resourceToRegister = Resource;
+        RegisterParams.width = Config.OutputResolution.X;
+        RegisterParams.height = Config.OutputResolution.Y;
+        RegisterParams.bufferFormat = GetPlanarBufferFormat(Config);
+        RegisterParams.bufferUsage = NV_ENC_INPUT_IMAGE;
+
+        if (NVENCSTATUS Status = FunctionList->nvEncRegisterResource(EncoderInterface, &RegisterParams); Status != NV_ENC_SUCCESS)
+        {
+            UE_LOG(LogPanoramaNVENC, Error, TEXT("nvEncRegisterResource failed for a planar surface (%d)."), static_cast<int32>(Status));
+            return false;
+        }
+        Surface.RegisteredHandle = RegisterParams.registeredResource;
+    }
+
+    FScopeLock Lock(&PlanarSurfaceCriticalSection);
+    for (int32 Index = 0; Index < PlanarSurfaces.Num(); ++Index)
+    {
+        FreePlanarSurfaces.Add(Index);
+    }
     return true;
 }
 
+void FPanoramaNVENCEncoder::DestroyPlanarSurfaces()
+{
+    ID3D12Fence* Fence = static_cast<ID3D12Fence*>(PlanarFence);
+
+    // A copy enqueued for a frame that was then dropped may still be pending on the GPU.
+    if (Fence && Fence->GetCompletedValue() < PlanarFenceValue)
+    {
+        Fence->SetEventOnCompletion(PlanarFenceValue, nullptr);
+    }
+
+    for (FPlanarSurface& Surface : PlanarSurfaces)
+    {
+        if (Surface.RegisteredHandle && FunctionList && EncoderInterface)
+        {
+            FunctionList->nvEncUnregisterResource(EncoderInterface, Surface.RegisteredHandle);
+        }
+        if (Surface.Resource)
+        {
+            static_cast<ID3D12Resource*>(Surface.Resource)->Release();
+        }
+    }
+    PlanarSurfaces.Empty();
+
+    {
+        FScopeLock Lock(&PlanarSurfaceCriticalSection);
+        FreePlanarSurfaces.Empty();
+    }
+
+    if (Fence)
+    {
+        Fence->Release();
+        PlanarFence = nullptr;
+    }
+    PlanarFenceValue = 0;
+}
+
+int32 FPanoramaNVENCEncoder::CopyPlanesToSurface(const FPanoramaVideoEncoderFrame& Frame, uint64& OutFenceValue)
+{
+    check(IsInRenderingThread());
+
+    ID3D12Resource* Luma = static_cast<ID3D12Resource*>(Frame.LumaTexture->GetNativeResource());
+    ID3D12Resource* Chroma = Frame.ChromaTexture ? static_cast<ID3D12Resource*>(Frame.ChromaTexture->GetNativeResource()) : nullptr;
+    if (!Luma || !Chroma || Frame.bIsP010 != Config.bUse10Bit)
+    {
+        return INDEX_NONE;
+    }
+
+    int32 SurfaceIndex = INDEX_NONE;
+    {
+        FScopeLock Lock(&PlanarSurfaceCriticalSection);
+        if (FreePlanarSurfaces.Num() > 0)
+        {
+            SurfaceIndex = FreePlanarSurfaces.Pop(false);
+        }
+    }
+    if (SurfaceIndex == INDEX_NONE)
+    {
+        return INDEX_NONE;
+    }
+
+    // The controller extracts both planes in the copy source state; only the surface needs transitions.
+    ID3D12Resource* Surface = static_cast<ID3D12Resource*>(PlanarSurfaces[SurfaceIndex].Resource);
+    const FIntPoint LumaSize = Config.OutputResolution;
+    FRHICommandListImmediate& RHICmdList = FRHICommandListExecutor::GetImmediateCommandList();
+    RHICmdList.EnqueueLambda(TEXT("PanoramaNVENCCopyPlanes"), [Surface, Luma, Chroma, LumaSize](FRHICommandListBase& ExecutingCmdList)
+    {
+        ID3D12GraphicsCommandList* CommandList = GetID3D12DynamicRHI()->RHIGetGraphicsCommandList(ExecutingCmdList, 0);
+
+        D3D12_RESOURCE_BARRIER Barrier = {};
+        Barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        Barrier.Transition.pResource = Surface;
+        Barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+        Barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COMMON;
+        Barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_DEST;
+        CommandList->ResourceBarrier(1, &Barrier);
+
+        // Subresource 0 of an NV12/P010 texture is its luma plane and subresource 1 its interleaved chroma plane.
+        for (uint32 Plane = 0; Plane < 2; ++Plane)
+        {
+            D3D12_TEXTURE_COPY_LOCATION Destination = {};
+            Destination.pResource = Surface;
+            Destination.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+            Destination.SubresourceIndex = Plane;
+
+            D3D12_TEXTURE_COPY_LOCATION Source = {};
+            Source.pResource = Plane == 0 ? Luma : Chroma;
+            Source.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+            Source.SubresourceIndex = 0;
+
+            const FIntPoint PlaneSize = Plane == 0 ? LumaSize : LumaSize / 2;
+            const D3D12_BOX SourceBox = { 0, 0, 0, static_cast<UINT>(PlaneSize.X), static_cast<UINT>(PlaneSize.Y), 1 };
+            CommandList->CopyTextureRegion(&Destination, 0, 0, 0, &Source, &SourceBox);
+        }
+
+        Swap(Barrier.Transition.StateBefore, Barrier.Transition.StateAfter);
+        CommandList->ResourceBarrier(1, &Barrier);
+    });
+
+    OutFenceValue = ++PlanarFenceValue;
+    GetID3D12DynamicRHI()->RHISignalManualFence(RHICmdList, static_cast<ID3D12Fence*>(PlanarFence), OutFenceValue);
+    return SurfaceIndex;
+}
+
+void FPanoramaNVENCEncoder::ReleasePlanarSurface(int32 SurfaceIndex)
+{
+    if (SurfaceIndex != INDEX_NONE)
+    {
+        FScopeLock Lock(&PlanarSurfaceCriticalSection);
+        FreePlanarSurfaces.Add(SurfaceIndex);
+    }
+}
+
 void FPanoramaNVENCEncoder::ShutdownSession()
 {
     FlushPendingTasks();
 
+    DestroyPlanarSurfaces();
+
     if (FunctionList && EncoderInterface)
     {
         for (TPair<FRHITexture*, FRegisteredResource>& Pair : RegisteredResources)
@@ -370,23 +614,46 @@ void FPanoramaNVENCEncoder::EncodeSubmission(const FEncodeSubmission& Submission
 {
     FScopeLock Lock(&EncodeCriticalSection);
 
+    // Returned on every path; the encode below has finished reading the surface once this task ends.
+    ON_SCOPE_EXIT
+    {
+        ReleasePlanarSurface(Submission.PlanarSurface);
+    };
+
     if (!bInitialized)
     {
         return;
     }
 
-    if (!Submission.Frame.RgbaTexture)
+    const double SubmissionTime = Submission.Frame.TimeSeconds;
+    void* RegisteredHandle = nullptr;
+    NV_ENC_BUFFER_FORMAT BufferFormat = GetBufferFormat(Config);
+
+    if (Submission.Frame.LumaTexture)
+    {
+        if (Submission.PlanarSurface == INDEX_NONE)
+        {
+            UE_LOG(LogPanoramaNVENC, Warning, TEXT("No free NVENC planar surface for the frame's planes. Dropping frame."));
+            ++Stats.DroppedFrames;
+            return;
+        }
+
+        // The copy into the surface was only enqueued on the render thread; wait until the GPU has executed it.
+        ID3D12Fence* Fence = static_cast<ID3D12Fence*>(PlanarFence);
+        if (Fence->GetCompletedValue() < Submission.PlanarFenceValue)
+        {
+            Fence->SetEventOnCompletion(Submission.PlanarFenceValue, nullptr);
+        }
+        RegisteredHandle = PlanarSurfaces[Submission.PlanarSurface].RegisteredHandle;
+        BufferFormat = GetPlanarBufferFormat(Config);
+    }
+    else if (!Submission.Frame.RgbaTexture)
     {
         UE_LOG(LogPanoramaNVENC, Warning, TEXT("NVENC submission missing RGBA texture. Skipping frame."));
         ++Stats.DroppedFrames;
         return;
     }
-
-    const double SubmissionTime = Submission.Frame.TimeSeconds;
-    FRHITexture* Texture = Submission.Frame.RgbaTexture;
-
-    void* RegisteredHandle = nullptr;
-    if (!RegisterIfNeeded(Texture, &RegisteredHandle))
+    else if (!RegisterIfNeeded(Submission.Frame.RgbaTexture, &RegisteredHandle))
     {
         ++Stats.DroppedFrames;
         return;
@@ -416,7 +683,7 @@ void FPanoramaNVENCEncoder::EncodeSubmission(const FEncodeSubmission& Submission
     NV_ENC_PIC_PARAMS PicParams = {};
     PicParams.version = NV_ENC_PIC_PARAMS_VER;
     PicParams.inputBuffer = MapParams.mappedResource;
-    PicParams.bufferFmt = GetBufferFormat(Config);
+    PicParams.bufferFmt = BufferFormat;
     PicParams.inputWidth = Config.OutputResolution.X;
     PicParams.inputHeight = Config.OutputResolution.Y;
     PicParams.inputPitch = 0;
@@ -15,6 +15,12 @@ public:
     virtual bool FinalizeEncoding(FString& OutElementaryStream) override;
     virtual FPanoramaVideoEncoderStats GetStats() const override;
 
+    /**
+     * True on D3D12 once the session owns its native NV12/P010 surfaces. EncodeFrame then copies the frame's planes into a
+     * free surface on the render thread, and the encode task waits for that copy before encoding it.
+     */
+    virtual bool SupportsPlanarInput() const override;
+
 private:
     struct FRegisteredResource
     {
@@ -22,9 +28,20 @@ private:
         void* RegisteredHandle = nullptr;
     };
 
+    /** Native NV12 or P010 texture owned by the session and registered with NVENC once. */
+    struct FPlanarSurface
+    {
+        void* Resource = nullptr;
+        void* RegisteredHandle = nullptr;
+    };
+
     struct FEncodeSubmission
     {
         FPanoramaVideoEncoderFrame Frame;
+        /** PlanarSurfaces index holding the frame's planes, or INDEX_NONE when none was free. */
+        int32 PlanarSurface = INDEX_NONE;
+        /** PlanarFence value signalled once the plane copy has executed. */
+        uint64 PlanarFenceValue = 0;
     };
 
     bool InitializeSession();
@@ -33,6 +50,10 @@ private:
     void EncodeSubmission(const FEncodeSubmission& Submission);
     void DrainBitstream(void* OutputBitstream, double Timestamp);
     void FlushPendingTasks();
+    bool CreatePlanarSurfaces();
+    void DestroyPlanarSurfaces();
+    int32 CopyPlanesToSurface(const FPanoramaVideoEncoderFrame& Frame, uint64& OutFenceValue);
+    void ReleasePlanarSurface(int32 SurfaceIndex);
 
     FPanoramaVideoEncoderConfig Config;
     bool bInitialized;
@@ -41,6 +62,12 @@ private:
     TUniquePtr<class FArchive> ElementaryStreamWriter;
     TMap<FRHITexture*, FRegisteredResource> RegisteredResources;
     TArray<void*> AvailableBitstreams;
+    TArray<FPlanarSurface> PlanarSurfaces;
+    /** Guarded by PlanarSurfaceCriticalSection rather than the encode lock, so the render thread never waits on an encode. */
+    TArray<int32> FreePlanarSurfaces;
+    FCriticalSection PlanarSurfaceCriticalSection;
+    void* PlanarFence;
+    uint64 PlanarFenceValue;
     void* EncoderInterface;
     void* DeviceHandle;
     struct NV_ENCODE_API_FUNCTION_LIST* FunctionList;